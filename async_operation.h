@@ -0,0 +1,142 @@
+#ifndef DIRECTEDGRAPHHANDLER_ASYNC_OPERATION_H
+#define DIRECTEDGRAPHHANDLER_ASYNC_OPERATION_H
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include "util_thread_pool.h"
+#include "directed_graph_exceptions.h"
+
+namespace dgraph {
+
+    //shared by a running operation and the callers waiting for it: the operation reports how much
+    //of its work is done, and the callers may ask it to stop, which it notices at its next check
+    class OperationMonitor {
+      public:
+        OperationMonitor() : cancelled_(false), done_(0), total_(0) {}
+        virtual ~OperationMonitor() {}
+
+        //method that asks the operation to stop; it throws operation_cancelled from its next check
+        void cancel() { cancelled_.store(true); }
+        bool is_cancelled() const { return cancelled_.load(); }
+
+        //units of work done so far, out of total(), which is 0 until the operation starts;
+        //the unit depends on the operation (nodes, rows of a matrix, slices of columns)
+        long long done() const { return done_.load(std::memory_order_relaxed); }
+        long long total() const { return total_.load(std::memory_order_relaxed); }
+
+        //called by the operation once it knows how much work it has
+        void start(long long total) {
+            done_.store(0, std::memory_order_relaxed);
+            total_.store(total, std::memory_order_relaxed);
+        }
+        //called by the operation from its inner loops, possibly from several threads at once;
+        //throws operation_cancelled once cancel was called
+        void advance(long long count = 1) {
+            done_.fetch_add(count, std::memory_order_relaxed);
+            check();
+        }
+        //the same check, without counting any work
+        void check() const {
+            if (cancelled_.load(std::memory_order_relaxed))
+                throw operation_cancelled();
+        }
+      private:
+        OperationMonitor(const OperationMonitor& rhs);
+        OperationMonitor& operator = (const OperationMonitor& rhs);
+
+        std::atomic< bool > cancelled_;
+        std::atomic< long long > done_, total_;
+    };
+
+    namespace detail {
+        //waits for a result of an operation queued on the default pool; a worker of the pool runs
+        //the queued tasks meanwhile, since the operation may be waiting behind it for a free worker
+        template<typename Result>
+        void wait_for_operation(const std::shared_future< Result >& result) {
+            util::ThreadPool& pool = util::default_thread_pool();
+            if (pool.current_thread_index() == pool.thread_count()) {
+                result.wait();
+                return;
+            }
+            while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                if (!pool.run_pending_task())
+                    std::this_thread::yield();
+        }
+
+        //the state of an operation, shared by the copies of its handle; the last copy to go away
+        //cancels the operation and waits for it, so an abandoned operation stops early
+        template<typename Result>
+        struct AsyncState {
+            AsyncState() : monitor(new OperationMonitor()) {}
+            ~AsyncState() {
+                monitor->cancel();
+                if (result.valid())
+                    wait_for_operation(result);
+            }
+
+            std::shared_ptr< OperationMonitor > monitor;
+            std::shared_future< Result > result;
+        };
+    }
+
+    //handle of an operation running on the default thread pool (util::default_thread_pool), so
+    //that many concurrent operations share the threads set by DGRAPH_THREADS instead of starting
+    //one each; copies of the handle share the operation.
+    //the objects the operation reads must stay alive and unchanged until it finishes, and the
+    //default pool may not be replaced while an operation is pending
+    template<typename Result>
+    class AsyncOperation {
+      public:
+        //queues operation(monitor) on the default pool, where monitor is an OperationMonitor&
+        template<typename Operation>
+        explicit AsyncOperation(Operation operation);
+
+        //method that asks the operation to stop; get() then throws operation_cancelled,
+        //unless the operation finished first
+        void cancel() const { state_->monitor->cancel(); }
+        bool is_ready() const { return wait_for(0); }
+        void wait() const { detail::wait_for_operation(state_->result); }
+        //method that waits at most the given number of seconds; returns true if the operation finished
+        bool wait_for(double seconds) const;
+        //method that waits for the result; rethrows the exception that stopped the operation
+        const Result& get() const {
+            wait();
+            return state_->result.get();
+        }
+
+        const OperationMonitor& monitor() const { return *state_->monitor; }
+      private:
+        std::shared_ptr< detail::AsyncState< Result > > state_;
+    };
+
+    //implementation of AsyncOperation's methods
+    template<typename Result>
+    template<typename Operation>
+    AsyncOperation<Result>::AsyncOperation(Operation operation) : state_(new detail::AsyncState< Result >()) {
+        //the task holds the monitor, not the state, so it never waits for itself; the promise is
+        //shared because a pool task must be copyable
+        std::shared_ptr< OperationMonitor > monitor = state_->monitor;
+        std::shared_ptr< std::promise< Result > > promise(new std::promise< Result >());
+        state_->result = promise->get_future().share();
+        util::default_thread_pool().submit([monitor, promise, operation]() {
+            try {
+                //an operation abandoned while it was queued does not start at all
+                monitor->check();
+                promise->set_value(operation(*monitor));
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+    }
+
+    template<typename Result>
+    bool AsyncOperation<Result>::wait_for(double seconds) const {
+        return state_->result.wait_for(std::chrono::duration< double >(seconds)) == std::future_status::ready;
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_ASYNC_OPERATION_H
@@ -0,0 +1,813 @@
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include "directed_graph.h"
+#include "compressed_directed_graph.h"
+#include "versioned_graph.h"
+#include "graph_journal.h"
+#include "external_directed_graph.h"
+#include "sharded_directed_graph.h"
+#include "graph_views.h"
+#include "critical_path.h"
+#include "graph_generators.h"
+#include "util_trace.h"
+#include "util_memory.h"
+#include "util_thread_pool.h"
+
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+//counts the hardware cache misses of the calling thread between start() and stop()
+//when the counter is not available (other platforms, restricted perf_event_paranoid) it reports -1
+class CacheMissCounter {
+  public:
+    CacheMissCounter() : fd_(-1) {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    virtual ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd_ != -1)
+            close(fd_);
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ != -1) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+#ifdef __linux__
+        if (fd_ != -1) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            long long count = 0;
+            if (read(fd_, &count, sizeof(count)) == (ssize_t)sizeof(count))
+                return count;
+        }
+#endif
+        return -1;
+    }
+  private:
+    CacheMissCounter(const CacheMissCounter& rhs);
+    CacheMissCounter& operator = (const CacheMissCounter& rhs);
+
+    int fd_;
+};
+
+//wall-clock time in seconds from a monotonic clock
+double now_seconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//peak resident set size of the process so far, in kilobytes
+long peak_rss_kb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; //reported in bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+struct BenchmarkConfig {
+    BenchmarkConfig() :
+            generators("rmat,erdos_renyi,chain,layered_dag"), operations("all"), format("json"),
+            min_nodes(1000), max_nodes(100000), growth(10.0), average_degree(8), layer_width(64),
+            repetitions(3), path_matrix_limit(250), max_weight(100), threads(0), external_budget_mb(64),
+            shards(4), seed(42), shuffle(false) {}
+
+    std::string generators, operations, format, trace_path;
+    int min_nodes, max_nodes;
+    double growth;
+    int average_degree, layer_width, repetitions, path_matrix_limit, max_weight, threads;
+    int external_budget_mb, shards;
+    unsigned long long seed;
+    bool shuffle;
+};
+
+//one line of output, either as a JSON object or as a CSV row
+struct BenchmarkResult {
+    BenchmarkResult() :
+            node_count(0), edge_count(0), repetitions(0), mean_seconds(0), min_seconds(0),
+            cache_misses(-1), peak_rss_kb(0), graph_bytes(0), peak_temporary_bytes(0),
+            bytes_per_edge(-1) {}
+
+    std::string generator, operation, status;
+    int node_count, edge_count, repetitions;
+    double mean_seconds, min_seconds;
+    long long cache_misses;
+    long peak_rss_kb;
+    unsigned long graph_bytes, peak_temporary_bytes;
+    double bytes_per_edge;
+};
+
+class ResultWriter {
+  public:
+    ResultWriter(std::ostream& out, const std::string& format) : out_(out), csv_(format == "csv") {
+        if (csv_)
+            out_ << "generator,nodes,edges,operation,status,repetitions,mean_seconds,min_seconds,"
+                    "edges_per_second,cache_misses,peak_rss_kb,graph_bytes,peak_temporary_bytes,"
+                    "bytes_per_edge\n";
+    }
+    virtual ~ResultWriter() {}
+
+    void write(const BenchmarkResult& res) {
+        double edges_per_second = (res.mean_seconds > 0 ? res.edge_count / res.mean_seconds : 0);
+        if (csv_) {
+            out_ << res.generator << ',' << res.node_count << ',' << res.edge_count << ','
+                 << res.operation << ',' << res.status << ',' << res.repetitions << ','
+                 << res.mean_seconds << ',' << res.min_seconds << ',' << edges_per_second << ','
+                 << res.cache_misses << ',' << res.peak_rss_kb << ',' << res.graph_bytes << ','
+                 << res.peak_temporary_bytes << ',';
+            if (res.bytes_per_edge >= 0)
+                out_ << res.bytes_per_edge;
+            out_ << '\n';
+        }
+        else {
+            out_ << "{\"generator\":\"" << res.generator << "\",\"nodes\":" << res.node_count
+                 << ",\"edges\":" << res.edge_count << ",\"operation\":\"" << res.operation
+                 << "\",\"status\":\"" << res.status << "\",\"repetitions\":" << res.repetitions
+                 << ",\"mean_seconds\":" << res.mean_seconds << ",\"min_seconds\":" << res.min_seconds
+                 << ",\"edges_per_second\":" << edges_per_second
+                 << ",\"cache_misses\":" << res.cache_misses << ",\"peak_rss_kb\":" << res.peak_rss_kb
+                 << ",\"graph_bytes\":" << res.graph_bytes
+                 << ",\"peak_temporary_bytes\":" << res.peak_temporary_bytes;
+            if (res.bytes_per_edge >= 0)
+                out_ << ",\"bytes_per_edge\":" << res.bytes_per_edge;
+            out_ << "}\n";
+        }
+        out_.flush();
+    }
+  private:
+    ResultWriter(const ResultWriter& rhs);
+    ResultWriter& operator = (const ResultWriter& rhs);
+
+    std::ostream& out_;
+    bool csv_;
+};
+
+enum Operation {
+    LOAD, COPY, BFS, DFS, SCC, TOPOLOGICAL_SORT, PATH_MATRIX, UNION, ADD_NEW_NODE,
+    REORDER_BFS_ORDER, REORDER_RCM, REORDER_DEGREE_SORTED,
+    COMPRESSED_BUILD, COMPRESSED_BFS, COMPRESSED_DFS, COMPRESSED_SCC, COMPRESSED_TOPOLOGICAL_SORT,
+    DIJKSTRA, DAG_SHORTEST_PATHS, REMOVE_EDGES, COMPACT, PUBLISH,
+    PARALLEL_BFS, PARALLEL_SCC, PARALLEL_PATH_MATRIX, PARALLEL_UNION, BINARY_LOAD, JOURNAL_RECOVER,
+    EXTERNAL_BUILD, EXTERNAL_BFS, EXTERNAL_SCC, SHARDED_LOAD, SHARDED_BFS,
+    TRANSITIVE_REDUCTION, EQUALITY, TRANSPOSED_BFS, TRANSPOSED_SCC, DOMINATOR_TREE, DESCENDANT_COUNTS, PAGE_RANK,
+    CRITICAL_PATH,
+    OPERATION_COUNT
+};
+
+const char* operation_names[OPERATION_COUNT] = {
+    "load", "copy", "bfs", "dfs", "scc", "topological_sort", "path_matrix", "union", "add_new_node",
+    "reorder_bfs_order", "reorder_rcm", "reorder_degree_sorted",
+    "compressed_build", "compressed_bfs", "compressed_dfs", "compressed_scc",
+    "compressed_topological_sort",
+    "dijkstra", "dag_shortest_paths", "remove_edges", "compact", "publish",
+    "parallel_bfs", "parallel_scc", "parallel_path_matrix", "parallel_union", "binary_load", "journal_recover",
+    "external_build", "external_bfs", "external_scc", "sharded_load", "sharded_bfs",
+    "transitive_reduction", "equality", "transposed_bfs", "transposed_scc", "dominator_tree",
+    "descendant_counts", "page_rank", "critical_path"
+};
+
+//everything an operation needs, built once per generated graph
+struct BenchmarkInput {
+    std::string text, new_node_text;
+    //the graph in the format of write_binary
+    std::string binary;
+    dgraph::DirectedGraph graph, union_graph;
+    //a separate graph equal to graph, which operator== has to compare completely
+    dgraph::DirectedGraph equal_graph;
+    dgraph::CompressedDirectedGraph compressed;
+    //the same topology with random integer weights, for the shortest path operations
+    dgraph::WeightedDirectedGraph weighted_graph;
+    //every tenth edge, deleted by the remove_edges and compact operations
+    util::Vector< dgraph::Edge > removed_edges;
+    bool acyclic;
+};
+
+void remove_edges(dgraph::DirectedGraph& graph, const util::Vector< dgraph::Edge >& edges) {
+    for (util::Vector< dgraph::Edge >::const_iterator it = edges.begin(); it != edges.end(); ++it)
+        graph.remove_edge(it->from_node_id(), it->to_node_id());
+}
+
+bool contains_item(const std::string& list, const std::string& item) {
+    std::string padded = "," + list + ",";
+    return padded.find("," + item + ",") != std::string::npos;
+}
+
+//runs one repetition of the given operation over the graph
+void run_operation(Operation op, const BenchmarkInput& input) {
+    switch (op) {
+        case LOAD: {
+            std::istringstream in(input.text);
+            dgraph::DirectedGraph graph;
+            in >> graph;
+            break;
+        }
+        case COPY: {
+            dgraph::DirectedGraph copy(input.graph);
+            break;
+        }
+        case BFS:
+            input.graph.breadth_first_search(0);
+            break;
+        case DFS:
+            input.graph.depth_first_search(0);
+            break;
+        case SCC:
+            input.graph.get_strongly_connected_components();
+            break;
+        case TOPOLOGICAL_SORT:
+            input.graph.topological_sort();
+            break;
+        case PATH_MATRIX:
+            input.graph.get_path_matrix();
+            break;
+        case UNION: {
+            dgraph::DirectedGraph reunion = input.graph + input.union_graph;
+            break;
+        }
+        case COMPRESSED_BUILD: {
+            std::istringstream in(input.text);
+            dgraph::CompressedDirectedGraph compressed;
+            in >> compressed;
+            break;
+        }
+        case COMPRESSED_BFS:
+            input.compressed.breadth_first_search(0);
+            break;
+        case COMPRESSED_DFS:
+            input.compressed.depth_first_search(0);
+            break;
+        case COMPRESSED_SCC:
+            input.compressed.get_strongly_connected_components();
+            break;
+        case COMPRESSED_TOPOLOGICAL_SORT:
+            input.compressed.topological_sort();
+            break;
+        case DIJKSTRA:
+            input.weighted_graph.dijkstra(0);
+            break;
+        case DAG_SHORTEST_PATHS:
+            input.weighted_graph.dag_shortest_paths(0);
+            break;
+        case PARALLEL_BFS:
+            input.graph.parallel_breadth_first_search(0);
+            break;
+        case PARALLEL_SCC:
+            input.graph.parallel_strongly_connected_components();
+            break;
+        case PARALLEL_PATH_MATRIX:
+            input.graph.parallel_path_matrix();
+            break;
+        case PARALLEL_UNION: {
+            dgraph::DirectedGraph reunion = input.graph.parallel_union(input.union_graph);
+            break;
+        }
+        case TRANSITIVE_REDUCTION: {
+            dgraph::DirectedGraph reduced = input.graph.transitive_reduction();
+            break;
+        }
+        case TRANSPOSED_BFS:
+            dgraph::breadth_first_search(dgraph::transposed(input.graph), 0);
+            break;
+        case TRANSPOSED_SCC:
+            dgraph::strongly_connected_components(dgraph::transposed(input.graph));
+            break;
+        case DOMINATOR_TREE:
+            input.graph.dominator_tree(0);
+            break;
+        case DESCENDANT_COUNTS:
+            input.graph.approximate_descendant_counts(0.1);
+            break;
+        case PAGE_RANK:
+            input.graph.page_rank();
+            break;
+        case CRITICAL_PATH: {
+            dgraph::CriticalPathEngine<> engine(input.graph);
+            engine.critical_path();
+            break;
+        }
+        case EQUALITY:
+            if (input.graph != input.equal_graph)
+                throw std::logic_error("a graph differs from its copy");
+            break;
+        case BINARY_LOAD: {
+            std::istringstream in(input.binary);
+            dgraph::DirectedGraph graph;
+            graph.read_binary(in);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+class Benchmark {
+  public:
+    Benchmark(const BenchmarkConfig& config, ResultWriter& writer, util::TrackingResource& tracker) :
+            config_(config), writer_(writer), tracker_(tracker) {}
+    virtual ~Benchmark() {}
+
+    void run_generator(const std::string& generator, int node_count) {
+        util::Vector< dgraph::Edge > edges = generate(generator, node_count, config_.seed);
+        util::Vector< dgraph::Edge > union_edges = generate(generator, node_count, config_.seed + 1);
+
+        BenchmarkInput input;
+        input.text = dgraph::generators::to_text(node_count, edges);
+        std::istringstream in(input.text);
+        in >> input.graph;
+        std::ostringstream binary_out;
+        input.graph.write_binary(binary_out);
+        input.binary = binary_out.str();
+        std::istringstream equal_in(input.binary);
+        input.equal_graph.read_binary(equal_in);
+        std::istringstream union_in(dgraph::generators::to_text(node_count, union_edges));
+        union_in >> input.union_graph;
+        input.compressed = dgraph::CompressedDirectedGraph(input.graph);
+        input.acyclic = input.graph.is_acyclic();
+        //to_text sorted and deduplicated the edges, so they can be weighted as they are
+        std::istringstream weighted_in(dgraph::generators::to_text(
+                node_count, dgraph::generators::add_random_weights(edges, config_.max_weight, config_.seed + 2)));
+        weighted_in >> input.weighted_graph;
+        for (util::size_t i = 0; i < edges.size(); i += 10)
+            input.removed_edges.push_back(edges[i]);
+
+        //the new node gets edges to and from evenly spread existing nodes
+        std::ostringstream new_node;
+        int new_edges = std::min(config_.average_degree, node_count);
+        int step = node_count / new_edges;
+        new_node << new_edges;
+        for (int k = 0; k < new_edges; ++k)
+            if (k % 2 == 0)
+                new_node << ' ' << node_count << ' ' << k * step;
+            else
+                new_node << ' ' << k * step << ' ' << node_count;
+        input.new_node_text = new_node.str();
+
+        for (int op = 0; op < OPERATION_COUNT; ++op)
+            if (config_.operations == "all" || contains_item(config_.operations, operation_names[op]))
+                measure(generator, (Operation)op, input);
+    }
+
+  private:
+    Benchmark(const Benchmark& rhs);
+    Benchmark& operator = (const Benchmark& rhs);
+
+    const BenchmarkConfig& config_;
+    ResultWriter& writer_;
+    util::TrackingResource& tracker_;
+
+    util::Vector< dgraph::Edge > generate(const std::string& generator, int node_count,
+                                          unsigned long long seed) const {
+        util::Vector< dgraph::Edge > edges;
+        if (generator == "rmat")
+            edges = dgraph::generators::rmat(node_count, config_.average_degree, seed);
+        else if (generator == "erdos_renyi")
+            edges = dgraph::generators::erdos_renyi(node_count, config_.average_degree, seed);
+        else if (generator == "chain")
+            edges = dgraph::generators::chain(node_count);
+        else if (generator == "layered_dag")
+            edges = dgraph::generators::layered_dag(node_count, config_.average_degree,
+                                                    config_.layer_width, seed);
+        else
+            throw std::invalid_argument("Unknown generator: " + generator);
+        if (config_.shuffle)
+            dgraph::generators::shuffle_ids(node_count, edges, seed * 31 + 7);
+        return edges;
+    }
+
+    BenchmarkResult make_result(const std::string& generator, const std::string& operation,
+                                const BenchmarkInput& input) const {
+        BenchmarkResult res;
+        res.generator = generator;
+        res.operation = operation;
+        res.status = "ok";
+        res.node_count = input.graph.node_count();
+        res.edge_count = input.graph.edge_count();
+        res.graph_bytes = input.graph.memory_usage().total_bytes();
+        return res;
+    }
+
+    //times the recovery of a journal holding a checkpoint of the graph and a log that removes
+    //every tenth edge, written untimed into a temporary directory
+    void measure_recovery(const BenchmarkInput& input, BenchmarkResult& res) {
+        char directory[] = "/tmp/dgraph_journal_XXXXXX";
+        if (mkdtemp(directory) == NULL) {
+            res.status = "skipped";
+            writer_.write(res);
+            return;
+        }
+        {
+            dgraph::DirectedGraph copy(input.graph);
+            copy.set_compaction_threshold(-1);
+            dgraph::GraphJournal<> journal(copy, directory, 0);
+            remove_edges(copy, input.removed_edges);
+        }
+
+        res.repetitions = config_.repetitions;
+        res.min_seconds = 1e100;
+        util::PeakUsageScope peak_usage(tracker_);
+        for (int r = 0; r < config_.repetitions; ++r) {
+            dgraph::DirectedGraph recovered;
+            double begin = now_seconds();
+            dgraph::GraphJournal<> journal(recovered, directory, 0);
+            double elapsed = now_seconds() - begin;
+            res.mean_seconds += elapsed;
+            res.min_seconds = std::min(res.min_seconds, elapsed);
+        }
+        res.mean_seconds /= config_.repetitions;
+        res.peak_rss_kb = peak_rss_kb();
+        res.peak_temporary_bytes = peak_usage.peak_bytes();
+        writer_.write(res);
+
+        unlink((std::string(directory) + "/checkpoint").c_str());
+        unlink((std::string(directory) + "/mutations.log").c_str());
+        rmdir(directory);
+    }
+
+    //times the out-of-core graph in a temporary directory: its build from the text, or bfs and scc
+    //over a layout built untimed; the budget is --external-budget
+    void measure_external(Operation op, const BenchmarkInput& input, BenchmarkResult& res) {
+        char directory[] = "/tmp/dgraph_external_XXXXXX";
+        if (mkdtemp(directory) == NULL) {
+            res.status = "skipped";
+            writer_.write(res);
+            return;
+        }
+        std::size_t budget = (std::size_t)config_.external_budget_mb << 20;
+        const char* files[] = { "/index.bin", "/successors.bin", "/predecessors.bin" };
+        if (op != EXTERNAL_BUILD) {
+            std::istringstream in(input.text);
+            dgraph::ExternalDirectedGraph::build(in, directory, budget);
+        }
+
+        res.repetitions = config_.repetitions;
+        res.min_seconds = 1e100;
+        util::PeakUsageScope peak_usage(tracker_);
+        for (int r = 0; r < config_.repetitions; ++r) {
+            double begin = now_seconds();
+            if (op == EXTERNAL_BUILD) {
+                std::istringstream in(input.text);
+                dgraph::ExternalDirectedGraph::build(in, directory, budget);
+            }
+            else {
+                dgraph::ExternalDirectedGraph graph(directory, budget);
+                if (op == EXTERNAL_BFS)
+                    graph.breadth_first_search(0);
+                else
+                    graph.get_strongly_connected_components();
+            }
+            double elapsed = now_seconds() - begin;
+            res.mean_seconds += elapsed;
+            res.min_seconds = std::min(res.min_seconds, elapsed);
+        }
+        res.mean_seconds /= config_.repetitions;
+        res.peak_rss_kb = peak_rss_kb();
+        res.peak_temporary_bytes = peak_usage.peak_bytes();
+        //the size of the layout on disk, the offsets included
+        unsigned long long layout_bytes = 0;
+        for (int i = 0; i < 3; ++i) {
+            struct stat status;
+            if (stat((std::string(directory) + files[i]).c_str(), &status) == 0)
+                layout_bytes += (unsigned long long)status.st_size;
+        }
+        if (res.edge_count > 0)
+            res.bytes_per_edge = (double)layout_bytes / res.edge_count;
+        writer_.write(res);
+
+        for (int i = 0; i < 3; ++i)
+            unlink((std::string(directory) + files[i]).c_str());
+        rmdir(directory);
+    }
+
+    //times the graph sharded across --shards forked processes: its load from the text, or bfs
+    //over a graph loaded untimed; the peak memory is the coordinator's
+    void measure_sharded(Operation op, const BenchmarkInput& input, BenchmarkResult& res) {
+        dgraph::UnixSocketTransport transport(config_.shards);
+        dgraph::ShardedDirectedGraph graph(transport);
+        if (op == SHARDED_BFS) {
+            std::istringstream in(input.text);
+            graph.load(in);
+        }
+
+        res.repetitions = config_.repetitions;
+        res.min_seconds = 1e100;
+        util::PeakUsageScope peak_usage(tracker_);
+        for (int r = 0; r < config_.repetitions; ++r) {
+            double begin = now_seconds();
+            if (op == SHARDED_LOAD) {
+                std::istringstream in(input.text);
+                graph.load(in);
+            }
+            else
+                graph.breadth_first_search(0);
+            double elapsed = now_seconds() - begin;
+            res.mean_seconds += elapsed;
+            res.min_seconds = std::min(res.min_seconds, elapsed);
+        }
+        res.mean_seconds /= config_.repetitions;
+        res.peak_rss_kb = peak_rss_kb();
+        res.peak_temporary_bytes = peak_usage.peak_bytes();
+        writer_.write(res);
+    }
+
+    //times bfs, dfs and scc over a reordered copy of the graph
+    void measure_traversals(const std::string& generator, const std::string& suffix,
+                            const dgraph::DirectedGraph& graph, int source_id,
+                            const BenchmarkInput& input) {
+        CacheMissCounter counter;
+        for (int op = BFS; op <= SCC; ++op) {
+            BenchmarkResult res = make_result(generator, std::string(operation_names[op]) + suffix, input);
+            res.repetitions = config_.repetitions;
+            res.min_seconds = 1e100;
+            util::PeakUsageScope peak_usage(tracker_);
+            counter.start();
+            for (int r = 0; r < config_.repetitions; ++r) {
+                double begin = now_seconds();
+                if (op == BFS)
+                    graph.breadth_first_search(source_id);
+                else if (op == DFS)
+                    graph.depth_first_search(source_id);
+                else
+                    graph.get_strongly_connected_components();
+                double elapsed = now_seconds() - begin;
+                res.mean_seconds += elapsed;
+                res.min_seconds = std::min(res.min_seconds, elapsed);
+            }
+            long long misses = counter.stop();
+            res.mean_seconds /= config_.repetitions;
+            res.cache_misses = (misses < 0 ? -1 : misses / config_.repetitions);
+            res.peak_rss_kb = peak_rss_kb();
+            res.peak_temporary_bytes = peak_usage.peak_bytes();
+            writer_.write(res);
+        }
+    }
+
+    void measure(const std::string& generator, Operation op, const BenchmarkInput& input) {
+        BenchmarkResult res = make_result(generator, operation_names[op], input);
+        bool needs_dag = (op == TOPOLOGICAL_SORT || op == COMPRESSED_TOPOLOGICAL_SORT ||
+                          op == DAG_SHORTEST_PATHS || op == TRANSITIVE_REDUCTION || op == CRITICAL_PATH);
+        if (op == DIJKSTRA || op == DAG_SHORTEST_PATHS)
+            res.graph_bytes = input.weighted_graph.memory_usage().total_bytes();
+        if ((needs_dag && !input.acyclic) ||
+                ((op == PATH_MATRIX || op == PARALLEL_PATH_MATRIX) &&
+                 input.graph.node_count() > config_.path_matrix_limit)) {
+            res.status = "skipped";
+            writer_.write(res);
+            return;
+        }
+
+        if (op == ADD_NEW_NODE || op == REMOVE_EDGES || op == COMPACT || op == PUBLISH) {
+            //every repetition changes a fresh copy, only the change itself is timed
+            res.repetitions = config_.repetitions;
+            res.min_seconds = 1e100;
+            for (int r = 0; r < config_.repetitions; ++r) {
+                dgraph::DirectedGraph copy(input.graph);
+                std::istringstream in(input.new_node_text);
+                dgraph::VersionedGraph<> versioned;
+                if (op == COMPACT) {
+                    //the tombstones are recorded untimed, without letting them trigger a compaction
+                    copy.set_compaction_threshold(-1);
+                    remove_edges(copy, input.removed_edges);
+                }
+                if (op == PUBLISH)
+                    versioned.writer() = input.graph;
+                util::PeakUsageScope peak_usage(tracker_);
+                double begin = now_seconds();
+                if (op == ADD_NEW_NODE)
+                    copy.add_new_node(in);
+                else if (op == REMOVE_EDGES)
+                    remove_edges(copy, input.removed_edges);
+                else if (op == COMPACT)
+                    copy.compact();
+                else
+                    versioned.publish();
+                double elapsed = now_seconds() - begin;
+                res.mean_seconds += elapsed;
+                res.min_seconds = std::min(res.min_seconds, elapsed);
+                res.peak_temporary_bytes = std::max(res.peak_temporary_bytes,
+                                                    (unsigned long)peak_usage.peak_bytes());
+            }
+            res.mean_seconds /= config_.repetitions;
+            res.peak_rss_kb = peak_rss_kb();
+            writer_.write(res);
+            return;
+        }
+
+        if (op == JOURNAL_RECOVER) {
+            measure_recovery(input, res);
+            return;
+        }
+
+        if (op == EXTERNAL_BUILD || op == EXTERNAL_BFS || op == EXTERNAL_SCC) {
+            measure_external(op, input, res);
+            return;
+        }
+
+        if (op == SHARDED_LOAD || op == SHARDED_BFS) {
+            measure_sharded(op, input, res);
+            return;
+        }
+
+        if (op == REORDER_BFS_ORDER || op == REORDER_RCM || op == REORDER_DEGREE_SORTED) {
+            //a reorder is timed once, then the traversals are timed on the reordered graph
+            dgraph::ReorderStrategy strategy = (op == REORDER_BFS_ORDER ? dgraph::BFS_ORDER :
+                                                op == REORDER_RCM ? dgraph::REVERSE_CUTHILL_MCKEE :
+                                                dgraph::DEGREE_SORTED);
+            dgraph::DirectedGraph reordered(input.graph);
+            util::PeakUsageScope peak_usage(tracker_);
+            double begin = now_seconds();
+            dgraph::NodePermutation permutation = reordered.reorder(strategy);
+            res.mean_seconds = res.min_seconds = now_seconds() - begin;
+            res.peak_temporary_bytes = peak_usage.peak_bytes();
+            res.repetitions = 1;
+            res.peak_rss_kb = peak_rss_kb();
+            writer_.write(res);
+            std::string suffix = std::string("[") + (operation_names[op] + std::strlen("reorder_")) + "]";
+            measure_traversals(generator, suffix, reordered, permutation.to_new_id(0), input);
+            return;
+        }
+
+        CacheMissCounter counter;
+        res.repetitions = config_.repetitions;
+        res.min_seconds = 1e100;
+        //everything an operation allocates and frees again counts as temporary,
+        //including the result it returns
+        util::PeakUsageScope peak_usage(tracker_);
+        counter.start();
+        for (int r = 0; r < config_.repetitions; ++r) {
+            double begin = now_seconds();
+            run_operation(op, input);
+            double elapsed = now_seconds() - begin;
+            res.mean_seconds += elapsed;
+            res.min_seconds = std::min(res.min_seconds, elapsed);
+        }
+        long long misses = counter.stop();
+        res.mean_seconds /= config_.repetitions;
+        res.cache_misses = (misses < 0 ? -1 : misses / config_.repetitions);
+        res.peak_rss_kb = peak_rss_kb();
+        res.peak_temporary_bytes = peak_usage.peak_bytes();
+        if (op == COMPRESSED_BUILD)
+            res.bytes_per_edge = input.compressed.bytes_per_edge();
+        writer_.write(res);
+    }
+};
+
+void print_usage(const char* program) {
+    BenchmarkConfig defaults;
+    std::cerr << "usage: " << program << " [options]\n"
+              << "  --generators LIST     comma separated subset of rmat,erdos_renyi,chain,layered_dag\n"
+              << "  --operations LIST     comma separated operation names, or all (default)\n"
+              << "  --min-nodes N         smallest graph (default " << defaults.min_nodes << ")\n"
+              << "  --max-nodes N         largest graph (default " << defaults.max_nodes << ")\n"
+              << "  --growth X            size multiplier between runs (default " << defaults.growth << ")\n"
+              << "  --degree D            average out-degree (default " << defaults.average_degree << ")\n"
+              << "  --layer-width W       layer width of layered_dag (default " << defaults.layer_width << ")\n"
+              << "  --repetitions R       timed repetitions per operation (default " << defaults.repetitions << ")\n"
+              << "  --path-matrix-limit N largest graph for path_matrix (default "
+              << defaults.path_matrix_limit << ")\n"
+              << "  --max-weight W        largest edge weight of the shortest path operations (default "
+              << defaults.max_weight << ")\n"
+              << "  --threads T           worker threads of the parallel operations (default: DGRAPH_THREADS,\n"
+              << "                        or one per hardware thread)\n"
+              << "  --external-budget MB  memory budget of the external operations (default "
+              << defaults.external_budget_mb << ")\n"
+              << "  --shards S            worker processes of the sharded operations (default "
+              << defaults.shards << ")\n"
+              << "  --seed S              generator seed (default " << defaults.seed << ")\n"
+              << "  --shuffle             relabel the generated nodes randomly\n"
+              << "  --format json|csv     output format (default json lines)\n"
+              << "  --trace FILE          write a Chrome trace of the run to FILE and a summary to stderr\n"
+              << "                        (needs a build with -DDGRAPH_ENABLE_TRACING=ON)\n"
+              << "operations:";
+    for (int op = 0; op < OPERATION_COUNT; ++op)
+        std::cerr << ' ' << operation_names[op];
+    std::cerr << '\n';
+}
+
+bool parse_arguments(int argc, char** argv, BenchmarkConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--shuffle") {
+            config.shuffle = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        if (arg == "--generators")
+            config.generators = value;
+        else if (arg == "--operations")
+            config.operations = value;
+        else if (arg == "--min-nodes")
+            config.min_nodes = std::atoi(value.c_str());
+        else if (arg == "--max-nodes")
+            config.max_nodes = std::atoi(value.c_str());
+        else if (arg == "--growth")
+            config.growth = std::atof(value.c_str());
+        else if (arg == "--degree")
+            config.average_degree = std::atoi(value.c_str());
+        else if (arg == "--layer-width")
+            config.layer_width = std::atoi(value.c_str());
+        else if (arg == "--repetitions")
+            config.repetitions = std::atoi(value.c_str());
+        else if (arg == "--path-matrix-limit")
+            config.path_matrix_limit = std::atoi(value.c_str());
+        else if (arg == "--max-weight")
+            config.max_weight = std::atoi(value.c_str());
+        else if (arg == "--threads")
+            config.threads = std::atoi(value.c_str());
+        else if (arg == "--external-budget")
+            config.external_budget_mb = std::atoi(value.c_str());
+        else if (arg == "--shards")
+            config.shards = std::atoi(value.c_str());
+        else if (arg == "--seed")
+            config.seed = std::strtoull(value.c_str(), NULL, 10);
+        else if (arg == "--format")
+            config.format = value;
+        else if (arg == "--trace")
+            config.trace_path = value;
+        else
+            return false;
+    }
+    return (config.min_nodes >= 2 && config.max_nodes >= config.min_nodes && config.growth > 1.0 &&
+            config.average_degree >= 1 && config.repetitions >= 1 && config.max_weight >= 1 &&
+            config.threads >= 0 && config.external_budget_mb >= 1 && config.shards >= 1 &&
+            (config.format == "json" || config.format == "csv"));
+}
+
+int main(int argc, char** argv) {
+    BenchmarkConfig config;
+    if (!parse_arguments(argc, argv, config)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (config.threads > 0)
+        util::set_default_thread_count(config.threads);
+
+    if (!config.trace_path.empty()) {
+#ifdef DGRAPH_ENABLE_TRACING
+        util::trace::set_enabled(true);
+#else
+        std::cerr << "warning: --trace ignored, tracing was not compiled in\n";
+#endif
+    }
+
+    //every container allocation goes through the tracker, which yields the per-operation peaks
+    util::TrackingResource tracker;
+    util::ScopedDefaultResource tracked_scope(&tracker);
+
+    ResultWriter writer(std::cout, config.format);
+    Benchmark benchmark(config, writer, tracker);
+    const char* generators[4] = {"rmat", "erdos_renyi", "chain", "layered_dag"};
+    try {
+        for (int g = 0; g < 4; ++g) {
+            if (!contains_item(config.generators, generators[g]))
+                continue;
+            for (double size = config.min_nodes; size <= config.max_nodes; size *= config.growth)
+                benchmark.run_generator(generators[g], (int)size);
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "benchmark failed: " << e.what() << '\n';
+        return 1;
+    }
+
+    if (util::trace::is_enabled()) {
+        std::ofstream trace_out(config.trace_path.c_str());
+        util::trace::write_chrome_trace(trace_out);
+        util::trace::write_summary(std::cerr);
+    }
+
+    return 0;
+}
@@ -0,0 +1,352 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include "directed_graph.h"
+#include "critical_path.h"
+
+//checks the parallel and incremental algorithms against the sequential ones or against brute force,
+//on small random graphs; every check also runs on a graph with narrow id and offset types.
+//exits with a non-zero status if any check fails
+
+using namespace dgraph;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << '\n';
+        failures++;
+    }
+}
+
+typedef BasicDirectedGraph<unsigned char, unsigned short> NarrowGraph;
+
+//a graph with n nodes where every pair gets an edge with the given probability; when acyclic,
+//every edge goes from the lower to the higher of two random ranks, so new nodes land anywhere
+//in the topological order. Some edges and a node other than 0 are deleted afterwards
+template<typename Graph>
+static Graph random_graph(std::mt19937& rng, int n, double probability, bool acyclic, bool with_deletions = true) {
+    typedef typename Graph::id_type IdType;
+    typedef typename Graph::Edge Edge;
+    std::uniform_real_distribution< double > coin(0, 1);
+    std::vector< double > ranks;
+    Graph graph;
+    for (int id = 0; id < n; ++id) {
+        ranks.push_back(coin(rng));
+        util::Vector< Edge > edges;
+        for (int other = 0; other < id; ++other)
+            if (coin(rng) < probability) {
+                bool forward = (acyclic ? ranks[other] < ranks[id] : coin(rng) < 0.5);
+                edges.push_back(forward ? Edge((IdType)other, (IdType)id) : Edge((IdType)id, (IdType)other));
+            }
+        graph.add_new_node(edges);
+    }
+    if (with_deletions && n > 2) {
+        for (int k = 0; k < n / 4; ++k) {
+            IdType from = (IdType)(rng() % n), to = (IdType)(rng() % n);
+            if (from != to && graph.has_edge(from, to))
+                graph.remove_edge(from, to);
+        }
+        graph.remove_node((IdType)(1 + rng() % (n - 1)));
+    }
+    return graph;
+}
+
+//the nodes reachable from source_id without passing through skipped_id
+template<typename Graph>
+static std::vector< bool > reachable(const Graph& graph, int source_id, int skipped_id = -1) {
+    typedef typename Graph::id_type IdType;
+    std::vector< bool > seen(graph.node_count(), false);
+    std::vector< int > stack(1, source_id);
+    seen[source_id] = true;
+    while (!stack.empty()) {
+        int id = stack.back();
+        stack.pop_back();
+        const util::Vector< IdType >& successors = graph.get_node_by_id((IdType)id)->get_direct_successors();
+        for (util::size_t k = 0; k < successors.size(); ++k) {
+            int next = successors[k];
+            if (next != skipped_id && !seen[next] && !graph.is_edge_deleted((IdType)id, (IdType)next)) {
+                seen[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+    return seen;
+}
+
+template<typename Node>
+static std::vector< int > ids_of(const util::Vector< const Node* >& nodes) {
+    std::vector< int > res;
+    for (util::size_t k = 0; k < nodes.size(); ++k)
+        res.push_back(nodes[k]->get_id());
+    return res;
+}
+
+//the components with their nodes sorted by id, sorted by their smallest id
+template<typename Node>
+static std::vector< std::vector< int > > normalized(const util::Vector< util::Vector< const Node* > >& components) {
+    std::vector< std::vector< int > > res;
+    for (util::size_t k = 0; k < components.size(); ++k) {
+        res.push_back(ids_of(components[k]));
+        std::sort(res.back().begin(), res.back().end());
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+static bool same_matrix(const util::Vector< util::Vector< bool > >& lhs, const util::Vector< util::Vector< bool > >& rhs) {
+    if (lhs.size() != rhs.size())
+        return false;
+    for (util::size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].size() != rhs[i].size())
+            return false;
+        for (util::size_t j = 0; j < lhs[i].size(); ++j)
+            if (lhs[i][j] != rhs[i][j])
+                return false;
+    }
+    return true;
+}
+
+template<typename Graph>
+static void test_parallel(std::mt19937& rng, int n, const std::string& name) {
+    Graph graph = random_graph< Graph >(rng, n, 3.0 / n, false), other = random_graph< Graph >(rng, n, 2.0 / n, false);
+    check(ids_of(graph.parallel_breadth_first_search(0)) == ids_of(graph.breadth_first_search(0)),
+          name + ": parallel_breadth_first_search differs");
+    util::Vector< util::Vector< const typename Graph::Node* > > components = graph.parallel_strongly_connected_components();
+    check(normalized(components) == normalized(graph.get_strongly_connected_components()),
+          name + ": parallel_strongly_connected_components differs");
+    check(same_matrix(graph.parallel_path_matrix(), graph.get_path_matrix()), name + ": parallel_path_matrix differs");
+    Graph merged = graph + other, parallel_merged = graph.parallel_union(other);
+    check(parallel_merged == merged && parallel_merged.edge_count() == merged.edge_count(),
+          name + ": parallel_union differs");
+}
+
+template<typename Graph>
+static void test_transitive_reduction(std::mt19937& rng, int n, const std::string& name) {
+    typedef typename Graph::id_type IdType;
+    Graph graph = random_graph< Graph >(rng, n, 0.3, true);
+    std::vector< std::vector< bool > > reach;
+    for (int id = 0; id < n; ++id)
+        reach.push_back(reachable(graph, id));
+    typename Graph::offset_type removed = 0;
+    Graph reduced = graph.transitive_reduction(&removed);
+    //an edge (u, v) is redundant if another successor of u reaches v
+    int expected_removed = 0;
+    bool same = (reduced.node_count() == graph.node_count());
+    for (int from = 0; from < n && same; ++from)
+        for (int to = 0; to < n; ++to) {
+            if (graph.is_node_deleted((IdType)from) || graph.is_node_deleted((IdType)to) || from == to)
+                continue;
+            bool kept = graph.has_edge((IdType)from, (IdType)to);
+            if (kept) {
+                const util::Vector< IdType >& successors = graph.get_node_by_id((IdType)from)->get_direct_successors();
+                for (util::size_t k = 0; k < successors.size() && kept; ++k)
+                    if (successors[k] != to && !graph.is_edge_deleted((IdType)from, successors[k]) && reach[successors[k]][to])
+                        kept = false;
+                if (!kept)
+                    expected_removed++;
+            }
+            if (reduced.has_edge((IdType)from, (IdType)to) != kept)
+                same = false;
+        }
+    check(same && (int)removed == expected_removed, name + ": transitive_reduction differs from brute force");
+}
+
+template<typename Graph>
+static void test_dominators(std::mt19937& rng, int n, const std::string& name) {
+    typedef typename Graph::id_type IdType;
+    Graph graph = random_graph< Graph >(rng, n, 2.5 / n, false);
+    DominatorTree< IdType > tree = graph.dominator_tree(0);
+    std::vector< bool > from_root = reachable(graph, 0);
+    bool same = true;
+    for (int a = 0; a < n; ++a) {
+        //a dominates the nodes it cuts off from the root, and itself if it is reachable
+        std::vector< bool > without_a = reachable(graph, 0, a);
+        for (int b = 0; b < n; ++b) {
+            bool expected = from_root[a] && from_root[b] && (a == b || a == 0 || !without_a[b]);
+            if (tree.dominates((IdType)a, (IdType)b) != expected)
+                same = false;
+        }
+        if (tree.is_reachable((IdType)a) != from_root[a])
+            same = false;
+    }
+    check(same, name + ": dominator_tree differs from brute force");
+}
+
+//a chain longer than half the id range, whose tree numbers once wrapped around in IdType
+static void test_long_dominator_chain() {
+    typedef BasicDirectedGraph<unsigned short, int> ShortGraph;
+    const int n = 40000;
+    ShortGraph chain;
+    for (int id = 0; id < n; ++id) {
+        util::Vector< ShortGraph::Edge > edges;
+        if (id > 0)
+            edges.push_back(ShortGraph::Edge((unsigned short)(id - 1), (unsigned short)id));
+        chain.add_new_node(edges);
+    }
+    //on a chain a dominates b exactly when a comes first
+    DominatorTree< unsigned short > tree = chain.dominator_tree(0);
+    std::mt19937 rng(n);
+    int wrong = 0;
+    for (int a = 0; a + 1 < n; ++a)
+        wrong += (!tree.dominates((unsigned short)a, (unsigned short)(a + 1))) +
+                 tree.dominates((unsigned short)(a + 1), (unsigned short)a);
+    for (int k = 0; k < 100000; ++k) {
+        int a = (int)(rng() % n), b = (int)(rng() % n);
+        wrong += (tree.dominates((unsigned short)a, (unsigned short)b) != (a <= b));
+    }
+    check(wrong == 0, "long chain: dominator_tree gives wrong dominates answers");
+}
+
+template<typename Graph>
+static void test_descendant_counts(std::mt19937& rng, int n, const std::string& name) {
+    typedef typename Graph::id_type IdType;
+    Graph graph = random_graph< Graph >(rng, n, 2.0 / n, false);
+    util::Vector< double > estimates = graph.approximate_descendant_counts(0.3);
+    bool bounded = (estimates.size() == (util::size_t)n);
+    for (int id = 0; id < n && bounded; ++id)
+        bounded = (graph.is_node_deleted((IdType)id) ? estimates[id] == 0 :
+                   estimates[id] >= 1 && estimates[id] <= graph.live_node_count());
+    check(bounded, name + ": approximate_descendant_counts out of [1, live_node_count()]");
+}
+
+template<typename Graph>
+static void test_page_rank(std::mt19937& rng, int n, const std::string& name) {
+    typedef typename Graph::id_type IdType;
+    const double damping = 0.85;
+    Graph graph = random_graph< Graph >(rng, n, 2.0 / n, false);
+    //plain power iteration in double precision, spreading the rank of the dangling nodes evenly
+    int live_count = graph.live_node_count();
+    std::vector< int > out_degree(n, 0);
+    for (int id = 0; id < n; ++id)
+        if (!graph.is_node_deleted((IdType)id))
+            for (int other = 0; other < n; ++other)
+                if (other != id && !graph.is_node_deleted((IdType)other) && graph.has_edge((IdType)id, (IdType)other))
+                    out_degree[id]++;
+    std::vector< double > rank(n, 0.0);
+    for (int id = 0; id < n; ++id)
+        if (!graph.is_node_deleted((IdType)id))
+            rank[id] = 1.0 / live_count;
+    for (int iteration = 0; iteration < 300; ++iteration) {
+        double dangling = 0;
+        for (int id = 0; id < n; ++id)
+            if (out_degree[id] == 0)
+                dangling += rank[id];
+        std::vector< double > next(n, 0.0);
+        for (int id = 0; id < n; ++id) {
+            if (graph.is_node_deleted((IdType)id))
+                continue;
+            next[id] = (1 - damping + damping * dangling) / live_count;
+            for (int other = 0; other < n; ++other)
+                if (other != id && !graph.is_node_deleted((IdType)other) && graph.has_edge((IdType)other, (IdType)id))
+                    next[id] += damping * rank[other] / out_degree[other];
+        }
+        rank = next;
+    }
+    util::Vector< float > result = graph.page_rank(damping, 1e-9, 300);
+    bool close = (result.size() == (util::size_t)n);
+    for (int id = 0; id < n && close; ++id)
+        close = (std::fabs(result[id] - rank[id]) < 1e-5);
+    check(close, name + ": page_rank differs from the reference");
+}
+
+template<typename Graph>
+static void test_critical_path(std::mt19937& rng, int n, const std::string& name) {
+    typedef typename Graph::id_type IdType;
+    typedef typename Graph::Edge Edge;
+    std::uniform_real_distribution< double > coin(0, 1);
+    Graph graph = random_graph< Graph >(rng, n, 3.0 / n, true);
+    //the nodes added later need ranks that keep the graph acyclic: a topological position each
+    util::Vector< const typename Graph::Node* > order = graph.topological_sort();
+    std::vector< double > ranks(n, 0.0);
+    for (util::size_t k = 0; k < order.size(); ++k)
+        ranks[order[k]->get_id()] = k + coin(rng);
+    util::Vector< double > costs(n, 0.0), new_costs;
+    for (int id = 0; id < n; ++id)
+        costs[id] = (double)(rng() % 10);
+    CriticalPathEngine< Graph > engine(graph, &costs);
+
+    for (int added = 0; added < n / 2; ++added) {
+        int id = graph.node_count();
+        ranks.push_back(coin(rng) * order.size());
+        util::Vector< Edge > edges;
+        for (int other = 0; other < id; ++other)
+            if (!graph.is_node_deleted((IdType)other) && coin(rng) < 3.0 / n)
+                edges.push_back(ranks[other] < ranks[id] ? Edge((IdType)other, (IdType)id) : Edge((IdType)id, (IdType)other));
+        graph.add_new_node(edges);
+        new_costs.push_back((double)(rng() % 10));
+        costs.push_back(new_costs.back());
+        //the updates are batched unevenly, so some take in one node and some several
+        if (rng() % 3 == 0) {
+            engine.update(&new_costs);
+            new_costs.clear();
+        }
+    }
+    engine.update(&new_costs);
+
+    CriticalPathEngine< Graph > fresh(graph, &costs);
+    bool same = (engine.node_count() == fresh.node_count() && engine.makespan() == fresh.makespan());
+    for (IdType id = 0; id < graph.node_count() && same; ++id)
+        same = (engine.earliest_start(id) == fresh.earliest_start(id) && engine.slack(id) == fresh.slack(id));
+    util::Vector< IdType > path = engine.critical_path();
+    double length = 0;
+    for (util::size_t k = 0; k < path.size(); ++k)
+        length += engine.cost(path[k]);
+    check(same && length == fresh.makespan(), name + ": CriticalPathEngine::update differs from a new engine");
+}
+
+template<typename Graph>
+static void run_all(std::mt19937& rng, int rounds, int max_nodes, const std::string& name) {
+    for (int round = 0; round < rounds; ++round) {
+        int n = 2 + (int)(rng() % (max_nodes - 1));
+        try {
+            test_parallel< Graph >(rng, n, name);
+            test_transitive_reduction< Graph >(rng, n, name);
+            test_dominators< Graph >(rng, n, name);
+            test_descendant_counts< Graph >(rng, n, name);
+            test_page_rank< Graph >(rng, n, name);
+            test_critical_path< Graph >(rng, n, name);
+        }
+        catch (std::exception& e) {
+            check(false, name + ": " + e.what());
+        }
+    }
+}
+
+int main() {
+    //more workers than most of the graphs have nodes, so the parallel algorithms do split their work
+    util::set_default_thread_count(4);
+    std::mt19937 rng(20261019);
+    run_all< DirectedGraph >(rng, 60, 80, "int ids");
+    run_all< NarrowGraph >(rng, 60, 80, "unsigned char ids");
+    test_long_dominator_chain();
+
+    //a larger graph for the parallel traversals, which split their levels into ranges; every node
+    //gets edges to or from two earlier ones
+    DirectedGraph large;
+    for (int id = 0; id < 20000; ++id) {
+        util::Vector< Edge > edges;
+        for (int k = 0; k < 2 && id > 1; ++k) {
+            int other = (int)(rng() % id);
+            Edge edge = (rng() % 2 == 0 ? Edge(other, id) : Edge(id, other));
+            if (std::find(edges.begin(), edges.end(), edge) == edges.end())
+                edges.push_back(edge);
+        }
+        large.add_new_node(edges);
+    }
+    check(ids_of(large.parallel_breadth_first_search(0)) == ids_of(large.breadth_first_search(0)),
+          "large: parallel_breadth_first_search differs");
+    check(normalized(large.parallel_strongly_connected_components()) ==
+          normalized(large.get_strongly_connected_components()),
+          "large: parallel_strongly_connected_components differs");
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "all checks passed\n";
+    return 0;
+}
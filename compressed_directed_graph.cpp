@@ -0,0 +1,413 @@
+#include <algorithm>
+#include <limits>
+#include "compressed_directed_graph.h"
+
+namespace dgraph {
+
+    namespace {
+        int varint_length(unsigned int value) {
+            int length = 1;
+            for (; value >= 0x80; value >>= 7)
+                length++;
+            return length;
+        }
+
+        void write_varint(unsigned int value, util::Vector< unsigned char >& data) {
+            for (; value >= 0x80; value >>= 7)
+                data.push_back((unsigned char)(value | 0x80));
+            data.push_back((unsigned char)value);
+        }
+
+#ifndef DGRAPH_COMPRESSED_CHUNK_BYTES
+        //largest chunk of encoded lists; every chunk is one util::Vector
+        const unsigned long long max_chunk_bytes = std::numeric_limits< util::size_t >::max();
+#else
+        const unsigned long long max_chunk_bytes = DGRAPH_COMPRESSED_CHUNK_BYTES;
+#endif
+
+        //state of one emulated recursive call: the node and the rest of its successor list
+        struct CursorFrame {
+            CursorFrame() : node_id(-1) {}
+            CursorFrame(int node_id, const AdjacencyCursor& successors) :
+                    node_id(node_id), successors(successors) {}
+            int node_id;
+            AdjacencyCursor successors;
+        };
+    }
+
+    //implementation of AdjacencyCursor's methods
+    AdjacencyCursor::AdjacencyCursor() : position_(NULL), end_(NULL), last_id_(-1) {}
+    AdjacencyCursor::AdjacencyCursor(const unsigned char *position, const unsigned char *end) :
+            position_(position), end_(end), last_id_(-1) {}
+
+    bool AdjacencyCursor::has_next() const {
+        return position_ != end_;
+    }
+
+    int AdjacencyCursor::next() {
+        unsigned int value = 0;
+        int shift = 0;
+        while (*position_ & 0x80) {
+            value |= (unsigned int)(*position_++ & 0x7f) << shift;
+            shift += 7;
+        }
+        value |= (unsigned int)(*position_++) << shift;
+        last_id_ += (int)value + 1;
+        return last_id_;
+    }
+
+    int AdjacencyCursor::remaining() const {
+        //every varint ends in exactly one byte without the continuation bit
+        int count = 0;
+        for (const unsigned char* it = position_; it != end_; ++it)
+            if (!(*it & 0x80))
+                count++;
+        return count;
+    }
+
+    //implementation of EncodedLists' methods
+    AdjacencyCursor CompressedDirectedGraph::EncodedLists::cursor(int id) const {
+        unsigned long long begin = offsets[id], end = offsets[id + 1];
+        if (begin == end)
+            return AdjacencyCursor();
+        //there is usually a single chunk, and otherwise only a few
+        util::size_t chunk = (util::size_t)(std::upper_bound(chunk_starts.begin(), chunk_starts.end(), begin) -
+                                            chunk_starts.begin()) - 1;
+        const unsigned char* data = chunks[chunk].begin() + (begin - chunk_starts[chunk]);
+        return AdjacencyCursor(data, data + (end - begin));
+    }
+
+    unsigned long long CompressedDirectedGraph::EncodedLists::data_bytes() const {
+        return offsets[offsets.size() - 1];
+    }
+
+    unsigned long CompressedDirectedGraph::EncodedLists::memory_bytes() const {
+        unsigned long res = (unsigned long)(offsets.capacity() + chunk_starts.capacity()) * sizeof(unsigned long long);
+        for (util::size_t k = 0; k < chunks.size(); ++k)
+            res += chunks[k].capacity();
+        return res;
+    }
+
+    //implementation of CompressedDirectedGraph's methods
+    CompressedDirectedGraph::CompressedDirectedGraph() : node_count_(0), edge_count_(0) {}
+
+    CompressedDirectedGraph::CompressedDirectedGraph(const DirectedGraph &graph) {
+        util::Vector< Edge > edges;
+        for (int i = 0; i < graph.node_count(); ++i) {
+            const util::Vector< int >& current_successors = graph.get_node_by_id(i)->get_direct_successors();
+            for (util::Vector< int >::const_iterator it = current_successors.begin();
+                 it != current_successors.end(); ++it)
+                if (!graph.is_edge_deleted(i, *it))
+                    edges.push_back(Edge(i, *it));
+        }
+        build(graph.node_count(), edges);
+    }
+
+    CompressedDirectedGraph::CompressedDirectedGraph(const CompressedDirectedGraph &rhs) :
+            node_count_(rhs.node_count_), edge_count_(rhs.edge_count_),
+            successor_lists_(rhs.successor_lists_), predecessor_lists_(rhs.predecessor_lists_) {}
+
+    CompressedDirectedGraph& CompressedDirectedGraph::operator=(const CompressedDirectedGraph &rhs) {
+        node_count_ = rhs.node_count_;
+        edge_count_ = rhs.edge_count_;
+        successor_lists_ = rhs.successor_lists_;
+        predecessor_lists_ = rhs.predecessor_lists_;
+        return (*this);
+    }
+
+    CompressedDirectedGraph::~CompressedDirectedGraph() {}
+
+    void CompressedDirectedGraph::encode(int node_count, const util::Vector<Edge> &edges, EncodedLists &lists) {
+        //the exact size of the encoding is computed first, so every chunk is allocated only once;
+        //a list that does not fit in the rest of the current chunk starts a new one
+        lists.offsets = util::Vector< unsigned long long >(node_count + 1, 0);
+        lists.chunk_starts = util::Vector< unsigned long long >();
+        util::Vector< unsigned long long > chunk_sizes;
+        util::size_t edge_idx = 0;
+        unsigned long long data_size = 0;
+        for (int node = 0; node < node_count; ++node) {
+            lists.offsets[node] = data_size;
+            unsigned long long list_size = 0;
+            int last_id = -1;
+            for (; edge_idx < edges.size() && edges[edge_idx].from_node_id() == node; ++edge_idx) {
+                list_size += varint_length((unsigned int)(edges[edge_idx].to_node_id() - last_id - 1));
+                last_id = edges[edge_idx].to_node_id();
+            }
+            if (list_size == 0)
+                continue;
+            if (list_size > max_chunk_bytes)
+                throw bad_dgraph_config();
+            if (chunk_sizes.empty() || chunk_sizes.back() + list_size > max_chunk_bytes) {
+                lists.chunk_starts.push_back(data_size);
+                chunk_sizes.push_back(0);
+            }
+            chunk_sizes.back() += list_size;
+            data_size += list_size;
+        }
+        lists.offsets[node_count] = data_size;
+
+        //the chunks are reserved in place, so none of them is ever copied
+        lists.chunks = util::Vector< util::Vector< unsigned char > >(chunk_sizes.size());
+        for (util::size_t k = 0; k < chunk_sizes.size(); ++k)
+            lists.chunks[k].reserve((util::size_t)chunk_sizes[k]);
+        util::size_t chunk = 0;
+        edge_idx = 0;
+        for (int node = 0; node < node_count; ++node) {
+            if (lists.offsets[node] == lists.offsets[node + 1])
+                continue;
+            if (lists.chunks[chunk].size() == chunk_sizes[chunk])
+                chunk++;
+            int last_id = -1;
+            for (; edge_idx < edges.size() && edges[edge_idx].from_node_id() == node; ++edge_idx) {
+                write_varint((unsigned int)(edges[edge_idx].to_node_id() - last_id - 1), lists.chunks[chunk]);
+                last_id = edges[edge_idx].to_node_id();
+            }
+        }
+    }
+
+    void CompressedDirectedGraph::build(int node_count, util::Vector<Edge> &edges) {
+        DGRAPH_TRACE_SCOPE("compressed/build");
+        node_count_ = node_count;
+        edge_count_ = (long long)edges.size();
+
+        std::sort(edges.begin(), edges.end());
+        encode(node_count_, edges, successor_lists_);
+
+        //the predecessor lists are the successor lists of the reversed edges
+        for (util::size_t i = 0; i < edges.size(); ++i)
+            edges[i] = Edge(edges[i].to_node_id(), edges[i].from_node_id());
+        std::sort(edges.begin(), edges.end());
+        encode(node_count_, edges, predecessor_lists_);
+    }
+
+    std::istream& operator >> (std::istream &in, CompressedDirectedGraph &graph) {
+        DGRAPH_TRACE_SCOPE("compressed/load");
+        int node_count;
+        long long edge_count;
+        if (!(in >> node_count)) throw bad_dgraph_config();
+        if (!(in >> edge_count)) throw bad_dgraph_config();
+        //every edge is kept in a util::Vector until it is encoded
+        if (node_count < 0 || edge_count < 0 ||
+                (unsigned long long)edge_count > (unsigned long long)std::numeric_limits< util::size_t >::max())
+            throw bad_dgraph_config();
+
+        util::Vector< Edge > edges;
+        for (long long i = 0; i < edge_count; ++i) {
+            int from, to;
+            if (!(in >> from)) throw bad_dgraph_config();
+            if (!(in >> to)) throw bad_dgraph_config();
+            if (0 > from || from >= node_count ||
+                    0 > to || to >= node_count)
+                throw bad_dgraph_config();
+            if (from == to)
+                throw bad_dgraph_config();
+            edges.push_back(Edge(from, to));
+        }
+
+        std::sort(edges.begin(), edges.end());
+        for (util::size_t i = 1; i < edges.size(); ++i)
+            if (edges[i - 1] == edges[i])
+                throw bad_dgraph_config();
+
+        graph.build(node_count, edges);
+        return in;
+    }
+
+    std::ostream& operator << (std::ostream &out, const CompressedDirectedGraph &graph) {
+        out << graph.node_count_ << " " << graph.edge_count_ << "\n";
+        for (int i = 0; i < graph.node_count_; ++i)
+            for (AdjacencyCursor it = graph.successors(i); it.has_next(); )
+                out << i << " " << it.next() << '\n';
+        return out;
+    }
+
+    int CompressedDirectedGraph::node_count() const { return node_count_; }
+    long long CompressedDirectedGraph::edge_count() const { return edge_count_; }
+
+    AdjacencyCursor CompressedDirectedGraph::successors(int id) const {
+        if (id < 0 || id >= node_count_)
+            throw std::out_of_range("Invalid node id!");
+        return successor_lists_.cursor(id);
+    }
+
+    AdjacencyCursor CompressedDirectedGraph::predecessors(int id) const {
+        if (id < 0 || id >= node_count_)
+            throw std::out_of_range("Invalid node id!");
+        return predecessor_lists_.cursor(id);
+    }
+
+    int CompressedDirectedGraph::get_in_degree(int id) const {
+        return predecessors(id).remaining();
+    }
+
+    int CompressedDirectedGraph::get_out_degree(int id) const {
+        return successors(id).remaining();
+    }
+
+    util::Vector<int> CompressedDirectedGraph::breadth_first_search(int source_id) const {
+        if (source_id < 0 || source_id >= node_count_)
+            throw std::out_of_range("Invalid node id!");
+        DGRAPH_TRACE_SCOPE("compressed/breadth_first_search");
+        //the result doubles as the bfs queue
+        util::Vector< int > res;
+        util::Vector< bool > visited(node_count_, false);
+        visited[source_id] = true;
+        res.push_back(source_id);
+
+        for (util::size_t head = 0; head < res.size(); ++head) {
+            DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+            for (AdjacencyCursor it = successors(res[head]); it.has_next(); ) {
+                int next_id = it.next();
+                DGRAPH_TRACE_COUNT(EDGES_SCANNED, 1);
+                if (!visited[next_id]) {
+                    visited[next_id] = true;
+                    res.push_back(next_id);
+                }
+            }
+        }
+        return res;
+    }
+
+    util::Vector<int> CompressedDirectedGraph::depth_first_search(int source_id) const {
+        if (source_id < 0 || source_id >= node_count_)
+            throw std::out_of_range("Invalid node id!");
+        DGRAPH_TRACE_SCOPE("compressed/depth_first_search");
+        util::Vector< int > res;
+        util::Vector< bool > visited(node_count_, false);
+        util::Stack< CursorFrame > stack;
+        visited[source_id] = true;
+        res.push_back(source_id);
+        stack.push(CursorFrame(source_id, successors(source_id)));
+
+        while (!stack.empty()) {
+            AdjacencyCursor& current_successors = stack.top().successors;
+            if (!current_successors.has_next()) {
+                stack.pop();
+                continue;
+            }
+            int next_id = current_successors.next();
+            if (!visited[next_id]) {
+                visited[next_id] = true;
+                res.push_back(next_id);
+                stack.push(CursorFrame(next_id, successors(next_id)));
+            }
+        }
+        return res;
+    }
+
+    util::Vector< util::Vector<int> > CompressedDirectedGraph::get_strongly_connected_components() const {
+        //same iterative version of Tarjan's algorithm as DirectedGraph::dfs_tarjan
+        DGRAPH_TRACE_SCOPE("compressed/get_strongly_connected_components");
+        util::Vector< util::Vector< int > > scc;
+        int curr_idx = 0;
+        util::Vector< int > idx(node_count_, 0);
+        util::Vector< int > lowlink(node_count_, 0);
+        util::Vector< bool > in_stack(node_count_, false);
+        util::Stack< int > stack;
+        util::Stack< CursorFrame > call_stack;
+
+        for (int root = 0; root < node_count_; ++root) {
+            if (idx[root] != 0)
+                continue;
+            curr_idx++;
+            idx[root] = lowlink[root] = curr_idx;
+            stack.push(root);
+            in_stack[root] = true;
+            call_stack.push(CursorFrame(root, successors(root)));
+
+            while (!call_stack.empty()) {
+                CursorFrame& top = call_stack.top();
+                int current = top.node_id;
+
+                if (top.successors.has_next()) {
+                    int next_id = top.successors.next();
+                    if (idx[next_id] == 0) {
+                        curr_idx++;
+                        idx[next_id] = lowlink[next_id] = curr_idx;
+                        stack.push(next_id);
+                        in_stack[next_id] = true;
+                        call_stack.push(CursorFrame(next_id, successors(next_id)));
+                    }
+                    else if (in_stack[next_id])
+                        lowlink[current] = std::min(lowlink[current], lowlink[next_id]);
+                    continue;
+                }
+
+                call_stack.pop();
+                if (idx[current] == lowlink[current]) {
+                    scc.push_back(util::Vector< int >());
+                    int curr;
+                    do {
+                        curr = stack.top();
+                        scc.back().push_back(curr);
+                        stack.pop();
+                        in_stack[curr] = false;
+                    } while (curr != current);
+                }
+                if (!call_stack.empty()) {
+                    int parent = call_stack.top().node_id;
+                    lowlink[parent] = std::min(lowlink[parent], lowlink[current]);
+                }
+            }
+        }
+        return scc;
+    }
+
+    bool CompressedDirectedGraph::is_acyclic() const {
+        return ((int)get_strongly_connected_components().size() == node_count_);
+    }
+
+    util::Vector<int> CompressedDirectedGraph::topological_sort() const {
+        if (!is_acyclic())
+            throw bad_top_sort();
+
+        //reversed post-order of a dfs started from every source, as in DirectedGraph
+        DGRAPH_TRACE_SCOPE("compressed/topological_sort");
+        util::Vector< int > res;
+        util::Vector< bool > visited(node_count_, false);
+        util::Stack< CursorFrame > stack;
+        for (int i = 0; i < node_count_; ++i) {
+            if (visited[i] || predecessors(i).has_next())
+                continue;
+            visited[i] = true;
+            stack.push(CursorFrame(i, successors(i)));
+            while (!stack.empty()) {
+                CursorFrame& top = stack.top();
+                if (!top.successors.has_next()) {
+                    res.push_back(top.node_id);
+                    stack.pop();
+                    continue;
+                }
+                int next_id = top.successors.next();
+                if (!visited[next_id]) {
+                    visited[next_id] = true;
+                    stack.push(CursorFrame(next_id, successors(next_id)));
+                }
+            }
+        }
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+    unsigned long CompressedDirectedGraph::memory_bytes() const {
+        return successor_lists_.memory_bytes() + predecessor_lists_.memory_bytes();
+    }
+
+    double CompressedDirectedGraph::bytes_per_edge() const {
+        if (edge_count_ == 0)
+            return 0.0;
+        return (double)memory_bytes() / edge_count_;
+    }
+
+    void CompressedDirectedGraph::output_compression_stats(std::ostream &out) const {
+        out << "nodes: " << node_count_ << '\n'
+            << "edges: " << edge_count_ << '\n'
+            << "successor bytes: " << successor_lists_.data_bytes() << '\n'
+            << "predecessor bytes: " << predecessor_lists_.data_bytes() << '\n'
+            << "offset bytes: "
+            << (unsigned long)(successor_lists_.offsets.size() + predecessor_lists_.offsets.size()) *
+               sizeof(unsigned long long) << '\n'
+            << "bytes per edge: " << bytes_per_edge() << '\n';
+    }
+
+}
@@ -0,0 +1,97 @@
+#ifndef DIRECTEDGRAPHHANDLER_COMPRESSED_DIRECTED_GRAPH_H
+#define DIRECTEDGRAPHHANDLER_COMPRESSED_DIRECTED_GRAPH_H
+
+#include <iostream>
+#include "util_vector.h"
+#include "util_stack.h"
+#include "directed_graph.h"
+#include "directed_graph_exceptions.h"
+
+namespace dgraph {
+
+    //iterates over one compressed adjacency list, decoding the ids on the fly
+    //each list is sorted and stored as LEB128 varints: the first id as is,
+    //then every following id as the gap to the previous one minus 1
+    class AdjacencyCursor {
+      public:
+        AdjacencyCursor();
+        AdjacencyCursor(const unsigned char* position, const unsigned char* end);
+
+        bool has_next() const;
+        int next();
+
+        //number of ids left in the list (counted without decoding them)
+        int remaining() const;
+      private:
+        const unsigned char* position_;
+        const unsigned char* end_;
+        int last_id_;
+    };
+
+    //read-only graph that keeps both the successor and the predecessor lists
+    //delta-encoded in byte arrays indexed by per-node offsets (compressed sparse
+    //row layout); a sparse graph needs a few bytes per edge instead of the two
+    //ids per edge stored by DirectedGraph.
+    //the offsets are 64-bit and the bytes of each direction are split into chunks
+    //that each fit in a util::Vector, so the encoding may exceed 4 GiB; a single
+    //list that does not fit in one chunk throws bad_dgraph_config
+    class CompressedDirectedGraph {
+      public:
+        CompressedDirectedGraph();
+        explicit CompressedDirectedGraph(const DirectedGraph& graph);
+        CompressedDirectedGraph(const CompressedDirectedGraph& rhs);
+        CompressedDirectedGraph& operator = (const CompressedDirectedGraph& rhs);
+        virtual ~CompressedDirectedGraph();
+
+        //reads a graph in the same format as DirectedGraph, without ever building its Nodes
+        friend std::istream& operator >> (std::istream& in, CompressedDirectedGraph& graph);
+        friend std::ostream& operator << (std::ostream& out, const CompressedDirectedGraph& graph);
+
+        int node_count() const;
+        long long edge_count() const;
+
+        AdjacencyCursor successors(int id) const;
+        AdjacencyCursor predecessors(int id) const;
+
+        int get_in_degree(int id) const;
+        int get_out_degree(int id) const;
+
+        //the algorithms below match the ones from DirectedGraph, but report node ids
+        util::Vector< int > breadth_first_search(int source_id = 0) const;
+        util::Vector< int > depth_first_search(int source_id = 0) const;
+        util::Vector< util::Vector< int > > get_strongly_connected_components() const;
+        bool is_acyclic() const;
+        util::Vector< int > topological_sort() const;
+
+        //total number of bytes used by the encoded lists and their offsets
+        unsigned long memory_bytes() const;
+        //the above divided by the number of edges
+        double bytes_per_edge() const;
+        void output_compression_stats(std::ostream& out) const;
+
+      private:
+        //the lists of one direction: the list of a node spans [offsets[id], offsets[id + 1]) of the
+        //chunks laid end to end, chunk k starting at chunk_starts[k]; no list crosses two chunks
+        struct EncodedLists {
+            EncodedLists() : offsets(1, 0) {}
+
+            AdjacencyCursor cursor(int id) const;
+            unsigned long long data_bytes() const;
+            unsigned long memory_bytes() const;
+
+            util::Vector< unsigned long long > offsets;
+            util::Vector< util::Vector< unsigned char > > chunks;
+            util::Vector< unsigned long long > chunk_starts;
+        };
+
+        int node_count_;
+        long long edge_count_;
+        EncodedLists successor_lists_, predecessor_lists_;
+
+        //encodes the edges, which must be sorted by (from, to), into lists
+        static void encode(int node_count, const util::Vector< Edge >& edges, EncodedLists& lists);
+        void build(int node_count, util::Vector< Edge >& edges);
+    };
+}
+
+#endif //DIRECTEDGRAPHHANDLER_COMPRESSED_DIRECTED_GRAPH_H
@@ -0,0 +1,413 @@
+#ifndef DIRECTEDGRAPHHANDLER_CRITICAL_PATH_H
+#define DIRECTEDGRAPHHANDLER_CRITICAL_PATH_H
+
+#include <algorithm>
+#include <utility>
+#include "util_stack.h"
+#include "util_vector.h"
+#include "util_dary_heap.h"
+#include "util_trace.h"
+#include "directed_graph.h"
+#include "graph_views.h"
+
+namespace dgraph {
+
+    //longest paths of an acyclic graph whose nodes are tasks with a cost, where a task starts once
+    //all of its predecessors are done. For every node it keeps the longest path ending just before
+    //it (its earliest start) and the longest path starting with it (its tail), along with a
+    //topological position; the latest start and the slack follow from the tail and the makespan.
+    //the engine works on graphs and on views, keeping them as views keep their operands: a graph
+    //is referenced and must outlive the engine, a view is copied. After add_new_node calls,
+    //update takes the new nodes in: the starts and tails that grow are propagated in topological
+    //order, so it costs about the nodes whose values change, plus, for a node with both
+    //predecessors and successors, the reordering of the positions between them (Pearce-Kelly).
+    //deletions need a new engine
+    template<typename Graph = DirectedGraph, typename CostType = double>
+    class CriticalPathEngine {
+      public:
+        typedef typename Graph::id_type IdType;
+
+        //costs holds the cost of every node, or is NULL for unit costs; throws bad_top_sort if the
+        //graph has cycles and bad_dgraph_config for costs of the wrong size or a negative cost
+        explicit CriticalPathEngine(const Graph& graph, const util::Vector< CostType >* costs = NULL);
+        virtual ~CriticalPathEngine();
+
+        //method that takes in the nodes added to the graph since the last update, with the given
+        //costs in id order, or unit costs; throws bad_dgraph_config as the constructor, and
+        //bad_top_sort if a new node closes a cycle, in which case the nodes before it are kept
+        void update(const util::Vector< CostType >* new_costs = NULL);
+
+        //number of node ids taken in so far
+        IdType node_count() const;
+        //the length of the longest path, at which every task is done
+        CostType makespan() const;
+
+        //the values of deleted nodes are 0
+        const CostType& cost(IdType id) const;
+        const CostType& earliest_start(IdType id) const;
+        //the latest start that does not delay the makespan
+        CostType latest_start(IdType id) const;
+        CostType slack(IdType id) const;
+        const util::Vector< CostType >& earliest_starts() const;
+
+        //returns the ids on a longest path, from a node without predecessors to one without successors
+        util::Vector< IdType > critical_path() const;
+      private:
+        CriticalPathEngine(const CriticalPathEngine& rhs);
+        CriticalPathEngine& operator = (const CriticalPathEngine& rhs);
+
+        //the neighbors of a node that were taken in, through edges that are not deleted
+        void live_successors(IdType id, util::Vector< IdType >& res) const;
+        void live_predecessors(IdType id, util::Vector< IdType >& res) const;
+        CostType checked_cost(const util::Vector< CostType >* costs, util::size_t index) const;
+        //moves the nodes between the positions of to_id and from_id so that the edge from_id -> to_id
+        //goes forward; throws bad_top_sort if to_id reaches from_id
+        void reorder(IdType from_id, IdType to_id);
+        //raises the starts of the successors of the given nodes, and on, in topological order
+        void propagate_starts(const util::Vector< IdType >& sources);
+        //raises the tails of the predecessors of the given nodes, and on, in reverse topological order
+        void propagate_tails(const util::Vector< IdType >& sinks);
+        void raise_tail(IdType id, const CostType& tail);
+
+        typename detail::ViewOperand< Graph >::type graph_;
+        IdType node_count_;
+        util::Vector< CostType > costs_, starts_, tails_;
+        //an order of the nodes in which every edge goes forward; positions are not contiguous,
+        //since nodes are prepended below the smallest and appended above the largest
+        util::Vector< long long > positions_;
+        long long min_position_, max_position_;
+        CostType makespan_;
+        //a node with the longest tail, IdType(-1) for a graph without live nodes
+        IdType critical_start_;
+        //scratch marks of the reordering, cleared after every use
+        util::Vector< char > marks_;
+    };
+
+    //implementation of CriticalPathEngine's methods
+    template<typename Graph, typename CostType>
+    CriticalPathEngine<Graph, CostType>::CriticalPathEngine(const Graph& graph, const util::Vector< CostType >* costs) :
+            graph_(graph), node_count_(graph.node_count()), costs_(node_count_, CostType()),
+            starts_(node_count_, CostType()), tails_(node_count_, CostType()), positions_(node_count_, 0),
+            min_position_(0), max_position_(-1), makespan_(CostType()), critical_start_(IdType(-1)),
+            marks_(node_count_, 0) {
+        if (costs != NULL && costs->size() != (util::size_t)node_count_)
+            throw bad_dgraph_config();
+        DGRAPH_TRACE_SCOPE("critical_path");
+        for (IdType i = 0; i < node_count_; ++i)
+            if (!graph_.is_node_deleted(i))
+                costs_[i] = checked_cost(costs, i);
+
+        //Kahn's algorithm, which fixes the start of every node as it is taken out; the tails
+        //are then filled in the reverse of that order. Every node is in range here, so the
+        //lists are read directly
+        util::Vector< IdType > in_degree(node_count_, 0), order;
+        IdType live_count = 0;
+        for (IdType i = 0; i < node_count_; ++i) {
+            if (graph_.is_node_deleted(i))
+                continue;
+            live_count++;
+            const util::Vector< IdType >& successors = detail::successor_list(graph_, i);
+            for (util::size_t j = 0; j < successors.size(); ++j)
+                if (!graph_.is_edge_deleted(i, successors[j]))
+                    in_degree[successors[j]]++;
+        }
+        for (IdType i = 0; i < node_count_; ++i)
+            if (in_degree[i] == 0 && !graph_.is_node_deleted(i))
+                order.push_back(i);
+        for (util::size_t k = 0; k < order.size(); ++k) {
+            IdType id = order[k];
+            positions_[id] = (long long)k;
+            CostType finish = starts_[id] + costs_[id];
+            const util::Vector< IdType >& successors = detail::successor_list(graph_, id);
+            for (util::size_t j = 0; j < successors.size(); ++j) {
+                IdType next_id = successors[j];
+                if (graph_.is_edge_deleted(id, next_id))
+                    continue;
+                starts_[next_id] = std::max(starts_[next_id], finish);
+                if (--in_degree[next_id] == 0)
+                    order.push_back(next_id);
+            }
+        }
+        if (order.size() != (util::size_t)live_count)
+            throw bad_top_sort();
+        max_position_ = (long long)order.size() - 1;
+
+        for (util::size_t k = order.size(); k-- > 0; ) {
+            IdType id = order[k];
+            CostType longest = CostType();
+            const util::Vector< IdType >& successors = detail::successor_list(graph_, id);
+            for (util::size_t j = 0; j < successors.size(); ++j)
+                if (!graph_.is_edge_deleted(id, successors[j]))
+                    longest = std::max(longest, tails_[successors[j]]);
+            raise_tail(id, costs_[id] + longest);
+        }
+    }
+
+    template<typename Graph, typename CostType>
+    CriticalPathEngine<Graph, CostType>::~CriticalPathEngine() {}
+
+    template<typename Graph, typename CostType>
+    void CriticalPathEngine<Graph, CostType>::update(const util::Vector< CostType >* new_costs) {
+        IdType first_new = node_count_;
+        if (new_costs != NULL && new_costs->size() != (util::size_t)(graph_.node_count() - first_new))
+            throw bad_dgraph_config();
+        DGRAPH_TRACE_SCOPE("critical_path/update");
+        util::Vector< IdType > predecessors, successors;
+        for (IdType id = first_new; id < graph_.node_count(); ++id) {
+            //the values of the new node come from neighbors whose values are final: its predecessors
+            //cannot be reached from it and its successors cannot reach it
+            CostType cost = (graph_.is_node_deleted(id) ? CostType() : checked_cost(new_costs, id - first_new));
+            costs_.push_back(cost);
+            starts_.push_back(CostType());
+            tails_.push_back(CostType());
+            positions_.push_back(0);
+            marks_.push_back(0);
+            node_count_++;
+            if (graph_.is_node_deleted(id))
+                continue;
+            live_predecessors(id, predecessors);
+            live_successors(id, successors);
+
+            //a node without successors goes last and one without predecessors goes first, as is;
+            //otherwise it goes last and the successors before it are moved after it
+            if (successors.empty() || !predecessors.empty()) {
+                positions_[id] = ++max_position_;
+                try {
+                    for (util::size_t k = 0; k < successors.size(); ++k)
+                        if (positions_[successors[k]] < positions_[id])
+                            reorder(id, successors[k]);
+                }
+                catch (...) {
+                    //the positions moved so far are still an order of the nodes kept
+                    costs_.pop_back();
+                    starts_.pop_back();
+                    tails_.pop_back();
+                    positions_.pop_back();
+                    marks_.pop_back();
+                    node_count_--;
+                    throw;
+                }
+            }
+            else
+                positions_[id] = --min_position_;
+
+            for (util::size_t k = 0; k < predecessors.size(); ++k)
+                starts_[id] = std::max(starts_[id], starts_[predecessors[k]] + costs_[predecessors[k]]);
+            CostType longest = CostType();
+            for (util::size_t k = 0; k < successors.size(); ++k)
+                longest = std::max(longest, tails_[successors[k]]);
+            raise_tail(id, cost + longest);
+
+            util::Vector< IdType > self(1, id);
+            propagate_starts(self);
+            propagate_tails(self);
+        }
+    }
+
+    template<typename Graph, typename CostType>
+    typename CriticalPathEngine<Graph, CostType>::IdType CriticalPathEngine<Graph, CostType>::node_count() const {
+        return node_count_;
+    }
+
+    template<typename Graph, typename CostType>
+    CostType CriticalPathEngine<Graph, CostType>::makespan() const {
+        return makespan_;
+    }
+
+    template<typename Graph, typename CostType>
+    const CostType& CriticalPathEngine<Graph, CostType>::cost(IdType id) const {
+        return costs_[id];
+    }
+
+    template<typename Graph, typename CostType>
+    const CostType& CriticalPathEngine<Graph, CostType>::earliest_start(IdType id) const {
+        return starts_[id];
+    }
+
+    template<typename Graph, typename CostType>
+    CostType CriticalPathEngine<Graph, CostType>::latest_start(IdType id) const {
+        return (graph_.is_node_deleted(id) ? CostType() : makespan_ - tails_[id]);
+    }
+
+    template<typename Graph, typename CostType>
+    CostType CriticalPathEngine<Graph, CostType>::slack(IdType id) const {
+        return (graph_.is_node_deleted(id) ? CostType() : makespan_ - tails_[id] - starts_[id]);
+    }
+
+    template<typename Graph, typename CostType>
+    const util::Vector< CostType >& CriticalPathEngine<Graph, CostType>::earliest_starts() const {
+        return starts_;
+    }
+
+    template<typename Graph, typename CostType>
+    util::Vector< typename CriticalPathEngine<Graph, CostType>::IdType >
+    CriticalPathEngine<Graph, CostType>::critical_path() const {
+        //the predecessors of a node with the longest tail have it too, since the costs are not
+        //negative; from the first of them, every step takes the successor with the longest tail
+        util::Vector< IdType > res, successors, predecessors;
+        IdType first_id = critical_start_;
+        if (first_id != IdType(-1))
+            for (live_predecessors(first_id, predecessors); !predecessors.empty(); live_predecessors(first_id, predecessors))
+                first_id = predecessors[0];
+        for (IdType id = first_id; id != IdType(-1); ) {
+            res.push_back(id);
+            live_successors(id, successors);
+            IdType next_id = IdType(-1);
+            for (util::size_t k = 0; k < successors.size(); ++k)
+                if (next_id == IdType(-1) || tails_[successors[k]] > tails_[next_id])
+                    next_id = successors[k];
+            id = next_id;
+        }
+        return res;
+    }
+
+    template<typename Graph, typename CostType>
+    void CriticalPathEngine<Graph, CostType>::live_successors(IdType id, util::Vector< IdType >& res) const {
+        res.clear();
+        const util::Vector< IdType >& successors = detail::successor_list(graph_, id);
+        for (util::size_t k = 0; k < successors.size(); ++k)
+            if (successors[k] < node_count_ && !graph_.is_edge_deleted(id, successors[k]))
+                res.push_back(successors[k]);
+    }
+
+    template<typename Graph, typename CostType>
+    void CriticalPathEngine<Graph, CostType>::live_predecessors(IdType id, util::Vector< IdType >& res) const {
+        res.clear();
+        const util::Vector< IdType >& predecessors = detail::predecessor_list(graph_, id);
+        for (util::size_t k = 0; k < predecessors.size(); ++k)
+            if (predecessors[k] < node_count_ && !graph_.is_edge_deleted(predecessors[k], id))
+                res.push_back(predecessors[k]);
+    }
+
+    template<typename Graph, typename CostType>
+    CostType CriticalPathEngine<Graph, CostType>::checked_cost(const util::Vector< CostType >* costs,
+                                                               util::size_t index) const {
+        if (costs == NULL)
+            return CostType(1);
+        if ((*costs)[index] < CostType())
+            throw bad_dgraph_config();
+        return (*costs)[index];
+    }
+
+    template<typename Graph, typename CostType>
+    void CriticalPathEngine<Graph, CostType>::reorder(IdType from_id, IdType to_id) {
+        //the nodes reachable from to_id that are placed before from_id, and the nodes that reach
+        //from_id placed after to_id; only they can be out of order once the edge is added
+        long long lower = positions_[to_id], upper = positions_[from_id];
+        util::Vector< IdType > forward, backward, neighbors;
+        util::Stack< IdType > stack;
+        marks_[to_id] = 1;
+        stack.push(to_id);
+        while (!stack.empty()) {
+            IdType id = stack.top();
+            stack.pop();
+            forward.push_back(id);
+            live_successors(id, neighbors);
+            for (util::size_t k = 0; k < neighbors.size(); ++k) {
+                IdType next_id = neighbors[k];
+                if (next_id == from_id) {
+                    for (util::size_t j = 0; j < forward.size(); ++j)
+                        marks_[forward[j]] = 0;
+                    while (!stack.empty()) {
+                        marks_[stack.top()] = 0;
+                        stack.pop();
+                    }
+                    throw bad_top_sort();
+                }
+                if (!marks_[next_id] && positions_[next_id] < upper) {
+                    marks_[next_id] = 1;
+                    stack.push(next_id);
+                }
+            }
+        }
+        marks_[from_id] = 2;
+        stack.push(from_id);
+        while (!stack.empty()) {
+            IdType id = stack.top();
+            stack.pop();
+            backward.push_back(id);
+            live_predecessors(id, neighbors);
+            for (util::size_t k = 0; k < neighbors.size(); ++k)
+                if (!marks_[neighbors[k]] && positions_[neighbors[k]] > lower) {
+                    marks_[neighbors[k]] = 2;
+                    stack.push(neighbors[k]);
+                }
+        }
+
+        //the backward nodes take the smallest of the positions they share with the forward ones,
+        //each group keeping its own order
+        util::Vector< long long > pool;
+        const util::Vector< long long >& positions = positions_;
+        struct ByPosition {
+            const util::Vector< long long >& positions;
+            bool operator () (IdType a, IdType b) const { return positions[a] < positions[b]; }
+        } by_position = { positions };
+        std::sort(backward.begin(), backward.end(), by_position);
+        std::sort(forward.begin(), forward.end(), by_position);
+        for (util::size_t k = 0; k < backward.size(); ++k)
+            pool.push_back(positions_[backward[k]]);
+        for (util::size_t k = 0; k < forward.size(); ++k)
+            pool.push_back(positions_[forward[k]]);
+        std::sort(pool.begin(), pool.end());
+        for (util::size_t k = 0; k < backward.size(); ++k) {
+            positions_[backward[k]] = pool[k];
+            marks_[backward[k]] = 0;
+        }
+        for (util::size_t k = 0; k < forward.size(); ++k) {
+            positions_[forward[k]] = pool[backward.size() + k];
+            marks_[forward[k]] = 0;
+        }
+    }
+
+    template<typename Graph, typename CostType>
+    void CriticalPathEngine<Graph, CostType>::propagate_starts(const util::Vector< IdType >& sources) {
+        //a node is taken out after all of its predecessors that could still raise its start
+        util::DaryHeap< long long, IdType > heap;
+        util::Vector< IdType > successors;
+        for (util::size_t k = 0; k < sources.size(); ++k)
+            heap.push(positions_[sources[k]], sources[k]);
+        while (!heap.empty()) {
+            IdType id = heap.top().second;
+            heap.pop();
+            live_successors(id, successors);
+            CostType finish = starts_[id] + costs_[id];
+            for (util::size_t k = 0; k < successors.size(); ++k)
+                if (starts_[successors[k]] < finish) {
+                    starts_[successors[k]] = finish;
+                    heap.push(positions_[successors[k]], successors[k]);
+                }
+        }
+    }
+
+    template<typename Graph, typename CostType>
+    void CriticalPathEngine<Graph, CostType>::propagate_tails(const util::Vector< IdType >& sinks) {
+        //the keys are negated, so the heap gives the last position first
+        util::DaryHeap< long long, IdType > heap;
+        util::Vector< IdType > predecessors;
+        for (util::size_t k = 0; k < sinks.size(); ++k)
+            heap.push(-positions_[sinks[k]], sinks[k]);
+        while (!heap.empty()) {
+            IdType id = heap.top().second;
+            heap.pop();
+            live_predecessors(id, predecessors);
+            for (util::size_t k = 0; k < predecessors.size(); ++k) {
+                IdType previous_id = predecessors[k];
+                if (tails_[previous_id] < costs_[previous_id] + tails_[id]) {
+                    raise_tail(previous_id, costs_[previous_id] + tails_[id]);
+                    heap.push(-positions_[previous_id], previous_id);
+                }
+            }
+        }
+    }
+
+    template<typename Graph, typename CostType>
+    void CriticalPathEngine<Graph, CostType>::raise_tail(IdType id, const CostType& tail) {
+        tails_[id] = tail;
+        if (critical_start_ == IdType(-1) || makespan_ < tail) {
+            makespan_ = tail;
+            critical_start_ = id;
+        }
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_CRITICAL_PATH_H
@@ -0,0 +1,164 @@
+#ifndef DIRECTEDGRAPHHANDLER_DELTA_OVERLAY_H
+#define DIRECTEDGRAPHHANDLER_DELTA_OVERLAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "util_vector.h"
+#include "util_hash_set.h"
+
+namespace dgraph {
+
+    //deletions recorded on top of the adjacency lists of a graph, so that removing an edge
+    //does not have to shift the lists: a deleted edge stays in both lists as a tombstone,
+    //which the traversals skip, until the graph is compacted
+    //the per-node vectors are only allocated by the first deletion, so a graph that never
+    //deletes anything pays a size check per lookup and no memory
+    template<typename IdType>
+    class DeltaOverlay {
+      public:
+        DeltaOverlay();
+        DeltaOverlay(const DeltaOverlay& rhs);
+        DeltaOverlay& operator = (const DeltaOverlay& rhs);
+        virtual ~DeltaOverlay();
+
+        //number of edge tombstones that are still stored in the adjacency lists
+        util::size_t deleted_edge_count() const;
+        IdType deleted_node_count() const;
+
+        bool is_edge_deleted(IdType from, IdType to) const;
+        bool is_node_deleted(IdType id) const;
+
+        //number of tombstones in the successor and predecessor lists of a node
+        IdType deleted_successor_count(IdType id) const;
+        IdType deleted_predecessor_count(IdType id) const;
+
+        //record a deletion; the caller checks that the edge or node exists and is not deleted yet
+        void delete_edge(IdType from, IdType to);
+        void delete_node(IdType id);
+
+        //forgets the edge tombstones, once they were removed from the adjacency lists;
+        //deleted nodes stay deleted, since their ids are never reused
+        void clear_edges();
+        //forgets every deletion
+        void clear();
+
+        //number of bytes held by the overlay
+        std::size_t memory_bytes() const;
+      private:
+        util::HashSet< std::pair<IdType, IdType> > deleted_edges_;
+        util::Vector< IdType > deleted_successors_, deleted_predecessors_;
+        util::Vector< bool > deleted_nodes_;
+        IdType deleted_node_count_;
+
+        //grows a per-node vector so that it covers id
+        template<typename T>
+        static void cover(util::Vector< T >& values, IdType id, const T& value);
+    };
+
+    template<typename IdType>
+    DeltaOverlay<IdType>::DeltaOverlay() : deleted_node_count_(0) {}
+
+    template<typename IdType>
+    DeltaOverlay<IdType>::DeltaOverlay(const DeltaOverlay &rhs) :
+            deleted_edges_(rhs.deleted_edges_),
+            deleted_successors_(rhs.deleted_successors_), deleted_predecessors_(rhs.deleted_predecessors_),
+            deleted_nodes_(rhs.deleted_nodes_), deleted_node_count_(rhs.deleted_node_count_) {}
+
+    template<typename IdType>
+    DeltaOverlay<IdType>& DeltaOverlay<IdType>::operator=(const DeltaOverlay &rhs) {
+        deleted_edges_ = rhs.deleted_edges_;
+        deleted_successors_ = rhs.deleted_successors_;
+        deleted_predecessors_ = rhs.deleted_predecessors_;
+        deleted_nodes_ = rhs.deleted_nodes_;
+        deleted_node_count_ = rhs.deleted_node_count_;
+        return (*this);
+    }
+
+    template<typename IdType>
+    DeltaOverlay<IdType>::~DeltaOverlay() {}
+
+    template<typename IdType>
+    util::size_t DeltaOverlay<IdType>::deleted_edge_count() const {
+        return deleted_edges_.size();
+    }
+
+    template<typename IdType>
+    IdType DeltaOverlay<IdType>::deleted_node_count() const {
+        return deleted_node_count_;
+    }
+
+    template<typename IdType>
+    bool DeltaOverlay<IdType>::is_edge_deleted(IdType from, IdType to) const {
+        //the counter of the source filters out almost every lookup before the hash set is probed
+        if (from >= (IdType)deleted_successors_.size() || deleted_successors_[from] == 0)
+            return false;
+        return deleted_edges_.contains(std::make_pair(from, to));
+    }
+
+    template<typename IdType>
+    bool DeltaOverlay<IdType>::is_node_deleted(IdType id) const {
+        return id < (IdType)deleted_nodes_.size() && deleted_nodes_[id];
+    }
+
+    template<typename IdType>
+    IdType DeltaOverlay<IdType>::deleted_successor_count(IdType id) const {
+        return (id < (IdType)deleted_successors_.size() ? deleted_successors_[id] : 0);
+    }
+
+    template<typename IdType>
+    IdType DeltaOverlay<IdType>::deleted_predecessor_count(IdType id) const {
+        return (id < (IdType)deleted_predecessors_.size() ? deleted_predecessors_[id] : 0);
+    }
+
+    template<typename IdType>
+    void DeltaOverlay<IdType>::delete_edge(IdType from, IdType to) {
+        deleted_edges_.insert(std::make_pair(from, to));
+        cover(deleted_successors_, from, (IdType)0);
+        cover(deleted_predecessors_, to, (IdType)0);
+        deleted_successors_[from]++;
+        deleted_predecessors_[to]++;
+    }
+
+    template<typename IdType>
+    void DeltaOverlay<IdType>::delete_node(IdType id) {
+        cover(deleted_nodes_, id, false);
+        deleted_nodes_[id] = true;
+        deleted_node_count_++;
+    }
+
+    template<typename IdType>
+    void DeltaOverlay<IdType>::clear_edges() {
+        deleted_edges_.clear();
+        deleted_successors_.clear();
+        deleted_predecessors_.clear();
+    }
+
+    template<typename IdType>
+    void DeltaOverlay<IdType>::clear() {
+        clear_edges();
+        deleted_nodes_.clear();
+        deleted_node_count_ = 0;
+    }
+
+    template<typename IdType>
+    std::size_t DeltaOverlay<IdType>::memory_bytes() const {
+        return deleted_edges_.memory_bytes() +
+               (deleted_successors_.capacity() + deleted_predecessors_.capacity()) * sizeof(IdType) +
+               deleted_nodes_.capacity() * sizeof(bool);
+    }
+
+    template<typename IdType>
+    template<typename T>
+    void DeltaOverlay<IdType>::cover(util::Vector<T> &values, IdType id, const T &value) {
+        //doubling keeps the growth amortized O(1) when the graph gets new nodes
+        if (id < (IdType)values.size())
+            return;
+        if ((util::size_t)id >= values.capacity())
+            values.reserve(std::max((util::size_t)id + 1, 2 * values.capacity()));
+        while (id >= (IdType)values.size())
+            values.push_back(value);
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_DELTA_OVERLAY_H
@@ -7,68 +7,271 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
 #include "util_stack.h"
 #include "util_queue.h"
 #include "util_vector.h"
+#include "util_dary_heap.h"
+#include "util_radix_heap.h"
+#include "util_thread_pool.h"
+#include "util_binary_io.h"
+#include "shortest_path_tree.h"
+#include "dominator_tree.h"
+#include "delta_overlay.h"
+#include "async_operation.h"
 #include "directed_graph_exceptions.h"
 
 namespace dgraph {
-    class Node {
+
+    //payload type of graphs whose edges carry no data
+    //it is only ever stored as an empty base, so it takes no space in Nodes and Edges
+    struct NoPayload {};
+
+    //reading and writing of an edge payload, which follows the two ids of the edge in the text format
+    //the binary format stores the payload as raw bytes, so there it must be trivially copyable
+    template<typename PayloadType>
+    struct PayloadTraits {
+        static bool read(std::istream& in, PayloadType& payload) { return !(in >> payload).fail(); }
+        static void write(std::ostream& out, const PayloadType& payload) { out << ' ' << payload; }
+        static bool read_binary(util::BinaryReader& in, PayloadType& payload) { return in.get(payload); }
+        static void write_binary(util::BinaryWriter& out, const PayloadType& payload) { out.put(payload); }
+    };
+
+    template<>
+    struct PayloadTraits<NoPayload> {
+        static bool read(std::istream&, NoPayload&) { return true; }
+        static void write(std::ostream&, const NoPayload&) {}
+        static bool read_binary(util::BinaryReader&, NoPayload&) { return true; }
+        static void write_binary(util::BinaryWriter&, const NoPayload&) {}
+    };
+
+    //storage for the payload of a single edge
+    template<typename PayloadType>
+    class PayloadHolder {
       public:
-        explicit Node(int id = -1);
-        virtual ~Node();
+        explicit PayloadHolder(const PayloadType& payload) : payload_(payload) {}
+        const PayloadType& get_payload() const { return payload_; }
+      private:
+        PayloadType payload_;
+    };
 
-        int get_id() const;
-        void set_id(int id);
+    template<>
+    class PayloadHolder<NoPayload> : private NoPayload {
+      public:
+        explicit PayloadHolder(const NoPayload&) {}
+        const NoPayload& get_payload() const { return (*this); }
+    };
+
+    //storage for the payloads of the outgoing edges of a node, parallel to its successor list
+    template<typename PayloadType>
+    class PayloadList {
+      public:
+        void push_back(const PayloadType& payload) { payloads_.push_back(payload); }
+        const PayloadType& get_payload(util::size_t index) const { return payloads_[index]; }
+        const util::Vector< PayloadType >& get_payloads() const { return payloads_; }
+        std::size_t payload_bytes() const { return payloads_.capacity() * sizeof(PayloadType); }
+        void retain(const util::Vector< bool >& keep, util::size_t kept_count) {
+            util::Vector< PayloadType > kept;
+            kept.reserve(kept_count);
+            for (util::size_t k = 0; k < payloads_.size(); ++k)
+                if (keep[k])
+                    kept.push_back(payloads_[k]);
+            payloads_ = kept;
+        }
+      private:
+        util::Vector< PayloadType > payloads_;
+    };
 
-        void add_direct_successor(Node* node);
-        void add_direct_predecessor(Node* node);
+    template<>
+    class PayloadList<NoPayload> : private NoPayload {
+      public:
+        void push_back(const NoPayload&) {}
+        const NoPayload& get_payload(util::size_t) const { return (*this); }
+        std::size_t payload_bytes() const { return 0; }
+        void retain(const util::Vector< bool >&, util::size_t) {}
+    };
 
-        const util::Vector< Node* >& get_direct_successors() const;
-        const util::Vector< Node* >& get_direct_predecessors() const;
+    //a node only stores the ids of its neighbors, so the width of IdType decides the size
+    //of every adjacency list; the destructor is not virtual to keep a vptr out of each node
+    template<typename IdType = int, typename PayloadType = NoPayload>
+    class BasicNode : private PayloadList< PayloadType > {
+      public:
+        explicit BasicNode(IdType id = IdType(-1));
+        ~BasicNode();
 
-        int get_in_degree() const;
-        int get_out_degree() const;
+        IdType get_id() const;
+        void set_id(IdType id);
 
-        bool operator == (const Node& rhs) const;
-        bool operator != (const Node& rhs) const;
-        bool operator < (const Node& rhs) const;
+        void add_direct_successor(IdType id, const PayloadType& payload = PayloadType());
+        void add_direct_predecessor(IdType id);
+
+        const util::Vector< IdType >& get_direct_successors() const;
+        const util::Vector< IdType >& get_direct_predecessors() const;
+
+        //payload of the edge towards get_direct_successors()[index]
+        const PayloadType& get_successor_payload(util::size_t index) const;
+        //payloads of all outgoing edges, in the order of get_direct_successors()
+        //(only available when the graph has a payload)
+        const util::Vector< PayloadType >& get_successor_payloads() const;
+        //bytes held by the payload list (0 without a payload)
+        std::size_t get_payload_bytes() const;
+
+        IdType get_in_degree() const;
+        IdType get_out_degree() const;
+
+        //keep only the neighbors whose flag in keep is set, in tightly sized storage;
+        //used by the graph to drop deleted edges when it compacts
+        void retain_direct_successors(const util::Vector< bool >& keep);
+        void retain_direct_predecessors(const util::Vector< bool >& keep);
+
+        bool operator == (const BasicNode& rhs) const;
+        bool operator != (const BasicNode& rhs) const;
+        bool operator < (const BasicNode& rhs) const;
       private:
-        Node(const Node& rhs);
-        Node& operator = (const Node& rhs);
+        BasicNode(const BasicNode& rhs);
+        BasicNode& operator = (const BasicNode& rhs);
+
+        IdType id_;
+        util::Vector< IdType > direct_successors_;
+        util::Vector< IdType > direct_predecessors_;
 
-        int id_;
-        util::Vector< Node* > direct_successors_;
-        util::Vector< Node* > direct_predecessors_;
+        //copies the flagged ids of list into a new Vector of exactly the kept size
+        static util::size_t retain_ids(util::Vector< IdType >& list, const util::Vector< bool >& keep);
     };
 
-    class Edge {
+    //without a payload an edge is exactly two ids
+    template<typename IdType = int, typename PayloadType = NoPayload>
+    class BasicEdge : private PayloadHolder< PayloadType > {
       public:
-        explicit Edge(int from_node_id = -1, int to_node_id = -1);
-        Edge(const Edge& rhs);
-        Edge& operator = (const Edge& rhs);
-        virtual ~Edge();
+        explicit BasicEdge(IdType from_node_id = IdType(-1), IdType to_node_id = IdType(-1),
+                           const PayloadType& payload = PayloadType());
+        BasicEdge(const BasicEdge& rhs);
+        BasicEdge& operator = (const BasicEdge& rhs);
+        ~BasicEdge();
 
-        int from_node_id() const;
-        int to_node_id() const;
+        IdType from_node_id() const;
+        IdType to_node_id() const;
+        const PayloadType& payload() const;
 
-        bool operator == (const Edge& rhs) const;
-        bool operator != (const Edge& rhs) const;
-        bool operator < (const Edge& rhs) const;
+        //edges are compared by their endpoints only, the payload is ignored
+        bool operator == (const BasicEdge& rhs) const;
+        bool operator != (const BasicEdge& rhs) const;
+        bool operator < (const BasicEdge& rhs) const;
       private:
-        int from_node_id_, to_node_id_;
+        IdType from_node_id_, to_node_id_;
+    };
+
+    //strategies for relabeling the nodes of a graph so that nodes which are
+    //accessed together during traversals also end up close together in memory
+    enum ReorderStrategy {
+        BFS_ORDER,              //nodes are numbered in the order a bfs reaches them
+        REVERSE_CUTHILL_MCKEE,  //bandwidth-reducing order, ignoring edge directions
+        DEGREE_SORTED           //nodes with the largest total degree come first
     };
 
-    class DirectedGraph {
+    //bijection between the original ids of the nodes and their ids after a reorder
+    class NodePermutation {
       public:
-        DirectedGraph();
-        DirectedGraph(const DirectedGraph& rhs);
-        DirectedGraph& operator = (const DirectedGraph& rhs);
-        virtual ~DirectedGraph();
+        NodePermutation();
+        //builds the permutation from the list of original ids given in their new order
+        explicit NodePermutation(const util::Vector< int >& new_to_original);
+        NodePermutation(const NodePermutation& rhs);
+        NodePermutation& operator = (const NodePermutation& rhs);
+        virtual ~NodePermutation();
+
+        int node_count() const;
+
+        int to_new_id(int original_id) const;
+        int to_original_id(int new_id) const;
+
+        //forward array: position i holds the new id of the node originally labeled i
+        const util::Vector< int >& forward() const;
+        //inverse array: position i holds the original id of the node now labeled i
+        const util::Vector< int >& inverse() const;
+
+        //translates a result expressed in new ids back to the original ids
+        template<typename NodeType>
+        util::Vector< int > to_original_ids(const util::Vector< const NodeType* >& nodes) const;
+      private:
+        util::Vector< int > forward_, inverse_;
+    };
+
+    //number of bytes held by each of the structures of a DirectedGraph
+    //(containers are accounted by capacity, i.e. by what they actually allocated)
+    struct MemoryUsage {
+        MemoryUsage();
 
-        bool operator == (const DirectedGraph& rhs) const;
-        bool operator != (const DirectedGraph& rhs) const;
-        bool operator < (const DirectedGraph& rhs) const;
+        std::size_t node_table_bytes;       //the Vector of Node pointers
+        std::size_t node_object_bytes;      //the Node objects themselves
+        std::size_t successor_list_bytes;   //the storage of every direct_successors_ list
+        std::size_t predecessor_list_bytes; //the storage of every direct_predecessors_ list
+        std::size_t payload_list_bytes;     //the storage of the edge payloads
+        std::size_t overlay_bytes;          //the tombstones of deleted edges and nodes
+
+        std::size_t total_bytes() const;
+    };
+
+    //receives every mutation of a graph right after it was applied (see GraphJournal)
+    //replacing the whole graph, by assignment, operator>> or read_binary, is not reported
+    template<typename IdType, typename PayloadType>
+    class MutationListener {
+      public:
+        virtual ~MutationListener() {}
+
+        //edges holds every edge of the new node, sorted
+        virtual void node_added(IdType id, const util::Vector< BasicEdge< IdType, PayloadType > >& edges) = 0;
+        virtual void edge_removed(IdType from, IdType to) = 0;
+        virtual void node_removed(IdType id) = 0;
+    };
+
+    template<typename IdType = int, typename OffsetType = int, typename PayloadType = NoPayload>
+    class BasicDirectedGraph;
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    std::istream& operator >> (std::istream& in, BasicDirectedGraph< IdType, OffsetType, PayloadType >& graph);
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    std::ostream& operator << (std::ostream& out, const BasicDirectedGraph< IdType, OffsetType, PayloadType >& graph);
+
+    //the graph is specialized at compile time on:
+    // -IdType: the type of the node ids, which bounds the number of nodes (e.g. unsigned short for small graphs)
+    // -OffsetType: the type used to count edges, which bounds the number of edges (e.g. long long for huge graphs);
+    //  the containers are indexed by the 32-bit util::size_t, so the nodes, the edges of one node and the
+    //  edges read by operator>> or merged by operator+ are at most 2^32 - 1 whatever the type
+    // -PayloadType: data attached to every edge, or NoPayload when the edges carry none
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    class BasicDirectedGraph {
+      public:
+        typedef IdType id_type;
+        typedef OffsetType offset_type;
+        typedef PayloadType payload_type;
+        typedef BasicNode< IdType, PayloadType > Node;
+        typedef BasicEdge< IdType, PayloadType > Edge;
+
+        BasicDirectedGraph();
+        BasicDirectedGraph(const BasicDirectedGraph& rhs);
+        BasicDirectedGraph& operator = (const BasicDirectedGraph& rhs);
+        virtual ~BasicDirectedGraph();
+
+        //structural equality: the same node ids, the same deleted nodes and the same live edges;
+        //the payloads are not compared, as for Edge. The fingerprints are compared first, so
+        //different graphs are told apart in O(1) but for a hash collision; otherwise the sorted
+        //adjacency lists are compared until the first difference
+        bool operator == (const BasicDirectedGraph& rhs) const;
+        bool operator != (const BasicDirectedGraph& rhs) const;
+        //a strict total order consistent with ==: by node count, edge count and fingerprint, then,
+        //for the rare graphs that share all three, node by node by being deleted and by the sorted
+        //live successor lists, compared lexicographically
+        bool operator < (const BasicDirectedGraph& rhs) const;
+
+        //a 64-bit hash of the node count, the deleted nodes and the live edges, shared by equal
+        //graphs whatever the order they were built in; every mutation keeps it up to date, so
+        //reading it is O(1), which makes it usable as a cache key
+        unsigned long long fingerprint() const;
 
         //Methods for reading and writing the data of the graph from and to a stream
         //The input and output must respect the same format:
@@ -76,32 +279,83 @@ namespace dgraph {
         // -each of the following M lines contains two integers between 0 and N-1 describing an edge
         //          the first number representing the source of the edge, and the second one, the destination.
         //          no two edges can be identical and there must be no self-loops.
-        friend std::istream& operator >> (std::istream& in, DirectedGraph& graph);
-        friend std::ostream& operator << (std::ostream& out, const DirectedGraph& graph);
+        // -when the graph has a payload, it follows the two ids on the line of each edge
+        //reading an input that breaks these rules throws bad_dgraph_config and leaves an empty graph
+        friend std::istream& operator >> <> (std::istream& in, BasicDirectedGraph& graph);
+        friend std::ostream& operator << <> (std::ostream& out, const BasicDirectedGraph& graph);
 
-        int node_count() const;
-        int edge_count() const;
+        //number of node ids, deleted nodes included, since ids are never reused
+        IdType node_count() const;
+        //number of nodes that were not deleted
+        IdType live_node_count() const;
+        //number of edges that were not deleted
+        OffsetType edge_count() const;
 
-        const Node* get_node_by_id(int id) const;
+        //the adjacency lists of the returned node may still hold deleted edges
+        //until the next compaction; they can be told apart with is_edge_deleted
+        const Node* get_node_by_id(IdType id) const;
+        //the edges of the new node cannot touch deleted nodes, and the edge count must still fit in
+        //OffsetType; otherwise they throw bad_dgraph_config and leave the graph unchanged
         void add_new_node(std::istream& in);
+        //the same, with the edges given directly; each of them must have the new node
+        //(whose id is node_count()) as one of its endpoints
+        void add_new_node(const util::Vector< Edge >& edges);
+
+        //Methods for saving and loading the graph in a binary format
+        //the image holds the live edges in CSR order and the deleted node ids, in the native
+        //byte order, followed by its CRC-32; loading it needs no parsing and no sorting
+        void write_binary(std::ostream& out) const;
+        //throws bad_dgraph_config for an image that is truncated, corrupted or written
+        //by a graph with different IdType, OffsetType or PayloadType, and leaves an empty graph
+        void read_binary(std::istream& in);
+
+        //the listener is told about every edge and node added or removed from now on;
+        //it is not copied along with the graph. NULL detaches it
+        void set_mutation_listener(MutationListener< IdType, PayloadType >* listener);
+        MutationListener< IdType, PayloadType >* get_mutation_listener() const;
+
+        //Methods for deleting edges and nodes
+        //a deletion only records a tombstone in an overlay, which costs O(1) amortized per edge
+        //instead of the O(N + M) of rebuilding the graph; the traversals skip the tombstones
+        //and the adjacency lists are rewritten without them once they pass the compaction threshold
+        //returns true if the edge exists and was not deleted; throws out_of_range for invalid ids
+        bool has_edge(IdType from, IdType to) const;
+        //throws out_of_range for invalid or deleted ids and bad_dgraph_config if there is no such edge
+        void remove_edge(IdType from, IdType to);
+        //deletes every edge incident to the node; the id of the node is not reused
+        //throws out_of_range for invalid or deleted ids
+        void remove_node(IdType id);
+        bool is_edge_deleted(IdType from, IdType to) const;
+        bool is_node_deleted(IdType id) const;
+        //rewrites the adjacency lists of the nodes that hold tombstones, dropping the deleted edges
+        void compact();
+        //the graph compacts itself when the tombstones exceed fraction * (N + M + tombstones),
+        //which keeps both the deletions and the traversal overhead amortized O(1)
+        //0 compacts after every deletion, a negative fraction disables automatic compaction
+        void set_compaction_threshold(double fraction);
+        double get_compaction_threshold() const;
 
         //returns a Vector containing the nodes in the order that they were accessed during the bfs
-        util::Vector< const Node* > breadth_first_search(int source_id = 0) const;
+        util::Vector< const Node* > breadth_first_search(IdType source_id = 0) const;
         //outputs the above Vector
-        void output_breadth_first_search(std::ostream& out, int source_id = 0) const;
+        void output_breadth_first_search(std::ostream& out, IdType source_id = 0) const;
 
         //returns a Vector containing the nodes in the order that they were accessed during the dfs
-        util::Vector< const Node* > depth_first_search(int source_id = 0) const;
+        util::Vector< const Node* > depth_first_search(IdType source_id = 0) const;
         //outputs the above Vector
-        void output_depth_first_search(std::ostream& out, int source_id = 0) const;
+        void output_depth_first_search(std::ostream& out, IdType source_id = 0) const;
+
+        //the heavy algorithms take an optional OperationMonitor, which they report their progress to
+        //and which they check in their inner loops; they throw operation_cancelled once it is cancelled
 
         //returns a matrix where (i, j) is true iff there is a path from i to j
-        util::Vector< util::Vector< bool > > get_path_matrix() const;
+        //the progress is counted in intermediate nodes of Roy-Floyd
+        util::Vector< util::Vector< bool > > get_path_matrix(OperationMonitor* monitor = NULL) const;
         //outputs the above matrix
         void output_path_matrix(std::ostream& out) const;
 
-        //returns the list of scc as lists of Nodes
-        util::Vector< util::Vector< const Node* > > get_strongly_connected_components() const;
+        //returns the list of scc as lists of Nodes; the progress is counted in nodes
+        util::Vector< util::Vector< const Node* > > get_strongly_connected_components(OperationMonitor* monitor = NULL) const;
         //outputs the above list
         void output_strongly_connected_components(std::ostream& out) const;
 
@@ -111,30 +365,2608 @@ namespace dgraph {
         //method that returns true if the graph has no cycles
         bool is_acyclic() const;
 
+        //method that returns true if there is a path from from_id to to_id
+        //a bidirectional bfs, which stops as soon as the two searches meet
+        bool has_path(IdType from_id, IdType to_id) const;
+
         //method that returns a Vector containing the nodes in topological order
-        util::Vector< const Node* > topological_sort() const;
+        //the progress is counted in nodes
+        util::Vector< const Node* > topological_sort(OperationMonitor* monitor = NULL) const;
         //outputs the above Vector
         void output_topological_sort(std::ostream& out) const;
 
-        //does the reunion of two graphs
-        DirectedGraph operator+(const DirectedGraph& rhs) const;
+        //single-source shortest paths, using the edge payloads (which must be numeric) as weights
+        //Dijkstra's algorithm; integer weights are kept in a radix heap, other weights in a 4-ary heap
+        //throws bad_edge_weight if a reachable edge has a negative weight
+        ShortestPathTree< IdType, PayloadType > dijkstra(IdType source_id = 0) const;
+        //relaxes the edges in topological order, which takes linear time and accepts negative weights
+        //only the part of the graph reachable from the source is sorted, using the same dfs as
+        //topological_sort; throws bad_top_sort if that part has cycles
+        ShortestPathTree< IdType, PayloadType > dag_shortest_paths(IdType source_id = 0) const;
+        //the DAG algorithm when no cycle is reachable from the source, Dijkstra otherwise
+        ShortestPathTree< IdType, PayloadType > shortest_paths(IdType source_id = 0) const;
+        //outputs the distance to every node in id order, or "inf" for unreachable nodes
+        void output_shortest_paths(std::ostream& out, IdType source_id = 0) const;
+
+        //the dominators of the nodes reachable from root_id, found by Semi-NCA: the semidominators
+        //of Lengauer-Tarjan, then every immediate dominator as the nearest ancestor of the parent
+        //in the tree built so far whose preorder number is at most the semidominator's;
+        //throws out_of_range if the root is invalid or deleted
+        DominatorTree< IdType > dominator_tree(IdType root_id = 0) const;
+
+        //does the reunion of two graphs; an edge present in both keeps the payload from this graph.
+        //throws bad_dgraph_config if the edge count of the reunion does not fit in OffsetType
+        BasicDirectedGraph operator+(const BasicDirectedGraph& rhs) const;
+
+        //Parallel versions of the algorithms above; they all run on util::default_thread_pool(),
+        //whose size is set in one place, by util::set_default_thread_count or DGRAPH_THREADS
+        //returns the same Vector as breadth_first_search, expanding one level at a time
+        util::Vector< const Node* > parallel_breadth_first_search(IdType source_id = 0) const;
+        //returns the same components as get_strongly_connected_components, found by recursive
+        //forward-backward decomposition with trimming; the nodes of every component are sorted
+        //by id and the components by their smallest id
+        util::Vector< util::Vector< const Node* > > parallel_strongly_connected_components() const;
+        //returns the same matrix as get_path_matrix, with one search per row instead of Roy-Floyd
+        //the progress is counted in rows
+        util::Vector< util::Vector< bool > > parallel_path_matrix(OperationMonitor* monitor = NULL) const;
+        //returns the same graph as operator+, merging the adjacency lists of every node in parallel
+        BasicDirectedGraph parallel_union(const BasicDirectedGraph& rhs) const;
+        //returns the graph with the fewest edges that has the same paths as this one, which must be
+        //acyclic (throws bad_top_sort otherwise); the edges kept keep their payloads and
+        //removed_edge_count, when given, receives the number of edges left out.
+        //an edge (u, v) is redundant if v is a descendant of another successor of u; the descendants
+        //are kept as bitsets over the topological order, filled in reverse topological order. The
+        //bitsets are cut into slices of columns, which bound the memory and run in parallel;
+        //the progress is counted in slices
+        BasicDirectedGraph transitive_reduction(OffsetType* removed_edge_count = NULL,
+                                                OperationMonitor* monitor = NULL) const;
+        //returns an estimate of the number of nodes reachable from every node, itself included (the
+        //row sums of get_path_matrix), and 0 for deleted nodes. The estimate of a live node is kept
+        //between the size of its component and live_node_count(). Every strongly connected component
+        //gets a HyperLogLog sketch of the hashes of its nodes, to which the sketches of the components
+        //it reaches are merged in reverse topological order; the registers are cut into slices of 64,
+        //which run in parallel. The sketches take 2^p bytes per component, with the smallest p whose
+        //standard error is at most relative_error (between 2^4 and 2^16 bytes);
+        //throws bad_dgraph_config if relative_error is not positive. The progress is counted in slices
+        util::Vector< double > approximate_descendant_counts(double relative_error = 0.05,
+                                                             OperationMonitor* monitor = NULL) const;
+        //returns the PageRank of every node, 0 for deleted nodes, by power iteration: every pass pulls
+        //into each node the rank / live out-degree of its predecessors, read from flat float arrays,
+        //in parallel over ranges of nodes; the rank of the nodes without successors is spread evenly.
+        //It stops once two passes are at most tolerance apart in L1 norm, or after max_iterations.
+        //warm_start, when given, is the rank to start from, usually a previous result that misses the
+        //nodes added since; these start from 1 / N, and the whole is normalized to sum up to 1.
+        //throws bad_dgraph_config for a damping outside [0, 1), a negative tolerance or a warm start
+        //longer than node_count(). The progress is counted in passes out of max_iterations, and the
+        //passes skipped by an early stop are counted as done when it stops
+        util::Vector< float > page_rank(double damping = 0.85, double tolerance = 1e-6,
+                                        unsigned int max_iterations = 100,
+                                        const util::Vector< float >* warm_start = NULL,
+                                        OperationMonitor* monitor = NULL) const;
+
+        //Asynchronous versions of the heavy algorithms above; each one is queued on the default
+        //thread pool and returns at once a handle to wait for the result, read the progress or cancel it.
+        //the graph must stay alive and unchanged until the operation finishes
+        AsyncOperation< util::Vector< util::Vector< bool > > > async_path_matrix() const;
+        AsyncOperation< util::Vector< util::Vector< bool > > > async_parallel_path_matrix() const;
+        AsyncOperation< util::Vector< util::Vector< const Node* > > > async_strongly_connected_components() const;
+        AsyncOperation< util::Vector< const Node* > > async_topological_sort() const;
+        AsyncOperation< BasicDirectedGraph > async_transitive_reduction() const;
+
+        //computes an ordering of the nodes using the given strategy, without applying it
+        NodePermutation compute_ordering(ReorderStrategy strategy) const;
+        //relabels every node u as permutation.to_new_id(u) and rebuilds the adjacency
+        //so that nodes are allocated and their neighbor lists are sorted in the new order
+        void apply_permutation(const NodePermutation& permutation);
+        //shorthand for the two methods above; returns the permutation that was applied
+        NodePermutation reorder(ReorderStrategy strategy);
+
+        //returns the memory currently held by the graph, split by structure
+        //(the temporaries of an operation can be measured with util::PeakUsageScope)
+        MemoryUsage memory_usage() const;
+        //outputs the above breakdown
+        void output_memory_usage(std::ostream& out) const;
 
       private:
-        int node_count_, edge_count_;
+        IdType node_count_;
+        OffsetType edge_count_;
         util::Vector< Node* > nodes_;
+        DeltaOverlay< IdType > overlay_;
+        double compaction_threshold_;
+        MutationListener< IdType, PayloadType >* listener_;
+        //the sums of the hashes of the live edges and of the deleted nodes, which make up the fingerprint
+        unsigned long long edge_hash_sum_, deleted_node_hash_sum_;
 
-        void add_edge(int from, int to);
+        void add_edge(IdType from, IdType to, const PayloadType& payload);
+        //compares the live successors of a node in this graph and in rhs lexicographically,
+        //skipping the tombstones of either side; returns -1, 0 or 1
+        int compare_live_successors(IdType id, const BasicDirectedGraph& rhs) const;
+        //recomputes the hash sums after the graph was rebuilt as a whole
+        void rehash();
+        //throws out_of_range unless id is a node that was not deleted
+        void check_live_node(IdType id) const;
+        //compacts if the tombstones passed the threshold
+        void compact_if_needed();
+        //degrees that do not count the deleted edges
+        IdType live_in_degree(IdType id) const;
+        IdType live_out_degree(IdType id) const;
         void clear_nodes();
-        void bfs(int source_id, util::Vector< const Node* >& res) const;
-        void dfs(int source_id, util::Vector< const Node* >& res,
-                 util::Vector< bool >& visited) const;
-        void dfs_tarjan(int node_id, int& curr_idx, util::Vector<int>& idx,
-                        util::Vector<int>& lowlink, util::Stack<int>& stack,
-                        util::Vector<bool>& in_stack,
-                        util::Vector< util::Vector< const Node* > >& scc) const;
-        void dfs_sort_top(int node_id, util::Vector<bool>& visited,
-                          util::Vector< const Node* >& res) const;
+        //deletes the current nodes, then allocates node_count_ new ones in id order
+        void allocate_nodes();
+        //appends every edge of the graph to edges, ordered by source
+        void collect_edges(util::Vector< Edge >& edges) const;
+        //reads one edge of the text format and validates its ids against node_count_
+        Edge read_edge(std::istream& in) const;
+        //returns true if every edge goes towards a larger id, i.e. the ids are a topological order
+        bool ids_in_topological_order() const;
+        //relaxes the outgoing edges of a node whose distance in res is final
+        void relax_successors(IdType node_id, ShortestPathTree< IdType, PayloadType >& res) const;
+        //merge the sorted adjacency lists of a node in this graph and in rhs into node,
+        //keeping the payload from this graph on duplicates; return the number of entries added
+        util::size_t merge_successors(IdType id, const BasicDirectedGraph& rhs, Node* node) const;
+        util::size_t merge_predecessors(IdType id, const BasicDirectedGraph& rhs, Node* node) const;
+
+        void bfs_order(util::Vector< int >& order) const;
+        void reverse_cuthill_mckee_order(util::Vector< int >& order) const;
+        void degree_sorted_order(util::Vector< int >& order) const;
     };
+
+    //the layout used when nothing more specific is needed
+    typedef BasicNode<> Node;
+    typedef BasicEdge<> Edge;
+    typedef BasicDirectedGraph<> DirectedGraph;
+
+    //the same layout with an integer weight on every edge
+    typedef BasicEdge<int, int> WeightedEdge;
+    typedef BasicDirectedGraph<int, int, int> WeightedDirectedGraph;
+
+    namespace detail {
+        //the finalizer of splitmix64, which spreads every input bit over the whole result
+        inline unsigned long long mix_hash(unsigned long long x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        //the fingerprint adds up these hashes, so it does not depend on the order of the mutations
+        inline unsigned long long edge_hash(unsigned long long from, unsigned long long to) {
+            return mix_hash(mix_hash(from + 0x9e3779b97f4a7c15ULL) + to);
+        }
+        inline unsigned long long deleted_node_hash(unsigned long long id) {
+            return mix_hash(id + 0x632be59bd9b4e019ULL);
+        }
+
+        //HyperLogLog sketches of 2^precision one-byte registers: a hash goes to the register given by
+        //its top precision bits, which keeps the largest position of the first set bit in the rest.
+        //the union of two sketches is their register-wise max
+        //the smallest precision whose standard error, 1.04 / sqrt(2^precision), is at most
+        //relative_error, between 4 and 16
+        inline unsigned int hyperloglog_precision(double relative_error) {
+            double registers = (1.04 / relative_error) * (1.04 / relative_error);
+            unsigned int precision = 4;
+            while (precision < 16 && (double)(1u << precision) < registers)
+                precision++;
+            return precision;
+        }
+        inline void hyperloglog_add(unsigned char* registers, unsigned int precision, unsigned long long hash) {
+            unsigned long long rest = hash << precision;
+            unsigned char rank = (unsigned char)(rest == 0 ? 64 - precision + 1 : __builtin_clzll(rest) + 1);
+            unsigned char& target = registers[hash >> (64 - precision)];
+            target = std::max(target, rank);
+        }
+        //the raw estimate with the small range correction of linear counting; the hashes have 64 bits,
+        //so no large range correction is needed
+        inline double hyperloglog_estimate(const unsigned char* registers, unsigned int precision) {
+            util::size_t count = (util::size_t)1 << precision, zeros = 0;
+            double sum = 0, m = (double)count;
+            for (util::size_t k = 0; k < count; ++k) {
+                sum += std::ldexp(1.0, -(int)registers[k]);
+                zeros += (registers[k] == 0);
+            }
+            double alpha = (count == 16 ? 0.673 : count == 32 ? 0.697 : count == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m));
+            double estimate = alpha * m * m / sum;
+            if (estimate <= 2.5 * m && zeros > 0)
+                estimate = m * std::log(m / (double)zeros);
+            return estimate;
+        }
+
+        //the raw adjacency lists of a node, tombstones included, for the algorithms written for both
+        //graphs and the views of graph_views.h, which provide successors and predecessors themselves
+        template<typename IdType, typename OffsetType, typename PayloadType>
+        const util::Vector< IdType >& successor_list(const BasicDirectedGraph< IdType, OffsetType, PayloadType >& graph,
+                                                      IdType id) {
+            return graph.get_node_by_id(id)->get_direct_successors();
+        }
+        template<typename IdType, typename OffsetType, typename PayloadType>
+        const util::Vector< IdType >& predecessor_list(const BasicDirectedGraph< IdType, OffsetType, PayloadType >& graph,
+                                                        IdType id) {
+            return graph.get_node_by_id(id)->get_direct_predecessors();
+        }
+        template<typename View>
+        const util::Vector< typename View::id_type >& successor_list(const View& view, typename View::id_type id) {
+            return view.successors(id);
+        }
+        template<typename View>
+        const util::Vector< typename View::id_type >& predecessor_list(const View& view, typename View::id_type id) {
+            return view.predecessors(id);
+        }
+
+        //reads a non-negative integer that must be representable both as T and as a util::size_t,
+        //since every count read ends up sizing or indexing a util::Vector
+        template<typename T>
+        bool read_bounded(std::istream& in, T& value) {
+            long long raw;
+            if (!(in >> raw) || raw < 0 ||
+                    (unsigned long long)raw > (unsigned long long)std::numeric_limits<T>::max() ||
+                    (unsigned long long)raw > (unsigned long long)std::numeric_limits<util::size_t>::max())
+                return false;
+            value = (T)raw;
+            return true;
+        }
+
+        //returns true if count + extra still fits in T, for a count that is not negative
+        template<typename T>
+        bool fits_after_adding(T count, unsigned long long extra) {
+            return extra <= (unsigned long long)(std::numeric_limits<T>::max() - count);
+        }
+
+        //priority queue used by dijkstra: a radix heap over the distances for integer weights
+        //(they never decrease below the last extracted one), a 4-ary heap for any other weight
+        template<typename WeightType, typename IdType,
+                 bool is_integer = std::numeric_limits<WeightType>::is_integer>
+        struct DijkstraQueue {
+            typedef util::DaryHeap< WeightType, IdType > type;
+            static const WeightType& key(const WeightType& distance) { return distance; }
+        };
+
+        template<typename WeightType, typename IdType>
+        struct DijkstraQueue<WeightType, IdType, true> {
+            typedef util::RadixHeap< IdType > type;
+            static unsigned long long key(const WeightType& distance) { return (unsigned long long)distance; }
+        };
+
+        //orders node ids by a precomputed key, breaking ties by id so the result is deterministic
+        class CompareByKey {
+          public:
+            CompareByKey(const util::Vector<int>& key, bool descending) :
+                    key_(key), descending_(descending) {}
+            bool operator () (int lhs, int rhs) const {
+                if (key_[lhs] != key_[rhs])
+                    return descending_ ? key_[lhs] > key_[rhs] : key_[lhs] < key_[rhs];
+                return lhs < rhs;
+            }
+          private:
+            const util::Vector<int>& key_;
+            bool descending_;
+        };
+
+        //the traversals and component algorithms behind both the member functions of BasicDirectedGraph
+        //and the free functions of graph_views.h, so each of them exists once; Graph is either one.
+        //the monitor, when given, is advanced once per finished node; starting it is up to the caller
+        template<typename Graph>
+        void run_bfs(const Graph& graph, typename Graph::id_type source_id,
+                     util::Vector< const typename Graph::Node* >& res);
+        template<typename Graph>
+        void run_dfs(const Graph& graph, typename Graph::id_type source_id,
+                     util::Vector< const typename Graph::Node* >& res);
+        //Tarjan's algorithm over every node
+        template<typename Graph>
+        void tarjan_components(const Graph& graph, util::Vector< util::Vector< const typename Graph::Node* > >& scc,
+                               OperationMonitor* monitor = NULL);
+        //appends the nodes reachable from node_id that state marks as unvisited (0) to res in dfs
+        //finish order, i.e. in reversed topological order; throws bad_top_sort on a cycle
+        template<typename Graph>
+        void dfs_finish_order(const Graph& graph, typename Graph::id_type node_id, util::Vector< char >& state,
+                              util::Vector< const typename Graph::Node* >& res, OperationMonitor* monitor = NULL);
+        //the dfs starts from the nodes without incoming edges, in id order; throws bad_top_sort if
+        //the graph has cycles
+        template<typename Graph>
+        void topological_order(const Graph& graph, util::Vector< const typename Graph::Node* >& res,
+                               OperationMonitor* monitor = NULL);
+        //a bidirectional bfs telling whether to_id is reachable from from_id; both must be visible
+        template<typename Graph>
+        bool bidirectional_reachable(const Graph& graph, typename Graph::id_type from_id,
+                                     typename Graph::id_type to_id);
+
+        //fills immediate_dominators with the immediate dominator of every node reachable from root_id
+        //and IdType(-1) for the others; shared by BasicDirectedGraph and the views of graph_views.h.
+        //the nodes are numbered in dfs preorder and every array is indexed by these numbers
+        template<typename Graph>
+        void compute_dominators(const Graph& graph, typename Graph::id_type root_id,
+                                util::Vector< typename Graph::id_type >& immediate_dominators);
+
+        //strongly connected components by recursive forward-backward decomposition:
+        //the nodes reachable both from and to a pivot form its component, and every other
+        //component lies entirely within the nodes reachable only from it, only to it, or neither,
+        //so those three sets are solved as independent tasks. Before choosing a pivot, a task
+        //trims the nodes without incoming or outgoing edges inside its set, which are components
+        //on their own and would otherwise cost one round each (e.g. along a chain).
+        //every node carries the label of the set it belongs to, so a search never leaves its set.
+        //Graph is a BasicDirectedGraph or one of the views of graph_views.h
+        template<typename Graph>
+        class ParallelScc {
+          public:
+            typedef typename Graph::id_type IdType;
+            typedef typename Graph::Node Node;
+
+            explicit ParallelScc(const Graph& graph);
+            virtual ~ParallelScc();
+
+            void run(util::Vector< util::Vector< const Node* > >& res);
+          private:
+            ParallelScc(const ParallelScc& rhs);
+            ParallelScc& operator = (const ParallelScc& rhs);
+
+            //solves the set of nodes labeled label; takes ownership of set
+            void solve(util::Vector< IdType >* set, long long label);
+            //removes the trivial components from set, which keeps only the nodes still labeled label
+            void trim(util::Vector< IdType >& set, long long label);
+            //queues a task that solves set
+            void spawn(util::Vector< IdType >* set, long long label);
+            void emit(const util::Vector< IdType >& component);
+
+            const Graph& graph_;
+            IdType node_count_;
+            std::atomic< long long >* labels_;
+            std::atomic< long long > next_label_;
+            //the degrees inside the set of each node; a node only belongs to one set at a time,
+            //so the task that owns the set is the only one touching its entries
+            util::Vector< IdType > in_degree_, out_degree_;
+            util::WorkerLocal< util::Vector< IdType > > stacks_;
+            util::WorkerLocal< util::Vector< util::Vector< const Node* > > > components_;
+            util::TaskGroup group_;
+        };
+    }
+
+    //implementation of Node's methods
+    template<typename IdType, typename PayloadType>
+    BasicNode<IdType, PayloadType>::BasicNode(IdType id) : id_(id) {}
+
+    template<typename IdType, typename PayloadType>
+    BasicNode<IdType, PayloadType>::~BasicNode() {}
+
+    template<typename IdType, typename PayloadType>
+    IdType BasicNode<IdType, PayloadType>::get_id() const { return id_; }
+
+    template<typename IdType, typename PayloadType>
+    void BasicNode<IdType, PayloadType>::set_id(IdType id) { id_ = id; }
+
+    template<typename IdType, typename PayloadType>
+    void BasicNode<IdType, PayloadType>::add_direct_successor(IdType id, const PayloadType& payload) {
+        direct_successors_.push_back(id);
+        PayloadList<PayloadType>::push_back(payload);
+    }
+
+    template<typename IdType, typename PayloadType>
+    void BasicNode<IdType, PayloadType>::add_direct_predecessor(IdType id) {
+        direct_predecessors_.push_back(id);
+    }
+
+    template<typename IdType, typename PayloadType>
+    const util::Vector< IdType >& BasicNode<IdType, PayloadType>::get_direct_successors() const {
+        return direct_successors_;
+    }
+
+    template<typename IdType, typename PayloadType>
+    const util::Vector< IdType >& BasicNode<IdType, PayloadType>::get_direct_predecessors() const {
+        return direct_predecessors_;
+    }
+
+    template<typename IdType, typename PayloadType>
+    const PayloadType& BasicNode<IdType, PayloadType>::get_successor_payload(util::size_t index) const {
+        return PayloadList<PayloadType>::get_payload(index);
+    }
+
+    template<typename IdType, typename PayloadType>
+    const util::Vector< PayloadType >& BasicNode<IdType, PayloadType>::get_successor_payloads() const {
+        return PayloadList<PayloadType>::get_payloads();
+    }
+
+    template<typename IdType, typename PayloadType>
+    std::size_t BasicNode<IdType, PayloadType>::get_payload_bytes() const {
+        return PayloadList<PayloadType>::payload_bytes();
+    }
+
+    template<typename IdType, typename PayloadType>
+    IdType BasicNode<IdType, PayloadType>::get_in_degree() const {
+        return (IdType)direct_predecessors_.size();
+    }
+
+    template<typename IdType, typename PayloadType>
+    IdType BasicNode<IdType, PayloadType>::get_out_degree() const {
+        return (IdType)direct_successors_.size();
+    }
+
+    template<typename IdType, typename PayloadType>
+    void BasicNode<IdType, PayloadType>::retain_direct_successors(const util::Vector<bool> &keep) {
+        util::size_t kept_count = retain_ids(direct_successors_, keep);
+        PayloadList<PayloadType>::retain(keep, kept_count);
+    }
+
+    template<typename IdType, typename PayloadType>
+    void BasicNode<IdType, PayloadType>::retain_direct_predecessors(const util::Vector<bool> &keep) {
+        retain_ids(direct_predecessors_, keep);
+    }
+
+    template<typename IdType, typename PayloadType>
+    util::size_t BasicNode<IdType, PayloadType>::retain_ids(util::Vector<IdType> &list, const util::Vector<bool> &keep) {
+        util::size_t kept_count = 0;
+        for (util::size_t k = 0; k < list.size(); ++k)
+            kept_count += keep[k];
+        util::Vector< IdType > kept;
+        kept.reserve(kept_count);
+        for (util::size_t k = 0; k < list.size(); ++k)
+            if (keep[k])
+                kept.push_back(list[k]);
+        list = kept;
+        return kept_count;
+    }
+
+    template<typename IdType, typename PayloadType>
+    bool BasicNode<IdType, PayloadType>::operator == (const BasicNode &rhs) const { return id_ == rhs.id_; }
+    template<typename IdType, typename PayloadType>
+    bool BasicNode<IdType, PayloadType>::operator != (const BasicNode &rhs) const { return id_ != rhs.id_; }
+    template<typename IdType, typename PayloadType>
+    bool BasicNode<IdType, PayloadType>::operator < (const BasicNode &rhs) const { return id_ < rhs.id_; }
+
+    //implementation of Edge's methods
+    template<typename IdType, typename PayloadType>
+    BasicEdge<IdType, PayloadType>::BasicEdge(IdType from_node_id, IdType to_node_id, const PayloadType& payload) :
+            PayloadHolder<PayloadType>(payload), from_node_id_(from_node_id), to_node_id_(to_node_id) {}
+
+    template<typename IdType, typename PayloadType>
+    BasicEdge<IdType, PayloadType>::BasicEdge(const BasicEdge &rhs) :
+            PayloadHolder<PayloadType>(rhs), from_node_id_(rhs.from_node_id_), to_node_id_(rhs.to_node_id_) {}
+
+    template<typename IdType, typename PayloadType>
+    BasicEdge<IdType, PayloadType>& BasicEdge<IdType, PayloadType>::operator=(const BasicEdge &rhs) {
+        PayloadHolder<PayloadType>::operator=(rhs);
+        from_node_id_ = rhs.from_node_id_;
+        to_node_id_ = rhs.to_node_id_;
+        return (*this);
+    }
+
+    template<typename IdType, typename PayloadType>
+    BasicEdge<IdType, PayloadType>::~BasicEdge() {}
+
+    template<typename IdType, typename PayloadType>
+    IdType BasicEdge<IdType, PayloadType>::from_node_id() const {
+        return from_node_id_;
+    }
+
+    template<typename IdType, typename PayloadType>
+    IdType BasicEdge<IdType, PayloadType>::to_node_id() const {
+        return to_node_id_;
+    }
+
+    template<typename IdType, typename PayloadType>
+    const PayloadType& BasicEdge<IdType, PayloadType>::payload() const {
+        return PayloadHolder<PayloadType>::get_payload();
+    }
+
+    template<typename IdType, typename PayloadType>
+    bool BasicEdge<IdType, PayloadType>::operator == (const BasicEdge &rhs) const {
+        return (to_node_id_ == rhs.to_node_id_ && from_node_id_ == rhs.from_node_id_);
+    }
+    template<typename IdType, typename PayloadType>
+    bool BasicEdge<IdType, PayloadType>::operator != (const BasicEdge &rhs) const {
+        return (to_node_id_ != rhs.to_node_id_ || from_node_id_ != rhs.from_node_id_);
+    }
+    template<typename IdType, typename PayloadType>
+    bool BasicEdge<IdType, PayloadType>::operator < (const BasicEdge &rhs) const {
+        return (from_node_id_  < rhs.from_node_id_ ||
+                (from_node_id_ == rhs.from_node_id_ && to_node_id_ < rhs.to_node_id_) );
+    }
+
+    //implementation of NodePermutation's template methods
+    template<typename NodeType>
+    util::Vector< int > NodePermutation::to_original_ids(const util::Vector< const NodeType* > &nodes) const {
+        util::Vector<int> res;
+        for (typename util::Vector< const NodeType* >::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+            res.push_back(inverse_[(int)(*it)->get_id()]);
+        return res;
+    }
+
+    //implementation of DirectedGraph's methods
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::BasicDirectedGraph() :
+            node_count_(0), edge_count_(0), nodes_(0), compaction_threshold_(0.25), listener_(NULL),
+            edge_hash_sum_(0), deleted_node_hash_sum_(0) {}
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::BasicDirectedGraph(const BasicDirectedGraph &rhs) :
+            node_count_(0), edge_count_(0), compaction_threshold_(0.25), listener_(NULL),
+            edge_hash_sum_(0), deleted_node_hash_sum_(0) {
+        (*this) = rhs;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>&
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::operator=(const BasicDirectedGraph &rhs) {
+        DGRAPH_TRACE_SCOPE("copy");
+        util::Vector<Edge> edges; //get all edges from rhs
+        rhs.collect_edges(edges);
+
+        clear_nodes();
+        node_count_ = rhs.node_count_;
+        edge_count_ = rhs.edge_count_;
+        //the deleted edges are not collected, so the copy starts compacted
+        overlay_ = rhs.overlay_;
+        overlay_.clear_edges();
+        compaction_threshold_ = rhs.compaction_threshold_;
+        allocate_nodes();
+        for (util::size_t i = 0; i < edges.size(); ++i)
+            add_edge(edges[i].from_node_id(), edges[i].to_node_id(), edges[i].payload());
+        edge_hash_sum_ = rhs.edge_hash_sum_;
+        deleted_node_hash_sum_ = rhs.deleted_node_hash_sum_;
+        return (*this);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::~BasicDirectedGraph() {
+        clear_nodes();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::operator == (const BasicDirectedGraph& rhs) const {
+        if (this == &rhs)
+            return true;
+        if (node_count_ != rhs.node_count_ || edge_count_ != rhs.edge_count_ ||
+                overlay_.deleted_node_count() != rhs.overlay_.deleted_node_count() ||
+                fingerprint() != rhs.fingerprint())
+            return false;
+        for (IdType i = 0; i < node_count_; ++i)
+            if (overlay_.is_node_deleted(i) != rhs.overlay_.is_node_deleted(i) ||
+                    compare_live_successors(i, rhs) != 0)
+                return false;
+        return true;
+    }
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::operator != (const BasicDirectedGraph& rhs) const {
+        return !((*this) == rhs);
+    }
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::operator < (const BasicDirectedGraph& rhs) const {
+        if (this == &rhs)
+            return false;
+        if (node_count_ != rhs.node_count_)
+            return node_count_ < rhs.node_count_;
+        if (edge_count_ != rhs.edge_count_)
+            return edge_count_ < rhs.edge_count_;
+        if (fingerprint() != rhs.fingerprint())
+            return fingerprint() < rhs.fingerprint();
+        //only reached on equal graphs or on a hash collision
+        for (IdType i = 0; i < node_count_; ++i) {
+            bool lhs_deleted = overlay_.is_node_deleted(i), rhs_deleted = rhs.overlay_.is_node_deleted(i);
+            if (lhs_deleted != rhs_deleted)
+                return lhs_deleted < rhs_deleted;
+            int comparison = compare_live_successors(i, rhs);
+            if (comparison != 0)
+                return comparison < 0;
+        }
+        return false;
+    }
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    int BasicDirectedGraph<IdType, OffsetType, PayloadType>::compare_live_successors(IdType id,
+                                                                                    const BasicDirectedGraph& rhs) const {
+        //the successor lists are sorted by id in both graphs, so they are merged while
+        //skipping the tombstones of either side
+        const util::Vector< IdType >& lhs_successors = nodes_[id]->get_direct_successors();
+        const util::Vector< IdType >& rhs_successors = rhs.nodes_[id]->get_direct_successors();
+        util::size_t lhs_k = 0, rhs_k = 0;
+        for (;;) {
+            while (lhs_k < lhs_successors.size() && overlay_.is_edge_deleted(id, lhs_successors[lhs_k]))
+                lhs_k++;
+            while (rhs_k < rhs_successors.size() && rhs.overlay_.is_edge_deleted(id, rhs_successors[rhs_k]))
+                rhs_k++;
+            if (lhs_k == lhs_successors.size() || rhs_k == rhs_successors.size())
+                break;
+            if (lhs_successors[lhs_k] != rhs_successors[rhs_k])
+                return lhs_successors[lhs_k] < rhs_successors[rhs_k] ? -1 : 1;
+            lhs_k++;
+            rhs_k++;
+        }
+        if (lhs_k == lhs_successors.size())
+            return rhs_k == rhs_successors.size() ? 0 : -1;
+        return 1;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    unsigned long long BasicDirectedGraph<IdType, OffsetType, PayloadType>::fingerprint() const {
+        return detail::mix_hash(edge_hash_sum_ ^ detail::mix_hash(deleted_node_hash_sum_ + (unsigned long long)node_count_));
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    std::istream& operator >> (std::istream &in, BasicDirectedGraph<IdType, OffsetType, PayloadType> &graph) {
+        typedef typename BasicDirectedGraph<IdType, OffsetType, PayloadType>::Edge Edge;
+        DGRAPH_TRACE_SCOPE("load");
+        graph.clear_nodes();
+        graph.overlay_.clear();
+        graph.node_count_ = 0;
+        graph.edge_count_ = 0;
+        graph.rehash();
+        //a failed load leaves an empty graph
+        try {
+            //the counts must fit in IdType and OffsetType respectively
+            if (!detail::read_bounded(in, graph.node_count_)) throw bad_dgraph_config();
+            if (!detail::read_bounded(in, graph.edge_count_)) throw bad_dgraph_config();
+
+            graph.allocate_nodes();
+
+            util::Vector< Edge > edges;
+            {
+                DGRAPH_TRACE_SCOPE("load/parse");
+                for (OffsetType i = 0; i < graph.edge_count_; ++i)
+                    edges.push_back(graph.read_edge(in));
+            }
+
+            {   //test if there are any edge duplicates
+                DGRAPH_TRACE_SCOPE("load/duplicate_check");
+                std::sort(edges.begin(), edges.end());
+                for (util::size_t i = 1; i < edges.size(); ++i)
+                    if (edges[i - 1] == edges[i])
+                        throw bad_dgraph_config();
+            }
+
+            DGRAPH_TRACE_SCOPE("load/build_adjacency");
+            for (util::size_t i = 0; i < edges.size(); ++i)
+                graph.add_edge(edges[i].from_node_id(), edges[i].to_node_id(), edges[i].payload());
+            graph.rehash();
+        }
+        catch (...) {
+            graph.clear_nodes();
+            graph.node_count_ = 0;
+            graph.edge_count_ = 0;
+            graph.rehash();
+            throw;
+        }
+
+        return in;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    std::ostream& operator << (std::ostream& out, const BasicDirectedGraph<IdType, OffsetType, PayloadType>& graph) {
+        typedef typename BasicDirectedGraph<IdType, OffsetType, PayloadType>::Node Node;
+        //the unary plus promotes 8-bit ids, so they are written as numbers and not as characters
+        //deleted edges are left out, deleted nodes keep their ids and are written as isolated nodes
+        out << +graph.node_count_ << " " << +graph.edge_count_ << "\n";
+        for (IdType i = 0; i < graph.node_count_; ++i) {
+            const Node* node = graph.nodes_[i];
+            const util::Vector<IdType>& current_node_successors = node->get_direct_successors();
+            for (util::size_t k = 0; k < current_node_successors.size(); ++k) {
+                if (graph.overlay_.is_edge_deleted(i, current_node_successors[k]))
+                    continue;
+                out << +i << " " << +current_node_successors[k];
+                PayloadTraits<PayloadType>::write(out, node->get_successor_payload(k));
+                out << '\n';
+            }
+        }
+        return out;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    IdType BasicDirectedGraph<IdType, OffsetType, PayloadType>::node_count() const { return node_count_; }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    IdType BasicDirectedGraph<IdType, OffsetType, PayloadType>::live_node_count() const {
+        return node_count_ - overlay_.deleted_node_count();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    OffsetType BasicDirectedGraph<IdType, OffsetType, PayloadType>::edge_count() const { return edge_count_; }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    const BasicNode<IdType, PayloadType>* BasicDirectedGraph<IdType, OffsetType, PayloadType>::get_node_by_id(IdType id) const {
+        return nodes_[id];
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::add_new_node(std::istream &in) {
+        if (node_count_ == std::numeric_limits<IdType>::max())
+            throw bad_dgraph_config(); //the id of the new node would not fit in IdType
+        OffsetType new_edges_count;
+        if (!detail::read_bounded(in, new_edges_count)) throw bad_dgraph_config();
+        util::Vector< Edge > new_edges;
+        //read_edge checks the ids against node_count_, which has to count the new node meanwhile
+        node_count_++;
+        try {
+            while (new_edges_count--)
+                new_edges.push_back(read_edge(in));
+        }
+        catch (...) {
+            node_count_--;
+            throw;
+        }
+        node_count_--;
+        add_new_node(new_edges);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::add_new_node(const util::Vector<Edge> &edges) {
+        DGRAPH_TRACE_SCOPE("add_new_node");
+        if (node_count_ == std::numeric_limits<IdType>::max())
+            throw bad_dgraph_config(); //the id of the new node would not fit in IdType
+        //everything is checked before the node is created, so a rejected node leaves the graph unchanged
+        IdType id = node_count_;
+        util::Vector< Edge > new_edges(edges);
+        for (util::size_t i = 0; i < new_edges.size(); ++i) {
+            IdType from = new_edges[i].from_node_id(), to = new_edges[i].to_node_id();
+            if (from < 0 || from > id || to < 0 || to > id || from == to || (from != id && to != id))
+                throw bad_dgraph_config();
+            if (overlay_.is_node_deleted(from) || overlay_.is_node_deleted(to))
+                throw bad_dgraph_config();
+        }
+        std::sort(new_edges.begin(), new_edges.end());
+        for (util::size_t i = 1; i < new_edges.size(); ++i)
+            if (new_edges[i - 1] == new_edges[i])
+                throw bad_dgraph_config();
+        if (!detail::fits_after_adding(edge_count_, new_edges.size()))
+            throw bad_dgraph_config(); //the edge count would not fit in OffsetType
+
+        node_count_++;
+        nodes_.push_back(new Node(id));
+        for (util::size_t i = 0; i < new_edges.size(); ++i) {
+            add_edge(new_edges[i].from_node_id(), new_edges[i].to_node_id(), new_edges[i].payload());
+            edge_hash_sum_ += detail::edge_hash(new_edges[i].from_node_id(), new_edges[i].to_node_id());
+        }
+        edge_count_ += (OffsetType)new_edges.size();
+
+        if (listener_ != NULL)
+            listener_->node_added(id, new_edges);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::write_binary(std::ostream &out) const {
+        DGRAPH_TRACE_SCOPE("write_binary");
+        util::BinaryWriter writer(out);
+        writer.put_bytes("DGB1", 4);
+        writer.put((unsigned char)sizeof(IdType));
+        writer.put((unsigned char)sizeof(OffsetType));
+        writer.put((unsigned char)sizeof(PayloadType));
+        writer.put(node_count_);
+        writer.put(edge_count_);
+        writer.put(overlay_.deleted_node_count());
+        //the counts get their own checksum, since they decide what the reader allocates
+        writer.put(writer.checksum());
+        for (IdType i = 0; i < node_count_; ++i)
+            if (overlay_.is_node_deleted(i))
+                writer.put(i);
+        for (IdType i = 0; i < node_count_; ++i) {
+            const util::Vector< IdType >& current_successors = nodes_[i]->get_direct_successors();
+            writer.put(live_out_degree(i));
+            for (util::size_t k = 0; k < current_successors.size(); ++k)
+                if (!overlay_.is_edge_deleted(i, current_successors[k])) {
+                    writer.put(current_successors[k]);
+                    PayloadTraits<PayloadType>::write_binary(writer, nodes_[i]->get_successor_payload(k));
+                }
+        }
+        writer.put(writer.checksum());
+        writer.flush();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::read_binary(std::istream &in) {
+        DGRAPH_TRACE_SCOPE("read_binary");
+        clear_nodes();
+        overlay_.clear();
+        node_count_ = 0;
+        edge_count_ = 0;
+        rehash();
+
+        util::BinaryReader reader(in);
+        char magic[4];
+        unsigned char sizes[3];
+        if (!reader.get_bytes(magic, 4) || std::memcmp(magic, "DGB1", 4) != 0 || !reader.get_bytes(sizes, 3) ||
+                sizes[0] != sizeof(IdType) || sizes[1] != sizeof(OffsetType) || sizes[2] != sizeof(PayloadType))
+            throw bad_dgraph_config();
+        IdType node_count, deleted_count;
+        OffsetType edge_count;
+        if (!reader.get(node_count) || !reader.get(edge_count) || !reader.get(deleted_count))
+            throw bad_dgraph_config();
+        unsigned int header_expected = reader.checksum(), header_checksum;
+        if (!reader.get(header_checksum) || header_checksum != header_expected ||
+                node_count < 0 || edge_count < 0 || deleted_count < 0 || deleted_count > node_count ||
+                (unsigned long long)node_count > (unsigned long long)std::numeric_limits<util::size_t>::max())
+            throw bad_dgraph_config();
+        node_count_ = node_count;
+        allocate_nodes();
+        //a failed load leaves an empty graph, as it does for operator>>
+        try {
+            for (IdType k = 0, previous = 0; k < deleted_count; ++k) {
+                IdType id;
+                if (!reader.get(id) || (k > 0 && id <= previous) || id < 0 || id >= node_count_)
+                    throw bad_dgraph_config();
+                overlay_.delete_node(id);
+                previous = id;
+            }
+            //the sources come in increasing order, so appending keeps the predecessor lists sorted too
+            OffsetType total = 0;
+            for (IdType i = 0; i < node_count_; ++i) {
+                IdType degree;
+                if (!reader.get(degree) || degree < 0 || degree > node_count_ ||
+                        (degree > 0 && overlay_.is_node_deleted(i)))
+                    throw bad_dgraph_config();
+                for (IdType k = 0, previous = 0; k < degree; ++k) {
+                    IdType to;
+                    PayloadType payload = PayloadType();
+                    if (!reader.get(to) || !PayloadTraits<PayloadType>::read_binary(reader, payload) ||
+                            (k > 0 && to <= previous) || to < 0 || to >= node_count_ || to == i ||
+                            overlay_.is_node_deleted(to))
+                        throw bad_dgraph_config();
+                    add_edge(i, to, payload);
+                    previous = to;
+                }
+                total += (OffsetType)degree;
+            }
+            unsigned int expected = reader.checksum(), checksum;
+            if (!reader.get(checksum) || checksum != expected || total != edge_count)
+                throw bad_dgraph_config();
+            edge_count_ = edge_count;
+            rehash();
+        }
+        catch (...) {
+            clear_nodes();
+            overlay_.clear();
+            node_count_ = 0;
+            rehash();
+            throw;
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::set_mutation_listener(
+            MutationListener<IdType, PayloadType> *listener) {
+        listener_ = listener;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    MutationListener<IdType, PayloadType>* BasicDirectedGraph<IdType, OffsetType, PayloadType>::get_mutation_listener() const {
+        return listener_;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::has_edge(IdType from, IdType to) const {
+        if (from < 0 || from >= node_count_ || to < 0 || to >= node_count_)
+            throw std::out_of_range("Invalid node id!");
+        //the successor lists are sorted by id, tombstones included
+        const util::Vector< IdType >& successors = nodes_[from]->get_direct_successors();
+        return std::binary_search(successors.begin(), successors.end(), to) && !overlay_.is_edge_deleted(from, to);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::remove_edge(IdType from, IdType to) {
+        check_live_node(from);
+        check_live_node(to);
+        if (!has_edge(from, to))
+            throw bad_dgraph_config();
+        DGRAPH_TRACE_SCOPE("remove_edge");
+        overlay_.delete_edge(from, to);
+        edge_count_--;
+        edge_hash_sum_ -= detail::edge_hash(from, to);
+        compact_if_needed();
+        if (listener_ != NULL)
+            listener_->edge_removed(from, to);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::remove_node(IdType id) {
+        check_live_node(id);
+        DGRAPH_TRACE_SCOPE("remove_node");
+        const util::Vector< IdType >& current_successors = nodes_[id]->get_direct_successors();
+        for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+             it != current_successors.end(); ++it)
+            if (!overlay_.is_edge_deleted(id, *it)) {
+                overlay_.delete_edge(id, *it);
+                edge_count_--;
+                edge_hash_sum_ -= detail::edge_hash(id, *it);
+            }
+        const util::Vector< IdType >& current_predecessors = nodes_[id]->get_direct_predecessors();
+        for (typename util::Vector< IdType >::const_iterator it = current_predecessors.begin();
+             it != current_predecessors.end(); ++it)
+            if (!overlay_.is_edge_deleted(*it, id)) {
+                overlay_.delete_edge(*it, id);
+                edge_count_--;
+                edge_hash_sum_ -= detail::edge_hash(*it, id);
+            }
+        overlay_.delete_node(id);
+        deleted_node_hash_sum_ += detail::deleted_node_hash(id);
+        compact_if_needed();
+        if (listener_ != NULL)
+            listener_->node_removed(id);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::is_edge_deleted(IdType from, IdType to) const {
+        return overlay_.is_edge_deleted(from, to);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::is_node_deleted(IdType id) const {
+        return overlay_.is_node_deleted(id);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::compact() {
+        if (overlay_.deleted_edge_count() == 0)
+            return;
+        DGRAPH_TRACE_SCOPE("compact");
+        //only the lists that hold tombstones are rewritten; the overlay is read until
+        //every list is done, since a tombstone is stored in two of them
+        util::Vector< bool > keep;
+        for (IdType i = 0; i < node_count_; ++i) {
+            if (overlay_.deleted_successor_count(i) != 0) {
+                const util::Vector< IdType >& current_successors = nodes_[i]->get_direct_successors();
+                keep.clear();
+                for (util::size_t k = 0; k < current_successors.size(); ++k)
+                    keep.push_back(!overlay_.is_edge_deleted(i, current_successors[k]));
+                nodes_[i]->retain_direct_successors(keep);
+            }
+            if (overlay_.deleted_predecessor_count(i) != 0) {
+                const util::Vector< IdType >& current_predecessors = nodes_[i]->get_direct_predecessors();
+                keep.clear();
+                for (util::size_t k = 0; k < current_predecessors.size(); ++k)
+                    keep.push_back(!overlay_.is_edge_deleted(current_predecessors[k], i));
+                nodes_[i]->retain_direct_predecessors(keep);
+            }
+        }
+        overlay_.clear_edges();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::set_compaction_threshold(double fraction) {
+        compaction_threshold_ = fraction;
+        compact_if_needed();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    double BasicDirectedGraph<IdType, OffsetType, PayloadType>::get_compaction_threshold() const {
+        return compaction_threshold_;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::check_live_node(IdType id) const {
+        if (id < 0 || id >= node_count_ || overlay_.is_node_deleted(id))
+            throw std::out_of_range("Invalid node id!");
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::compact_if_needed() {
+        //a compaction costs O(N + M), so waiting for a fraction of N + M tombstones amortizes it
+        double tombstones = (double)overlay_.deleted_edge_count();
+        if (compaction_threshold_ >= 0 && tombstones > 0 &&
+                tombstones >= compaction_threshold_ * ((double)node_count_ + (double)edge_count_ + tombstones))
+            compact();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    IdType BasicDirectedGraph<IdType, OffsetType, PayloadType>::live_in_degree(IdType id) const {
+        return nodes_[id]->get_in_degree() - overlay_.deleted_predecessor_count(id);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    IdType BasicDirectedGraph<IdType, OffsetType, PayloadType>::live_out_degree(IdType id) const {
+        return nodes_[id]->get_out_degree() - overlay_.deleted_successor_count(id);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    typename BasicDirectedGraph<IdType, OffsetType, PayloadType>::Edge
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::read_edge(std::istream &in) const {
+        IdType from, to;
+        PayloadType payload = PayloadType();
+        //test configuration
+        if (!detail::read_bounded(in, from)) throw bad_dgraph_config();
+        if (!detail::read_bounded(in, to)) throw bad_dgraph_config();
+        if (from >= node_count_ || to >= node_count_)
+            throw bad_dgraph_config();
+        //test for self-loops
+        if (from == to)
+            throw bad_dgraph_config();
+        if (!PayloadTraits<PayloadType>::read(in, payload)) throw bad_dgraph_config();
+        return Edge(from, to, payload);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::add_edge(IdType from, IdType to,
+                                                                      const PayloadType& payload) {
+        nodes_[from]->add_direct_successor(to, payload);
+        nodes_[to]->add_direct_predecessor(from);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::rehash() {
+        edge_hash_sum_ = deleted_node_hash_sum_ = 0;
+        for (IdType i = 0; i < node_count_; ++i) {
+            if (overlay_.is_node_deleted(i))
+                deleted_node_hash_sum_ += detail::deleted_node_hash(i);
+            const util::Vector< IdType >& current_successors = nodes_[i]->get_direct_successors();
+            for (util::size_t k = 0; k < current_successors.size(); ++k)
+                if (!overlay_.is_edge_deleted(i, current_successors[k]))
+                    edge_hash_sum_ += detail::edge_hash(i, current_successors[k]);
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::clear_nodes() {
+        for (util::size_t i = 0; i < nodes_.size(); ++i)
+            if (nodes_[i] != NULL)
+                delete nodes_[i];
+        nodes_.clear();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::allocate_nodes() {
+        clear_nodes();
+        nodes_ = util::Vector<Node*>(node_count_, NULL);
+        for (IdType i = 0; i < node_count_; ++i)
+            nodes_[i] = new Node(i);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::collect_edges(util::Vector<Edge> &edges) const {
+        for (IdType i = 0; i < node_count_; ++i) {
+            const Node* node = nodes_[i];
+            const util::Vector<IdType>& current_successors = node->get_direct_successors();
+            for (util::size_t k = 0; k < current_successors.size(); ++k)
+                if (!overlay_.is_edge_deleted(i, current_successors[k]))
+                    edges.push_back(Edge(i, current_successors[k], node->get_successor_payload(k)));
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< const BasicNode<IdType, PayloadType>* >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::breadth_first_search(IdType source_id) const {
+        check_live_node(source_id);
+        DGRAPH_TRACE_SCOPE("breadth_first_search");
+        util::Vector< const Node* > res;
+        detail::run_bfs(*this, source_id, res);
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::output_breadth_first_search(std::ostream &out,
+                                                                                         IdType source_id) const {
+        util::Vector< const Node* > res = breadth_first_search(source_id);
+        for (typename util::Vector< const Node* >::iterator it = res.begin(); it != res.end(); ++it)
+            out << +(*it)->get_id() << ' ';
+        out << '\n';
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< const BasicNode<IdType, PayloadType>* >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::depth_first_search(IdType source_id) const {
+        check_live_node(source_id);
+        DGRAPH_TRACE_SCOPE("depth_first_search");
+        util::Vector< const Node* > res;
+        detail::run_dfs(*this, source_id, res);
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::output_depth_first_search(std::ostream &out,
+                                                                                       IdType source_id) const {
+        util::Vector< const Node* > res = depth_first_search(source_id);
+        for (typename util::Vector< const Node* >::iterator it = res.begin(); it != res.end(); ++it)
+            out << +(*it)->get_id() << ' ';
+        out << '\n';
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< util::Vector< bool > > BasicDirectedGraph<IdType, OffsetType, PayloadType>::get_path_matrix(OperationMonitor* monitor) const {
+        //does a Roy-Floyd-like approach of finding the path matrix
+        DGRAPH_TRACE_SCOPE("get_path_matrix");
+        if (monitor != NULL)
+            monitor->start(node_count_);
+        util::Vector< util::Vector< bool > > res(node_count_, util::Vector< bool >(node_count_, false));
+        for (IdType i = 0; i < node_count_; ++i) {
+            res[i][i] = !overlay_.is_node_deleted(i); //every node is accessible from itself
+            const util::Vector< IdType >& current_successors = nodes_[i]->get_direct_successors();
+            for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                    it != current_successors.end(); ++it)
+                if (!overlay_.is_edge_deleted(i, *it))
+                    res[i][*it] = true; //for each edge mark the corresponding path
+
+        }
+
+        for (IdType interm = 0; interm < node_count_; ++interm) {
+            for (IdType first = 0; first < node_count_; ++first) {
+                if (monitor != NULL)
+                    monitor->check();
+                if (first != interm)
+                    for (IdType last = 0; last < node_count_; ++last)
+                        if (last != first && last != interm)
+                            res[first][last] |= (res[first][interm] && res[interm][last]);
+            }
+            if (monitor != NULL)
+                monitor->advance();
+        }
+
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::output_path_matrix(std::ostream &out) const {
+        util::Vector< util::Vector< bool > > res = get_path_matrix();
+        for (IdType i = 0; i < node_count_; ++i, out << '\n')
+            for (IdType j = 0; j < node_count_; ++j)
+                out << res[i][j];
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< util::Vector< const BasicNode<IdType, PayloadType>* > >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::get_strongly_connected_components(OperationMonitor* monitor) const {
+        DGRAPH_TRACE_SCOPE("get_strongly_connected_components");
+        if (monitor != NULL)
+            monitor->start(live_node_count());
+        util::Vector< util::Vector< const Node* > > scc;
+        detail::tarjan_components(*this, scc, monitor);
+        return scc;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::output_strongly_connected_components(std::ostream &out) const {
+        util::Vector< util::Vector< const Node* > > scc = get_strongly_connected_components();
+        out << scc.size() << '\n';
+        for (util::size_t i = 0; i < scc.size(); ++i, out << '\n')
+            for (util::size_t j = 0; j < scc[i].size(); ++j)
+                out << +scc[i][j]->get_id() << ' ';
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::is_strongly_connected() const {
+        util::Vector< util::Vector< const Node* > > scc = get_strongly_connected_components();
+        //in a strongly connected graph there is only one strongly connected comp
+        return (scc.size() == 1);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::is_acyclic() const {
+        util::Vector< util::Vector< const Node* > > scc = get_strongly_connected_components();
+        //in a acyclic graph the no of nodes is equal to the no of scc
+        return ((std::size_t)scc.size() == (std::size_t)live_node_count());
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::has_path(IdType from_id, IdType to_id) const {
+        check_live_node(from_id);
+        check_live_node(to_id);
+        DGRAPH_TRACE_SCOPE("has_path");
+        return detail::bidirectional_reachable(*this, from_id, to_id);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< const BasicNode<IdType, PayloadType>* >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::topological_sort(OperationMonitor* monitor) const {
+        DGRAPH_TRACE_SCOPE("topological_sort");
+        if (monitor != NULL)
+            monitor->start(live_node_count());
+        util::Vector< const Node* > res;
+        detail::topological_order(*this, res, monitor);
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::output_topological_sort(std::ostream &out) const {
+        util::Vector< const Node* > res = topological_sort();
+        for (typename util::Vector< const Node* >::iterator it = res.begin(); it != res.end(); ++it)
+            out << +(*it)->get_id() << ' ';
+        out << '\n';
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    ShortestPathTree<IdType, PayloadType> BasicDirectedGraph<IdType, OffsetType, PayloadType>::dijkstra(IdType source_id) const {
+        check_live_node(source_id);
+        DGRAPH_TRACE_SCOPE("dijkstra");
+        //implementation of Dijkstra's algorithm as explained here:
+        //https://en.wikipedia.org/wiki/Dijkstra%27s_algorithm
+        //instead of decreasing keys, an improved node is pushed again and its stale entries are skipped
+        typedef detail::DijkstraQueue<PayloadType, IdType> Queue;
+        ShortestPathTree<IdType, PayloadType> res(node_count_, source_id);
+        util::Vector< bool > settled(node_count_, false);
+        typename Queue::type queue;
+        queue.push(Queue::key(PayloadType()), source_id);
+
+        while (!queue.empty()) {
+            IdType current_id = queue.top().second;
+            queue.pop();
+            if (settled[current_id])
+                continue;
+            settled[current_id] = true;
+
+            const util::Vector< IdType >& current_successors = nodes_[current_id]->get_direct_successors();
+            const util::Vector< PayloadType >& weights = nodes_[current_id]->get_successor_payloads();
+            DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+            DGRAPH_TRACE_COUNT(EDGES_SCANNED, current_successors.size());
+            for (util::size_t k = 0; k < current_successors.size(); ++k) {
+                IdType next_id = current_successors[k];
+                if (overlay_.is_edge_deleted(current_id, next_id))
+                    continue;
+                if (weights[k] < PayloadType())
+                    throw bad_edge_weight();
+                PayloadType distance = res.distance(current_id) + weights[k];
+                if (!res.is_reachable(next_id) || distance < res.distance(next_id)) {
+                    res.update(next_id, distance, current_id);
+                    queue.push(Queue::key(distance), next_id);
+                }
+            }
+        }
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    ShortestPathTree<IdType, PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::dag_shortest_paths(IdType source_id) const {
+        check_live_node(source_id);
+        DGRAPH_TRACE_SCOPE("dag_shortest_paths");
+        //implementation of the DAG shortest path algorithm as explained here:
+        //https://en.wikipedia.org/wiki/Topological_sorting#Application_to_shortest_path_finding
+        ShortestPathTree<IdType, PayloadType> res(node_count_, source_id);
+        if (ids_in_topological_order()) {
+            //common for generated and imported DAGs; the nodes are then relaxed sequentially
+            for (IdType i = source_id; i < node_count_; ++i)
+                if (res.is_reachable(i))
+                    relax_successors(i, res);
+            return res;
+        }
+
+        util::Vector< const Node* > order;
+        util::Vector< char > state(node_count_, 0);
+        detail::dfs_finish_order(*this, source_id, state, order);
+        for (util::size_t position = order.size(); position > 0; --position)
+            relax_successors(order[position - 1]->get_id(), res);
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    ShortestPathTree<IdType, PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::shortest_paths(IdType source_id) const {
+        check_live_node(source_id);
+        DGRAPH_TRACE_SCOPE("shortest_paths");
+        //the dfs of the DAG algorithm is also its cycle check, so it is attempted directly
+        try {
+            return dag_shortest_paths(source_id);
+        }
+        catch (bad_top_sort&) {
+            return dijkstra(source_id);
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::output_shortest_paths(std::ostream &out,
+                                                                                   IdType source_id) const {
+        ShortestPathTree<IdType, PayloadType> res = shortest_paths(source_id);
+        for (IdType i = 0; i < node_count_; ++i)
+            if (res.is_reachable(i))
+                out << +res.distance(i) << ' ';
+            else
+                out << "inf ";
+        out << '\n';
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    DominatorTree<IdType> BasicDirectedGraph<IdType, OffsetType, PayloadType>::dominator_tree(IdType root_id) const {
+        check_live_node(root_id);
+        DGRAPH_TRACE_SCOPE("dominator_tree");
+        util::Vector< IdType > immediate_dominators;
+        detail::compute_dominators(*this, root_id, immediate_dominators);
+        return DominatorTree< IdType >(root_id, immediate_dominators);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    bool BasicDirectedGraph<IdType, OffsetType, PayloadType>::ids_in_topological_order() const {
+        for (IdType i = 0; i < node_count_; ++i) {
+            const util::Vector< IdType >& current_successors = nodes_[i]->get_direct_successors();
+            for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                 it != current_successors.end(); ++it)
+                if (*it < i)
+                    return false;
+        }
+        return true;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::relax_successors(IdType node_id,
+                                                                              ShortestPathTree<IdType, PayloadType> &res) const {
+        const util::Vector< IdType >& current_successors = nodes_[node_id]->get_direct_successors();
+        const util::Vector< PayloadType >& weights = nodes_[node_id]->get_successor_payloads();
+        DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+        DGRAPH_TRACE_COUNT(EDGES_SCANNED, current_successors.size());
+        for (util::size_t k = 0; k < current_successors.size(); ++k) {
+            IdType next_id = current_successors[k];
+            if (overlay_.is_edge_deleted(node_id, next_id))
+                continue;
+            PayloadType distance = res.distance(node_id) + weights[k];
+            if (!res.is_reachable(next_id) || distance < res.distance(next_id))
+                res.update(next_id, distance, node_id);
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::operator+(const BasicDirectedGraph& rhs) const {
+        if (rhs.node_count_ != node_count_)
+            throw bad_dgraph_config();
+        DGRAPH_TRACE_SCOPE("union");
+        util::Vector< Edge > edges;
+        collect_edges(edges);
+        rhs.collect_edges(edges);
+
+        //the sort is stable, so of two equal edges the one from this graph comes first
+        std::stable_sort(edges.begin(), edges.end());
+        util::size_t res_edge_count = 0;
+        for (util::size_t i = 0; i < edges.size(); ++i)
+            if (i == 0 || edges[i] != edges[i - 1])
+                res_edge_count++;
+        if (!detail::fits_after_adding((OffsetType)0, res_edge_count))
+            throw bad_dgraph_config(); //the edge count would not fit in OffsetType
+
+        BasicDirectedGraph res;
+        res.node_count_ = node_count_;
+        res.allocate_nodes();
+        //a node is live in the reunion if it is live in either graph
+        for (IdType i = 0; i < node_count_; ++i)
+            if (overlay_.is_node_deleted(i) && rhs.overlay_.is_node_deleted(i))
+                res.overlay_.delete_node(i);
+
+        for (util::size_t i = 0; i < edges.size(); ++i)
+            if (i == 0 || edges[i] != edges[i - 1])
+                res.add_edge(edges[i].from_node_id(), edges[i].to_node_id(), edges[i].payload());
+        res.edge_count_ = (OffsetType)res_edge_count;
+        res.rehash();
+
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< const BasicNode<IdType, PayloadType>* >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::parallel_breadth_first_search(IdType source_id) const {
+        check_live_node(source_id);
+        DGRAPH_TRACE_SCOPE("parallel_breadth_first_search");
+        //level-synchronous bfs: a node reached from the current level is claimed by the first
+        //position of the level that reaches it, then the next level is assembled chunk by chunk
+        //in position order, which is exactly the order the sequential bfs enqueues it in
+        const util::size_t grain = 1024;
+        const util::size_t unclaimed = (util::size_t)-1;
+        //owned by a smart pointer so that it is released when a parallel_for task throws
+        std::unique_ptr< std::atomic< util::size_t >[] > claims;
+
+        util::Vector< const Node* > res;
+        util::Vector< char > visited(node_count_, 0);
+        util::Vector< IdType > level(1, source_id), small_level;
+        visited[source_id] = 1;
+        while (!level.empty()) {
+            for (util::size_t k = 0; k < level.size(); ++k)
+                res.push_back(nodes_[level[k]]);
+
+            //a level that fits in one chunk is expanded directly, so that long thin graphs
+            //do not pay for the two passes on every level
+            if (level.size() <= grain) {
+                for (util::size_t position = 0; position < level.size(); ++position) {
+                    IdType current_id = level[position];
+                    const util::Vector< IdType >& current_successors = nodes_[current_id]->get_direct_successors();
+                    for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                         it != current_successors.end(); ++it)
+                        if (!visited[*it] && !overlay_.is_edge_deleted(current_id, *it)) {
+                            visited[*it] = 1;
+                            small_level.push_back(*it);
+                        }
+                }
+                while (!level.empty())
+                    level.pop_back();
+                for (util::size_t k = 0; k < small_level.size(); ++k)
+                    level.push_back(small_level[k]);
+                while (!small_level.empty())
+                    small_level.pop_back();
+                continue;
+            }
+
+            if (!claims) {
+                claims.reset(new std::atomic< util::size_t >[node_count_]);
+                util::parallel_for(0, node_count_, 1 << 16, [&](util::size_t begin, util::size_t end) {
+                    for (util::size_t i = begin; i < end; ++i)
+                        claims[i].store(unclaimed, std::memory_order_relaxed);
+                });
+            }
+            util::parallel_for(0, level.size(), grain, [&](util::size_t begin, util::size_t end) {
+                for (util::size_t position = begin; position < end; ++position) {
+                    IdType current_id = level[position];
+                    const util::Vector< IdType >& current_successors = nodes_[current_id]->get_direct_successors();
+                    for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                         it != current_successors.end(); ++it)
+                        if (!visited[*it] && !overlay_.is_edge_deleted(current_id, *it)) {
+                            util::size_t claim = claims[*it].load(std::memory_order_relaxed);
+                            while (position < claim &&
+                                   !claims[*it].compare_exchange_weak(claim, position, std::memory_order_relaxed)) {}
+                        }
+                }
+            });
+
+            util::Vector< util::Vector< IdType > > next((level.size() + grain - 1) / grain);
+            util::parallel_for(0, level.size(), grain, [&](util::size_t begin, util::size_t end) {
+                util::Vector< IdType >& chunk = next[begin / grain];
+                for (util::size_t position = begin; position < end; ++position) {
+                    IdType current_id = level[position];
+                    const util::Vector< IdType >& current_successors = nodes_[current_id]->get_direct_successors();
+                    for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                         it != current_successors.end(); ++it)
+                        if (!visited[*it] && claims[*it].load(std::memory_order_relaxed) == position &&
+                                !overlay_.is_edge_deleted(current_id, *it))
+                            chunk.push_back(*it);
+                }
+            });
+
+            while (!level.empty())
+                level.pop_back();
+            for (util::size_t c = 0; c < next.size(); ++c)
+                for (util::size_t k = 0; k < next[c].size(); ++k) {
+                    visited[next[c][k]] = 1;
+                    level.push_back(next[c][k]);
+                }
+        }
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< util::Vector< const BasicNode<IdType, PayloadType>* > >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::parallel_strongly_connected_components() const {
+        DGRAPH_TRACE_SCOPE("parallel_strongly_connected_components");
+        util::Vector< util::Vector< const Node* > > res;
+        detail::ParallelScc< BasicDirectedGraph > scc(*this);
+        scc.run(res);
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< util::Vector< bool > > BasicDirectedGraph<IdType, OffsetType, PayloadType>::parallel_path_matrix(OperationMonitor* monitor) const {
+        DGRAPH_TRACE_SCOPE("parallel_path_matrix");
+        if (monitor != NULL)
+            monitor->start(node_count_);
+        //row i is the set of nodes reached by a search from i, so the rows are independent
+        util::Vector< util::Vector< bool > > res(node_count_, util::Vector< bool >(node_count_, false));
+        util::WorkerLocal< util::Vector< IdType > > stacks;
+        util::parallel_for(0, node_count_, 1, [&](util::size_t begin, util::size_t end) {
+            util::Vector< IdType >& stack = stacks.local();
+            for (util::size_t i = begin; i < end; ++i) {
+                if (monitor != NULL)
+                    monitor->advance();
+                if (overlay_.is_node_deleted((IdType)i))
+                    continue;
+                util::Vector< bool >& row = res[i];
+                row[i] = true;
+                stack.push_back((IdType)i);
+                while (!stack.empty()) {
+                    IdType current_id = stack.back();
+                    stack.pop_back();
+                    const util::Vector< IdType >& current_successors = nodes_[current_id]->get_direct_successors();
+                    for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                         it != current_successors.end(); ++it)
+                        if (!row[*it] && !overlay_.is_edge_deleted(current_id, *it)) {
+                            row[*it] = true;
+                            stack.push_back(*it);
+                        }
+                }
+            }
+        });
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::parallel_union(const BasicDirectedGraph& rhs) const {
+        if (rhs.node_count_ != node_count_)
+            throw bad_dgraph_config();
+        DGRAPH_TRACE_SCOPE("parallel_union");
+        BasicDirectedGraph res;
+        res.node_count_ = node_count_;
+        res.allocate_nodes();
+        for (IdType i = 0; i < node_count_; ++i)
+            if (overlay_.is_node_deleted(i) && rhs.overlay_.is_node_deleted(i)) {
+                res.overlay_.delete_node(i);
+                res.deleted_node_hash_sum_ += detail::deleted_node_hash(i);
+            }
+
+        //both lists of a node are sorted, so every node is merged on its own
+        util::WorkerLocal< unsigned long long > edge_counts(0);
+        util::WorkerLocal< unsigned long long > edge_hash_sums(0);
+        util::parallel_for(0, node_count_, 512, [&](util::size_t begin, util::size_t end) {
+            unsigned long long& edge_count = edge_counts.local();
+            unsigned long long& edge_hash_sum = edge_hash_sums.local();
+            for (util::size_t i = begin; i < end; ++i) {
+                edge_count += merge_successors((IdType)i, rhs, res.nodes_[i]);
+                merge_predecessors((IdType)i, rhs, res.nodes_[i]);
+                const util::Vector< IdType >& successors = res.nodes_[i]->get_direct_successors();
+                for (util::size_t k = 0; k < successors.size(); ++k)
+                    edge_hash_sum += detail::edge_hash(i, successors[k]);
+            }
+        });
+        //the counts are summed without overflow, then checked against OffsetType
+        unsigned long long edge_count = 0;
+        for (util::size_t k = 0; k < edge_counts.size(); ++k) {
+            edge_count += edge_counts[k];
+            res.edge_hash_sum_ += edge_hash_sums[k];
+        }
+        if (!detail::fits_after_adding((OffsetType)0, edge_count))
+            throw bad_dgraph_config(); //the edge count would not fit in OffsetType
+        res.edge_count_ = (OffsetType)edge_count;
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::transitive_reduction(OffsetType* removed_edge_count,
+                                                                          OperationMonitor* monitor) const {
+        //the sort is linear, only the slices are counted
+        if (monitor != NULL)
+            monitor->check();
+        util::Vector< const Node* > order = topological_sort();
+        DGRAPH_TRACE_SCOPE("transitive_reduction");
+        //every worker holds the rows of one slice, at most about this many bytes
+        const util::size_t slice_bytes = 1 << 24;
+
+        //the live successors of the node at every topological position, as positions, sorted
+        util::size_t count = order.size();
+        util::Vector< util::size_t > position(node_count_, 0), first(count + 1, 0), targets;
+        for (util::size_t k = 0; k < count; ++k)
+            position[order[k]->get_id()] = k;
+        for (util::size_t k = 0; k < count; ++k) {
+            IdType id = order[k]->get_id();
+            const util::Vector< IdType >& successors = order[k]->get_direct_successors();
+            for (util::size_t j = 0; j < successors.size(); ++j)
+                if (!overlay_.is_edge_deleted(id, successors[j]))
+                    targets.push_back(position[successors[j]]);
+            std::sort(targets.begin() + first[k], targets.end());
+            first[k + 1] = targets.size();
+        }
+
+        //slice s covers the columns [s * width, (s + 1) * width); only the rows before its last
+        //column can reach it. An edge is tested by the slice of its target, so every flag of
+        //redundant has a single writer
+        util::Vector< char > redundant(targets.size(), 0);
+        util::size_t words = std::max((util::size_t)1, std::min((util::size_t)64,
+                                      (util::size_t)(slice_bytes / (sizeof(unsigned long long) * std::max(count, (util::size_t)1)))));
+        util::size_t width = 64 * words, slice_count = (count + width - 1) / width;
+        if (monitor != NULL)
+            monitor->start(slice_count);
+        util::WorkerLocal< util::Vector< unsigned long long > > rows;
+        util::parallel_for(0, slice_count, 1, [&](util::size_t slice_begin, util::size_t slice_end) {
+            util::Vector< unsigned long long >& reach = rows.local();
+            for (util::size_t slice = slice_begin; slice < slice_end; ++slice) {
+                if (monitor != NULL)
+                    monitor->advance();
+                util::size_t column_begin = slice * width, column_end = std::min(count, column_begin + width);
+                if (reach.size() < column_end * words)
+                    reach = util::Vector< unsigned long long >(column_end * words, 0);
+                for (util::size_t k = column_end; k-- > 0; ) {
+                    //first the descendants of the successors, then the successors themselves
+                    unsigned long long* row = reach.begin() + k * words;
+                    for (util::size_t w = 0; w < words; ++w)
+                        row[w] = 0;
+                    util::size_t e = first[k];
+                    for (; e < first[k + 1] && targets[e] < column_end; ++e) {
+                        const unsigned long long* successor_row = reach.begin() + targets[e] * words;
+                        for (util::size_t w = 0; w < words; ++w)
+                            row[w] |= successor_row[w];
+                    }
+                    for (util::size_t j = first[k]; j < e; ++j) {
+                        if (targets[j] < column_begin)
+                            continue;
+                        util::size_t column = targets[j] - column_begin;
+                        unsigned long long bit = 1ULL << (column % 64);
+                        if (row[column / 64] & bit)
+                            redundant[j] = 1;
+                        row[column / 64] |= bit;
+                    }
+                }
+            }
+        });
+
+        BasicDirectedGraph res;
+        res.node_count_ = node_count_;
+        res.allocate_nodes();
+        OffsetType removed = 0;
+        for (IdType i = 0; i < node_count_; ++i) {
+            if (overlay_.is_node_deleted(i)) {
+                res.overlay_.delete_node(i);
+                continue;
+            }
+            //the ids are taken in increasing order, so the predecessor lists come out sorted
+            util::size_t k = position[i];
+            const util::Vector< IdType >& successors = nodes_[i]->get_direct_successors();
+            for (util::size_t j = 0; j < successors.size(); ++j) {
+                if (overlay_.is_edge_deleted(i, successors[j]))
+                    continue;
+                util::size_t e = std::lower_bound(targets.begin() + first[k], targets.begin() + first[k + 1],
+                                                  position[successors[j]]) - targets.begin();
+                if (redundant[e]) {
+                    removed++;
+                    continue;
+                }
+                res.nodes_[i]->add_direct_successor(successors[j], nodes_[i]->get_successor_payload(j));
+                res.nodes_[successors[j]]->add_direct_predecessor(i);
+                res.edge_count_++;
+            }
+        }
+        res.rehash();
+        if (removed_edge_count != NULL)
+            *removed_edge_count = removed;
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< double >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::approximate_descendant_counts(double relative_error,
+                                                                                     OperationMonitor* monitor) const {
+        if (!(relative_error > 0))
+            throw bad_dgraph_config();
+        //the components are linear, only the slices are counted
+        if (monitor != NULL)
+            monitor->check();
+        //Tarjan's algorithm emits every component after all the components it reaches
+        util::Vector< util::Vector< const Node* > > scc = get_strongly_connected_components();
+        DGRAPH_TRACE_SCOPE("approximate_descendant_counts");
+        unsigned int precision = detail::hyperloglog_precision(relative_error);
+        util::size_t registers = (util::size_t)1 << precision, count = scc.size();
+
+        //the distinct components reached by an edge from every component, all of them emitted before it
+        util::Vector< util::size_t > component(node_count_, 0), first(count + 1, 0), targets;
+        for (util::size_t c = 0; c < count; ++c)
+            for (util::size_t k = 0; k < scc[c].size(); ++k)
+                component[scc[c][k]->get_id()] = c;
+        util::Vector< util::size_t > last_source(count, count);
+        for (util::size_t c = 0; c < count; ++c) {
+            for (util::size_t k = 0; k < scc[c].size(); ++k) {
+                IdType id = scc[c][k]->get_id();
+                const util::Vector< IdType >& successors = scc[c][k]->get_direct_successors();
+                for (util::size_t j = 0; j < successors.size(); ++j) {
+                    util::size_t target = component[successors[j]];
+                    if (target == c || last_source[target] == c || overlay_.is_edge_deleted(id, successors[j]))
+                        continue;
+                    last_source[target] = c;
+                    targets.push_back(target);
+                }
+            }
+            first[c + 1] = targets.size();
+        }
+
+        //the sketch of every component, a row of registers, starts from the hashes of its own nodes
+        util::Vector< unsigned char > sketches(count * registers, 0);
+        util::parallel_for(0, count, 1024, [&](util::size_t begin, util::size_t end) {
+            for (util::size_t c = begin; c < end; ++c)
+                for (util::size_t k = 0; k < scc[c].size(); ++k)
+                    detail::hyperloglog_add(sketches.begin() + c * registers, precision,
+                                            detail::mix_hash((unsigned long long)scc[c][k]->get_id()));
+        });
+
+        //every slice merges its registers along the whole condensation, independently of the others
+        util::size_t width = std::min(registers, (util::size_t)64), slice_count = registers / width;
+        if (monitor != NULL)
+            monitor->start(slice_count);
+        util::parallel_for(0, slice_count, 1, [&](util::size_t slice_begin, util::size_t slice_end) {
+            for (util::size_t slice = slice_begin; slice < slice_end; ++slice) {
+                if (monitor != NULL)
+                    monitor->advance();
+                for (util::size_t c = 0; c < count; ++c) {
+                    unsigned char* row = sketches.begin() + c * registers + slice * width;
+                    for (util::size_t e = first[c]; e < first[c + 1]; ++e) {
+                        const unsigned char* successor_row = sketches.begin() + targets[e] * registers + slice * width;
+                        for (util::size_t r = 0; r < width; ++r)
+                            row[r] = std::max(row[r], successor_row[r]);
+                    }
+                }
+            }
+        });
+
+        util::Vector< double > res(node_count_, 0.0);
+        util::parallel_for(0, count, 1024, [&](util::size_t begin, util::size_t end) {
+            for (util::size_t c = begin; c < end; ++c) {
+                //a node reaches at least its own component and at most every live node
+                double estimate = detail::hyperloglog_estimate(sketches.begin() + c * registers, precision);
+                estimate = std::min(std::max(estimate, (double)scc[c].size()), (double)live_node_count());
+                for (util::size_t k = 0; k < scc[c].size(); ++k)
+                    res[scc[c][k]->get_id()] = estimate;
+            }
+        });
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::Vector< float > BasicDirectedGraph<IdType, OffsetType, PayloadType>::page_rank(double damping, double tolerance,
+                                                                                     unsigned int max_iterations,
+                                                                                     const util::Vector< float >* warm_start,
+                                                                                     OperationMonitor* monitor) const {
+        if (!(damping >= 0 && damping < 1) || !(tolerance >= 0) ||
+                (warm_start != NULL && warm_start->size() > (util::size_t)node_count_))
+            throw bad_dgraph_config();
+        DGRAPH_TRACE_SCOPE("page_rank");
+        if (monitor != NULL)
+            monitor->start(max_iterations);
+        const util::size_t grain = 4096;
+        IdType live_count = live_node_count();
+        if (live_count == 0) {
+            if (monitor != NULL)
+                monitor->advance(max_iterations);
+            return util::Vector< float >(node_count_, 0.0f);
+        }
+
+        //the live predecessors of every node, one list after the other, and the inverse of every
+        //live out-degree, which is 0 for the nodes whose rank is spread evenly
+        util::Vector< OffsetType > first(node_count_ + 1, 0);
+        util::Vector< IdType > sources;
+        sources.reserve(edge_count_);
+        util::Vector< float > inverse_degree(node_count_, 0.0f);
+        for (IdType i = 0; i < node_count_; ++i) {
+            const util::Vector< IdType >& predecessors = nodes_[i]->get_direct_predecessors();
+            for (util::size_t k = 0; k < predecessors.size(); ++k)
+                if (!overlay_.is_edge_deleted(predecessors[k], i))
+                    sources.push_back(predecessors[k]);
+            first[i + 1] = (OffsetType)sources.size();
+            IdType degree = live_out_degree(i);
+            if (degree > 0)
+                inverse_degree[i] = 1.0f / (float)degree;
+        }
+
+        //the rank and the share it sends along every edge, for the current pass and the next one
+        util::Vector< float > ranks[2], shares[2];
+        for (int k = 0; k < 2; ++k) {
+            ranks[k] = util::Vector< float >(node_count_, 0.0f);
+            shares[k] = util::Vector< float >(node_count_, 0.0f);
+        }
+        double total = 0, dangling = 0;
+        for (IdType i = 0; i < node_count_; ++i) {
+            if (overlay_.is_node_deleted(i))
+                continue;
+            float initial = 1.0f / (float)live_count;
+            if (warm_start != NULL && (util::size_t)i < warm_start->size())
+                initial = std::max((*warm_start)[i], 0.0f);
+            ranks[0][i] = initial;
+            total += initial;
+        }
+        for (IdType i = 0; i < node_count_; ++i) {
+            ranks[0][i] = (total > 0 ? (float)(ranks[0][i] / total) :
+                           overlay_.is_node_deleted(i) ? 0.0f : 1.0f / (float)live_count);
+            shares[0][i] = ranks[0][i] * inverse_degree[i];
+            if (inverse_degree[i] == 0)
+                dangling += ranks[0][i];
+        }
+
+        int current = 0;
+        for (unsigned int iteration = 0; iteration < max_iterations; ++iteration) {
+            const float* rank = ranks[current].begin();
+            const float* share = shares[current].begin();
+            float* next_rank = ranks[1 - current].begin();
+            float* next_share = shares[1 - current].begin();
+            float base = (float)((1 - damping + damping * dangling) / live_count), factor = (float)damping;
+            //every range also prepares the shares of the next pass and sums up its part of the spread
+            //rank and of the distance
+            util::WorkerLocal< double > next_danglings(0.0), distances(0.0);
+            util::parallel_for(0, node_count_, grain, [&](util::size_t begin, util::size_t end) {
+                double range_dangling = 0, range_distance = 0;
+                for (util::size_t i = begin; i < end; ++i) {
+                    if (overlay_.is_node_deleted((IdType)i))
+                        continue;
+                    float sum = 0;
+                    for (OffsetType k = first[i]; k < first[i + 1]; ++k)
+                        sum += share[sources[k]];
+                    float value = base + factor * sum;
+                    next_rank[i] = value;
+                    next_share[i] = value * inverse_degree[i];
+                    if (inverse_degree[i] == 0)
+                        range_dangling += value;
+                    range_distance += std::fabs((double)value - (double)rank[i]);
+                }
+                next_danglings.local() += range_dangling;
+                distances.local() += range_distance;
+            });
+            double distance = 0;
+            dangling = 0;
+            for (util::size_t k = 0; k < distances.size(); ++k) {
+                distance += distances[k];
+                dangling += next_danglings[k];
+            }
+            current = 1 - current;
+            if (monitor != NULL)
+                monitor->advance();
+            if (distance <= tolerance) {
+                //the passes left out are counted as done, so that done() reaches total() at the end
+                if (monitor != NULL)
+                    monitor->advance(max_iterations - iteration - 1);
+                break;
+            }
+        }
+        return ranks[current];
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    AsyncOperation< util::Vector< util::Vector< bool > > >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::async_path_matrix() const {
+        const BasicDirectedGraph* graph = this;
+        return AsyncOperation< util::Vector< util::Vector< bool > > >([graph](OperationMonitor& monitor) {
+            return graph->get_path_matrix(&monitor);
+        });
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    AsyncOperation< util::Vector< util::Vector< bool > > >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::async_parallel_path_matrix() const {
+        const BasicDirectedGraph* graph = this;
+        return AsyncOperation< util::Vector< util::Vector< bool > > >([graph](OperationMonitor& monitor) {
+            return graph->parallel_path_matrix(&monitor);
+        });
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    AsyncOperation< util::Vector< util::Vector< const BasicNode<IdType, PayloadType>* > > >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::async_strongly_connected_components() const {
+        const BasicDirectedGraph* graph = this;
+        return AsyncOperation< util::Vector< util::Vector< const Node* > > >([graph](OperationMonitor& monitor) {
+            return graph->get_strongly_connected_components(&monitor);
+        });
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    AsyncOperation< util::Vector< const BasicNode<IdType, PayloadType>* > >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::async_topological_sort() const {
+        const BasicDirectedGraph* graph = this;
+        return AsyncOperation< util::Vector< const Node* > >([graph](OperationMonitor& monitor) {
+            return graph->topological_sort(&monitor);
+        });
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    AsyncOperation< BasicDirectedGraph<IdType, OffsetType, PayloadType> >
+    BasicDirectedGraph<IdType, OffsetType, PayloadType>::async_transitive_reduction() const {
+        const BasicDirectedGraph* graph = this;
+        return AsyncOperation< BasicDirectedGraph >([graph](OperationMonitor& monitor) {
+            return graph->transitive_reduction(NULL, &monitor);
+        });
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::size_t BasicDirectedGraph<IdType, OffsetType, PayloadType>::merge_successors(IdType id,
+                                                                                    const BasicDirectedGraph &rhs,
+                                                                                    Node *node) const {
+        const util::Vector< IdType >& lhs_successors = nodes_[id]->get_direct_successors();
+        const util::Vector< IdType >& rhs_successors = rhs.nodes_[id]->get_direct_successors();
+        util::size_t lhs_k = 0, rhs_k = 0;
+        util::size_t added = 0;
+        for (;;) {
+            while (lhs_k < lhs_successors.size() && overlay_.is_edge_deleted(id, lhs_successors[lhs_k]))
+                lhs_k++;
+            while (rhs_k < rhs_successors.size() && rhs.overlay_.is_edge_deleted(id, rhs_successors[rhs_k]))
+                rhs_k++;
+            if (lhs_k == lhs_successors.size() && rhs_k == rhs_successors.size())
+                return added;
+            if (rhs_k == rhs_successors.size() ||
+                    (lhs_k < lhs_successors.size() && lhs_successors[lhs_k] <= rhs_successors[rhs_k])) {
+                if (rhs_k < rhs_successors.size() && rhs_successors[rhs_k] == lhs_successors[lhs_k])
+                    rhs_k++;
+                node->add_direct_successor(lhs_successors[lhs_k], nodes_[id]->get_successor_payload(lhs_k));
+                lhs_k++;
+            }
+            else {
+                node->add_direct_successor(rhs_successors[rhs_k], rhs.nodes_[id]->get_successor_payload(rhs_k));
+                rhs_k++;
+            }
+            added++;
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    util::size_t BasicDirectedGraph<IdType, OffsetType, PayloadType>::merge_predecessors(IdType id,
+                                                                                      const BasicDirectedGraph &rhs,
+                                                                                      Node *node) const {
+        const util::Vector< IdType >& lhs_predecessors = nodes_[id]->get_direct_predecessors();
+        const util::Vector< IdType >& rhs_predecessors = rhs.nodes_[id]->get_direct_predecessors();
+        util::size_t lhs_k = 0, rhs_k = 0;
+        util::size_t added = 0;
+        for (;;) {
+            while (lhs_k < lhs_predecessors.size() && overlay_.is_edge_deleted(lhs_predecessors[lhs_k], id))
+                lhs_k++;
+            while (rhs_k < rhs_predecessors.size() && rhs.overlay_.is_edge_deleted(rhs_predecessors[rhs_k], id))
+                rhs_k++;
+            if (lhs_k == lhs_predecessors.size() && rhs_k == rhs_predecessors.size())
+                return added;
+            if (rhs_k == rhs_predecessors.size() ||
+                    (lhs_k < lhs_predecessors.size() && lhs_predecessors[lhs_k] <= rhs_predecessors[rhs_k])) {
+                if (rhs_k < rhs_predecessors.size() && rhs_predecessors[rhs_k] == lhs_predecessors[lhs_k])
+                    rhs_k++;
+                node->add_direct_predecessor(lhs_predecessors[lhs_k++]);
+            }
+            else
+                node->add_direct_predecessor(rhs_predecessors[rhs_k++]);
+            added++;
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    NodePermutation BasicDirectedGraph<IdType, OffsetType, PayloadType>::compute_ordering(ReorderStrategy strategy) const {
+        DGRAPH_TRACE_SCOPE("compute_ordering");
+        util::Vector<int> order;
+        switch (strategy) {
+            case BFS_ORDER:
+                bfs_order(order);
+                break;
+            case REVERSE_CUTHILL_MCKEE:
+                reverse_cuthill_mckee_order(order);
+                break;
+            case DEGREE_SORTED:
+                degree_sorted_order(order);
+                break;
+            default:
+                throw bad_dgraph_config();
+        }
+        return NodePermutation(order);
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::apply_permutation(const NodePermutation &permutation) {
+        if ((std::size_t)permutation.node_count() != (std::size_t)node_count_)
+            throw bad_dgraph_config();
+        DGRAPH_TRACE_SCOPE("apply_permutation");
+
+        util::Vector< Edge > edges;
+        collect_edges(edges);
+        for (util::size_t i = 0; i < edges.size(); ++i)
+            edges[i] = Edge((IdType)permutation.to_new_id((int)edges[i].from_node_id()),
+                            (IdType)permutation.to_new_id((int)edges[i].to_node_id()),
+                            edges[i].payload());
+        std::sort(edges.begin(), edges.end());
+
+        //the deleted edges were not collected, only the deleted nodes have to be relabeled
+        DeltaOverlay< IdType > overlay;
+        for (IdType i = 0; i < node_count_; ++i)
+            if (overlay_.is_node_deleted(i))
+                overlay.delete_node((IdType)permutation.to_new_id((int)i));
+        overlay_ = overlay;
+
+        //the nodes are reallocated in the new order, so that consecutive ids
+        //are also likely to be close to each other on the heap
+        allocate_nodes();
+        for (util::size_t i = 0; i < edges.size(); ++i)
+            add_edge(edges[i].from_node_id(), edges[i].to_node_id(), edges[i].payload());
+        rehash();
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    NodePermutation BasicDirectedGraph<IdType, OffsetType, PayloadType>::reorder(ReorderStrategy strategy) {
+        NodePermutation permutation = compute_ordering(strategy);
+        apply_permutation(permutation);
+        return permutation;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::bfs_order(util::Vector<int> &order) const {
+        //nodes are numbered in bfs order, starting a new bfs from the smallest
+        //unreached id whenever the previous one runs out of nodes
+        util::Vector< bool > visited(node_count_, false);
+        util::Queue< IdType > queue;
+        order.clear();
+
+        for (IdType source = 0; source < node_count_; ++source) {
+            if (visited[source])
+                continue;
+            visited[source] = true;
+            queue.push(source);
+            while (!queue.empty()) {
+                IdType current_id = queue.front();
+                queue.pop();
+                order.push_back((int)current_id);
+
+                const util::Vector< IdType >& current_successors = nodes_[current_id]->get_direct_successors();
+                for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                     it != current_successors.end(); ++it)
+                    if (!visited[*it] && !overlay_.is_edge_deleted(current_id, *it)) {
+                        visited[*it] = true;
+                        queue.push(*it);
+                    }
+            }
+        }
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::reverse_cuthill_mckee_order(util::Vector<int> &order) const {
+        //implementation of the Reverse Cuthill-McKee ordering as explained here:
+        //https://en.wikipedia.org/wiki/Cuthill%E2%80%93McKee_algorithm
+        //the graph is treated as undirected, so both successors and predecessors are neighbors
+        util::Vector< int > degree(node_count_, 0);
+        util::Vector< int > by_degree(node_count_, 0);
+        for (IdType i = 0; i < node_count_; ++i) {
+            degree[i] = (int)live_in_degree(i) + (int)live_out_degree(i);
+            by_degree[i] = (int)i;
+        }
+        detail::CompareByKey by_increasing_degree(degree, false);
+        std::sort(by_degree.begin(), by_degree.end(), by_increasing_degree);
+
+        util::Vector< bool > visited(node_count_, false);
+        util::Vector< int > neighbors;
+        order.clear();
+
+        //each connected component is started from its node of minimum degree
+        for (IdType k = 0; k < node_count_; ++k) {
+            int source = by_degree[k];
+            if (visited[source])
+                continue;
+            visited[source] = true;
+            //order itself is used as the bfs queue
+            util::size_t head = order.size();
+            order.push_back(source);
+            while (head < order.size()) {
+                int current_id = order[head++];
+                neighbors.clear();
+                const util::Vector< IdType >& current_successors = nodes_[current_id]->get_direct_successors();
+                for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                     it != current_successors.end(); ++it)
+                    if (!visited[*it] && !overlay_.is_edge_deleted((IdType)current_id, *it)) {
+                        visited[*it] = true;
+                        neighbors.push_back((int)*it);
+                    }
+                const util::Vector< IdType >& current_predecessors = nodes_[current_id]->get_direct_predecessors();
+                for (typename util::Vector< IdType >::const_iterator it = current_predecessors.begin();
+                     it != current_predecessors.end(); ++it)
+                    if (!visited[*it] && !overlay_.is_edge_deleted(*it, (IdType)current_id)) {
+                        visited[*it] = true;
+                        neighbors.push_back((int)*it);
+                    }
+                std::sort(neighbors.begin(), neighbors.end(), by_increasing_degree);
+                for (util::Vector< int >::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+                    order.push_back(*it);
+            }
+        }
+        std::reverse(order.begin(), order.end());
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::degree_sorted_order(util::Vector<int> &order) const {
+        //hubs come first, so the most frequently accessed nodes share the same cache lines
+        util::Vector< int > degree(node_count_, 0);
+        order = util::Vector< int >(node_count_, 0);
+        for (IdType i = 0; i < node_count_; ++i) {
+            degree[i] = (int)live_in_degree(i) + (int)live_out_degree(i);
+            order[i] = (int)i;
+        }
+        std::sort(order.begin(), order.end(), detail::CompareByKey(degree, true));
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    MemoryUsage BasicDirectedGraph<IdType, OffsetType, PayloadType>::memory_usage() const {
+        MemoryUsage res;
+        res.node_table_bytes = nodes_.capacity() * sizeof(Node*);
+        res.node_object_bytes = node_count_ * sizeof(Node);
+        for (IdType i = 0; i < node_count_; ++i) {
+            res.successor_list_bytes += nodes_[i]->get_direct_successors().capacity() * sizeof(IdType);
+            res.predecessor_list_bytes += nodes_[i]->get_direct_predecessors().capacity() * sizeof(IdType);
+            res.payload_list_bytes += nodes_[i]->get_payload_bytes();
+        }
+        res.overlay_bytes = overlay_.memory_bytes();
+        return res;
+    }
+
+    template<typename IdType, typename OffsetType, typename PayloadType>
+    void BasicDirectedGraph<IdType, OffsetType, PayloadType>::output_memory_usage(std::ostream &out) const {
+        MemoryUsage usage = memory_usage();
+        out << "node table: " << usage.node_table_bytes << " bytes\n"
+            << "node objects: " << usage.node_object_bytes << " bytes\n"
+            << "successor lists: " << usage.successor_list_bytes << " bytes\n"
+            << "predecessor lists: " << usage.predecessor_list_bytes << " bytes\n"
+            << "payload lists: " << usage.payload_list_bytes << " bytes\n"
+            << "delta overlay: " << usage.overlay_bytes << " bytes\n"
+            << "total: " << usage.total_bytes() << " bytes\n";
+    }
+
+
+    //implementation of ParallelScc's methods
+    namespace detail {
+        template<typename Graph>
+        ParallelScc<Graph>::ParallelScc(const Graph &graph) :
+                graph_(graph), node_count_(graph.node_count()),
+                labels_(new std::atomic< long long >[graph.node_count()]), next_label_(1),
+                in_degree_(graph.node_count(), 0), out_degree_(graph.node_count(), 0) {}
+
+        template<typename Graph>
+        ParallelScc<Graph>::~ParallelScc() {
+            delete[] labels_;
+        }
+
+        template<typename Graph>
+        void ParallelScc<Graph>::run(util::Vector<util::Vector<const Node *> > &res) {
+            //every live node starts in the set labeled 0, deleted nodes belong to no set
+            util::Vector< IdType >* set = new util::Vector< IdType >();
+            for (IdType i = 0; i < node_count_; ++i)
+                if (graph_.is_node_deleted(i))
+                    labels_[i].store(-1, std::memory_order_relaxed);
+                else {
+                    labels_[i].store(0, std::memory_order_relaxed);
+                    set->push_back(i);
+                }
+            spawn(set, 0);
+            group_.wait();
+
+            //the components come out in no particular order, so they are sorted by their smallest id
+            util::Vector< int > first_ids;
+            util::Vector< std::pair<util::size_t, util::size_t> > positions;
+            for (util::size_t w = 0; w < components_.size(); ++w)
+                for (util::size_t c = 0; c < components_[w].size(); ++c) {
+                    positions.push_back(std::make_pair(w, c));
+                    first_ids.push_back((int)components_[w][c][0]->get_id());
+                }
+            util::Vector< int > order(positions.size(), 0);
+            for (util::size_t k = 0; k < order.size(); ++k)
+                order[k] = (int)k;
+            std::sort(order.begin(), order.end(), CompareByKey(first_ids, false));
+            res.reserve(order.size());
+            for (util::size_t k = 0; k < order.size(); ++k)
+                res.push_back(components_[positions[order[k]].first][positions[order[k]].second]);
+        }
+
+        template<typename Graph>
+        void ParallelScc<Graph>::spawn(util::Vector<IdType> *set, long long label) {
+            group_.run([this, set, label]() { solve(set, label); });
+        }
+
+        template<typename Graph>
+        void ParallelScc<Graph>::emit(const util::Vector<IdType> &component) {
+            util::Vector< IdType > ids(component);
+            std::sort(ids.begin(), ids.end());
+            util::Vector< const Node* > nodes;
+            nodes.reserve(ids.size());
+            for (util::size_t k = 0; k < ids.size(); ++k)
+                nodes.push_back(graph_.get_node_by_id(ids[k]));
+            components_.local().push_back(nodes);
+        }
+
+        template<typename Graph>
+        void ParallelScc<Graph>::solve(util::Vector<IdType> *set, long long label) {
+            trim(*set, label);
+            if (set->empty()) {
+                delete set;
+                return;
+            }
+
+            //forward search from the pivot, relabeling what it reaches as forward_label,
+            //then backward search through both labels: forward nodes it reaches form the component
+            long long forward_label = next_label_.fetch_add(3);
+            long long component_label = forward_label + 1, backward_label = forward_label + 2;
+            IdType pivot = (*set)[0];
+            util::Vector< IdType >& stack = stacks_.local();
+            labels_[pivot].store(forward_label, std::memory_order_relaxed);
+            stack.push_back(pivot);
+            while (!stack.empty()) {
+                IdType current_id = stack.back();
+                stack.pop_back();
+                const util::Vector< IdType >& successors = successor_list(graph_, current_id);
+                for (typename util::Vector< IdType >::const_iterator it = successors.begin(); it != successors.end(); ++it)
+                    if (labels_[*it].load(std::memory_order_relaxed) == label &&
+                            !graph_.is_edge_deleted(current_id, *it)) {
+                        labels_[*it].store(forward_label, std::memory_order_relaxed);
+                        stack.push_back(*it);
+                    }
+            }
+
+            labels_[pivot].store(component_label, std::memory_order_relaxed);
+            stack.push_back(pivot);
+            while (!stack.empty()) {
+                IdType current_id = stack.back();
+                stack.pop_back();
+                const util::Vector< IdType >& predecessors = predecessor_list(graph_, current_id);
+                for (typename util::Vector< IdType >::const_iterator it = predecessors.begin(); it != predecessors.end(); ++it) {
+                    long long current_label = labels_[*it].load(std::memory_order_relaxed);
+                    if ((current_label != label && current_label != forward_label) ||
+                            graph_.is_edge_deleted(*it, current_id))
+                        continue;
+                    labels_[*it].store(current_label == forward_label ? component_label : backward_label,
+                                       std::memory_order_relaxed);
+                    stack.push_back(*it);
+                }
+            }
+
+            util::Vector< IdType > component;
+            util::Vector< IdType >* forward = new util::Vector< IdType >();
+            util::Vector< IdType >* backward = new util::Vector< IdType >();
+            util::Vector< IdType >* rest = new util::Vector< IdType >();
+            for (util::size_t k = 0; k < set->size(); ++k) {
+                IdType id = (*set)[k];
+                long long current_label = labels_[id].load(std::memory_order_relaxed);
+                if (current_label == component_label)
+                    component.push_back(id);
+                else if (current_label == forward_label)
+                    forward->push_back(id);
+                else if (current_label == backward_label)
+                    backward->push_back(id);
+                else
+                    rest->push_back(id);
+            }
+            delete set;
+            emit(component);
+
+            util::Vector< IdType >* parts[3] = {forward, backward, rest};
+            long long part_labels[3] = {forward_label, backward_label, label};
+            for (int k = 0; k < 3; ++k)
+                if (parts[k]->empty())
+                    delete parts[k];
+                else
+                    spawn(parts[k], part_labels[k]);
+        }
+
+        template<typename Graph>
+        void ParallelScc<Graph>::trim(util::Vector<IdType> &set, long long label) {
+            //a node without incoming or outgoing edges inside the set is a component by itself;
+            //removing it may expose more such nodes, so they are peeled with a worklist
+            long long trimmed_label = next_label_.fetch_add(1);
+            util::Vector< IdType >& stack = stacks_.local();
+            util::Vector< IdType > single(1, 0);
+            for (util::size_t k = 0; k < set.size(); ++k) {
+                IdType id = set[k];
+                const util::Vector< IdType >& successors = successor_list(graph_, id);
+                const util::Vector< IdType >& predecessors = predecessor_list(graph_, id);
+                out_degree_[id] = in_degree_[id] = 0;
+                for (typename util::Vector< IdType >::const_iterator it = successors.begin(); it != successors.end(); ++it)
+                    if (labels_[*it].load(std::memory_order_relaxed) == label && !graph_.is_edge_deleted(id, *it))
+                        out_degree_[id]++;
+                for (typename util::Vector< IdType >::const_iterator it = predecessors.begin(); it != predecessors.end(); ++it)
+                    if (labels_[*it].load(std::memory_order_relaxed) == label && !graph_.is_edge_deleted(*it, id))
+                        in_degree_[id]++;
+            }
+            for (util::size_t k = 0; k < set.size(); ++k)
+                if (in_degree_[set[k]] == 0 || out_degree_[set[k]] == 0) {
+                    labels_[set[k]].store(trimmed_label, std::memory_order_relaxed);
+                    stack.push_back(set[k]);
+                }
+
+            while (!stack.empty()) {
+                IdType id = stack.back();
+                stack.pop_back();
+                single[0] = id;
+                emit(single);
+                const util::Vector< IdType >& successors = successor_list(graph_, id);
+                const util::Vector< IdType >& predecessors = predecessor_list(graph_, id);
+                for (typename util::Vector< IdType >::const_iterator it = successors.begin(); it != successors.end(); ++it)
+                    if (labels_[*it].load(std::memory_order_relaxed) == label && !graph_.is_edge_deleted(id, *it) &&
+                            --in_degree_[*it] == 0) {
+                        labels_[*it].store(trimmed_label, std::memory_order_relaxed);
+                        stack.push_back(*it);
+                    }
+                for (typename util::Vector< IdType >::const_iterator it = predecessors.begin(); it != predecessors.end(); ++it)
+                    if (labels_[*it].load(std::memory_order_relaxed) == label && !graph_.is_edge_deleted(*it, id) &&
+                            --out_degree_[*it] == 0) {
+                        labels_[*it].store(trimmed_label, std::memory_order_relaxed);
+                        stack.push_back(*it);
+                    }
+            }
+
+            util::size_t kept = 0;
+            for (util::size_t k = 0; k < set.size(); ++k)
+                if (labels_[set[k]].load(std::memory_order_relaxed) == label)
+                    set[kept++] = set[k];
+            while (set.size() > kept)
+                set.pop_back();
+        }
+    }
+
+    namespace detail {
+        template<typename Graph>
+        void run_bfs(const Graph& graph, typename Graph::id_type source_id,
+                     util::Vector< const typename Graph::Node* >& res) {
+            typedef typename Graph::id_type IdType;
+            //implementation of BFS as explained here:
+            //https://en.wikipedia.org/wiki/Breadth-first_search
+            util::Vector< bool > visited(graph.node_count(), false); visited[source_id] = true;
+            util::Queue< IdType > queue; queue.push(source_id);
+            res.clear();
+
+            while (!queue.empty()) {
+                IdType current_id = queue.front();
+                queue.pop();
+                res.push_back(graph.get_node_by_id(current_id));
+
+                const util::Vector< IdType >& current_successors = successor_list(graph, current_id);
+                DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+                DGRAPH_TRACE_COUNT(EDGES_SCANNED, current_successors.size());
+                for (typename util::Vector< IdType >::const_iterator it = current_successors.begin();
+                        it != current_successors.end(); ++it)
+                    if (!visited[*it] && !graph.is_edge_deleted(current_id, *it)) {
+                        visited[*it] = true;
+                        queue.push(*it);
+                    }
+            }
+        }
+
+        template<typename Graph>
+        void run_dfs(const Graph& graph, typename Graph::id_type source_id,
+                     util::Vector< const typename Graph::Node* >& res) {
+            typedef typename Graph::id_type IdType;
+            //implementation of DFS as explained here:
+            //https://en.wikipedia.org/wiki/Depth-first_search
+            //the recursion is replaced by an explicit stack of (node, index of the next successor)
+            //pairs, so deep graphs such as long chains do not overflow the call stack
+            util::Vector< bool > visited(graph.node_count(), false);
+            util::Stack< std::pair<IdType, util::size_t> > stack;
+            visited[source_id] = true;
+            res.push_back(graph.get_node_by_id(source_id));
+            stack.push(std::make_pair(source_id, (util::size_t)0));
+
+            while (!stack.empty()) {
+                std::pair<IdType, util::size_t>& top = stack.top();
+                const util::Vector< IdType >& current_successors = successor_list(graph, top.first);
+                if (top.second == current_successors.size()) {
+                    DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+                    DGRAPH_TRACE_COUNT(EDGES_SCANNED, current_successors.size());
+                    stack.pop();
+                    continue;
+                }
+                IdType next_id = current_successors[top.second++];
+                if (!visited[next_id] && !graph.is_edge_deleted(top.first, next_id)) {
+                    visited[next_id] = true;
+                    res.push_back(graph.get_node_by_id(next_id));
+                    stack.push(std::make_pair(next_id, (util::size_t)0));
+                }
+            }
+        }
+
+        template<typename Graph>
+        bool bidirectional_reachable(const Graph& graph, typename Graph::id_type from_id,
+                                     typename Graph::id_type to_id) {
+            typedef typename Graph::id_type IdType;
+            if (from_id == to_id)
+                return true;
+            //side is 1 for the nodes reached forward from from_id, 2 for those reached backward
+            //from to_id; the smaller frontier is expanded each round, so on graphs where the search
+            //fans out it explores about two balls of half the distance instead of one of the whole
+            util::Vector< char > side(graph.node_count(), 0);
+            util::Vector< IdType > forward(1, from_id), backward(1, to_id), next;
+            side[from_id] = 1;
+            side[to_id] = 2;
+            while (!forward.empty() && !backward.empty()) {
+                bool is_forward = (forward.size() <= backward.size());
+                util::Vector< IdType >& frontier = (is_forward ? forward : backward);
+                char own_side = (is_forward ? 1 : 2);
+                for (util::size_t k = 0; k < frontier.size(); ++k) {
+                    IdType current_id = frontier[k];
+                    const util::Vector< IdType >& neighbors = (is_forward ?
+                            successor_list(graph, current_id) : predecessor_list(graph, current_id));
+                    DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+                    DGRAPH_TRACE_COUNT(EDGES_SCANNED, neighbors.size());
+                    for (typename util::Vector< IdType >::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it) {
+                        if (side[*it] == own_side ||
+                                (is_forward ? graph.is_edge_deleted(current_id, *it) : graph.is_edge_deleted(*it, current_id)))
+                            continue;
+                        if (side[*it] != 0)
+                            return true;
+                        side[*it] = own_side;
+                        next.push_back(*it);
+                    }
+                }
+                frontier = next;
+                while (!next.empty())
+                    next.pop_back();
+            }
+            return false;
+        }
+
+        template<typename Graph>
+        void tarjan_components(const Graph& graph, util::Vector< util::Vector< const typename Graph::Node* > >& scc,
+                               OperationMonitor* monitor) {
+            typedef typename Graph::id_type IdType;
+            //implementation for obtaining the strongly connected components of a graph
+            //using Tarjan's algorithm:
+            // https://en.wikipedia.org/wiki/Tarjan%27s_strongly_connected_components_algorithm
+            //the recursive calls are emulated with an explicit stack of (node, index of the next
+            //successor) pairs; a node's lowlink is propagated to its parent when its frame is popped
+            IdType node_count = graph.node_count(), curr_idx = 0;
+            util::Vector< IdType > idx(node_count, 0), lowlink(node_count, 0);
+            util::Vector< bool > in_stack(node_count, false);
+            util::Stack< IdType > stack;
+            util::Stack< std::pair<IdType, util::size_t> > call_stack;
+
+            for (IdType i = 0; i < node_count; ++i) {
+                if (idx[i] != 0 || graph.is_node_deleted(i))
+                    continue;
+                idx[i] = lowlink[i] = ++curr_idx;
+                stack.push(i);
+                in_stack[i] = true;
+                call_stack.push(std::make_pair(i, (util::size_t)0));
+
+                while (!call_stack.empty()) {
+                    std::pair<IdType, util::size_t>& top = call_stack.top();
+                    IdType current = top.first;
+                    const util::Vector< IdType >& curr_successors = successor_list(graph, current);
+
+                    if (top.second < curr_successors.size()) {
+                        IdType next_id = curr_successors[top.second++];
+                        if (graph.is_edge_deleted(current, next_id))
+                            continue;
+                        if (idx[next_id] == 0) {
+                            idx[next_id] = lowlink[next_id] = ++curr_idx;
+                            stack.push(next_id);
+                            in_stack[next_id] = true;
+                            call_stack.push(std::make_pair(next_id, (util::size_t)0));
+                        }
+                        else if (in_stack[next_id])
+                            lowlink[current] = std::min(lowlink[current], lowlink[next_id]);
+                        continue;
+                    }
+
+                    DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+                    DGRAPH_TRACE_COUNT(EDGES_SCANNED, curr_successors.size());
+                    if (monitor != NULL)
+                        monitor->advance();
+                    call_stack.pop();
+                    if (idx[current] == lowlink[current]) {
+                        scc.push_back(util::Vector< const typename Graph::Node* >());
+                        IdType member;
+                        do {
+                            member = stack.top();
+                            scc.back().push_back(graph.get_node_by_id(member));
+                            stack.pop();
+                            in_stack[member] = false;
+                        } while (member != current);
+                    }
+                    if (!call_stack.empty()) {
+                        IdType parent = call_stack.top().first;
+                        lowlink[parent] = std::min(lowlink[parent], lowlink[current]);
+                    }
+                }
+            }
+        }
+
+        template<typename Graph>
+        void dfs_finish_order(const Graph& graph, typename Graph::id_type node_id, util::Vector< char >& state,
+                              util::Vector< const typename Graph::Node* >& res, OperationMonitor* monitor) {
+            typedef typename Graph::id_type IdType;
+            //with a simple dfs in this graph we can obtain the reversed topological sort
+            //by adding each node once all of its successors have been finished
+            //state is 0 for unvisited nodes, 1 while a node is on the stack and 2 once it is finished
+            util::Stack< std::pair<IdType, util::size_t> > stack;
+            state[node_id] = 1;
+            stack.push(std::make_pair(node_id, (util::size_t)0));
+
+            while (!stack.empty()) {
+                std::pair<IdType, util::size_t>& top = stack.top();
+                const util::Vector< IdType >& current_successors = successor_list(graph, top.first);
+                if (top.second == current_successors.size()) {
+                    DGRAPH_TRACE_COUNT(NODES_VISITED, 1);
+                    DGRAPH_TRACE_COUNT(EDGES_SCANNED, current_successors.size());
+                    if (monitor != NULL)
+                        monitor->advance();
+                    state[top.first] = 2;
+                    res.push_back(graph.get_node_by_id(top.first));
+                    stack.pop();
+                    continue;
+                }
+                IdType next_id = current_successors[top.second++];
+                if (graph.is_edge_deleted(top.first, next_id))
+                    continue;
+                if (state[next_id] == 1)
+                    throw bad_top_sort();
+                if (state[next_id] == 0) {
+                    state[next_id] = 1;
+                    stack.push(std::make_pair(next_id, (util::size_t)0));
+                }
+            }
+        }
+
+        template<typename Graph>
+        void topological_order(const Graph& graph, util::Vector< const typename Graph::Node* >& res,
+                               OperationMonitor* monitor) {
+            typedef typename Graph::id_type IdType;
+            //the cycles are detected by the dfs itself: either as an edge back to a node whose dfs
+            //has not finished, or as nodes left unreached because no source leads to them
+            IdType node_count = graph.node_count();
+            util::Vector< char > state(node_count, 0);
+            util::size_t live_count = 0;
+            for (IdType i = 0; i < node_count; ++i) {
+                if (graph.is_node_deleted(i))
+                    continue;
+                live_count++;
+                const util::Vector< IdType >& current_predecessors = predecessor_list(graph, i);
+                bool is_source = true;
+                for (util::size_t k = 0; k < current_predecessors.size() && is_source; ++k)
+                    is_source = graph.is_edge_deleted(current_predecessors[k], i);
+                if (is_source && state[i] == 0)
+                    dfs_finish_order(graph, i, state, res, monitor);
+            }
+            if (res.size() != live_count)
+                throw bad_top_sort();
+            std::reverse(res.begin(), res.end());
+        }
+
+        template<typename Graph>
+        void compute_dominators(const Graph& graph, typename Graph::id_type root_id,
+                                util::Vector< typename Graph::id_type >& immediate_dominators) {
+            typedef typename Graph::id_type IdType;
+            const IdType none = IdType(-1);
+            IdType node_count = graph.node_count();
+
+            //number of every node in the dfs preorder, the node of every number and the number of its
+            //dfs parent; every edge the dfs meets is recorded by the numbers of its ends, so the other
+            //passes read flat arrays indexed by preorder instead of the adjacency lists
+            util::Vector< IdType > number(node_count, none), vertex, parent, edge_from, edge_to;
+            util::Stack< std::pair<IdType, util::size_t> > stack;
+            number[root_id] = 0;
+            vertex.push_back(root_id);
+            parent.push_back(0);
+            stack.push(std::make_pair(root_id, (util::size_t)0));
+            while (!stack.empty()) {
+                std::pair<IdType, util::size_t>& top = stack.top();
+                const util::Vector< IdType >& successors = successor_list(graph, top.first);
+                if (top.second == successors.size()) {
+                    stack.pop();
+                    continue;
+                }
+                IdType current_id = top.first, next_id = successors[top.second++];
+                if (graph.is_edge_deleted(current_id, next_id))
+                    continue;
+                edge_from.push_back(number[current_id]);
+                if (number[next_id] != none) {
+                    edge_to.push_back(number[next_id]);
+                    continue;
+                }
+                number[next_id] = (IdType)vertex.size();
+                edge_to.push_back(number[next_id]);
+                parent.push_back(number[current_id]);
+                vertex.push_back(next_id);
+                stack.push(std::make_pair(next_id, (util::size_t)0));
+            }
+
+            //the predecessors of every number, grouped by a counting sort on the edge targets
+            IdType count = (IdType)vertex.size();
+            util::Vector< util::size_t > first(count + 1, 0);
+            for (util::size_t k = 0; k < edge_to.size(); ++k)
+                first[edge_to[k] + 1]++;
+            for (IdType w = 0; w < count; ++w)
+                first[w + 1] += first[w];
+            util::Vector< IdType > predecessors(edge_from.size(), 0);
+            {
+                util::Vector< util::size_t > next(first);
+                for (util::size_t k = 0; k < edge_to.size(); ++k)
+                    predecessors[next[edge_to[k]]++] = edge_from[k];
+            }
+            edge_from.clear();
+            edge_to.clear();
+
+            //semidominators in reverse preorder, evaluated on a forest linked along the dfs tree;
+            //ancestor is none at the roots of the forest and label holds the number with the
+            //smallest semidominator on the compressed path above each node
+            util::Vector< IdType > semi(count, 0), label(count, 0), ancestor(count, none), path;
+            for (IdType w = 0; w < count; ++w)
+                semi[w] = label[w] = w;
+            for (IdType w = count - 1; w > 0; --w) {
+                for (util::size_t k = first[w]; k < first[w + 1]; ++k) {
+                    //a number below w is not linked yet and is its own semidominator, so only
+                    //the predecessors after w need an evaluation
+                    IdType v = predecessors[k];
+                    if (v > w) {
+                        //compresses the path from v up to the root of its tree, from the top down
+                        for (IdType u = v; ancestor[ancestor[u]] != none; u = ancestor[u])
+                            path.push_back(u);
+                        while (!path.empty()) {
+                            IdType u = path.back();
+                            path.pop_back();
+                            if (semi[label[ancestor[u]]] < semi[label[u]])
+                                label[u] = label[ancestor[u]];
+                            ancestor[u] = ancestor[ancestor[u]];
+                        }
+                        v = label[v];
+                    }
+                    semi[w] = std::min(semi[w], semi[v]);
+                }
+                ancestor[w] = parent[w];
+            }
+
+            //in preorder, the parent and the semidominator of a node are already in the tree
+            util::Vector< IdType > dominator(count, 0);
+            for (IdType w = 1; w < count; ++w) {
+                IdType d = parent[w];
+                while (d > semi[w])
+                    d = dominator[d];
+                dominator[w] = d;
+            }
+
+            immediate_dominators = util::Vector< IdType >(node_count, none);
+            for (IdType w = 0; w < count; ++w)
+                immediate_dominators[vertex[w]] = vertex[dominator[w]];
+        }
+    }
 }
 
 #endif //DIRECTEDGRAPHHANDLER_DIRECTED_GRAPH_H
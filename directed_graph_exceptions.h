@@ -19,6 +19,18 @@ namespace dgraph {
             return "The graph has cycles!";
         }
     };
+
+    class bad_edge_weight : public std::exception {
+        virtual const char* what() const throw() {
+            return "Negative edge weight!";
+        }
+    };
+
+    class operation_cancelled : public std::exception {
+        virtual const char* what() const throw() {
+            return "The operation was cancelled!";
+        }
+    };
 }
 
 #endif //DIRECTEDGRAPHHANDLER_DIRECTED_GRAPH_EXCEPTIONS_H
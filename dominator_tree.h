@@ -0,0 +1,157 @@
+#ifndef DIRECTEDGRAPHHANDLER_DOMINATOR_TREE_H
+#define DIRECTEDGRAPHHANDLER_DOMINATOR_TREE_H
+
+#include <algorithm>
+#include <utility>
+#include "util_stack.h"
+#include "util_vector.h"
+
+namespace dgraph {
+
+    //result of a dominator computation from a root: a dominates b if every path from the root
+    //to b passes through a. The immediate dominators form a tree rooted at the root, whose
+    //preorder numbers answer dominates in O(1)
+    template<typename IdType>
+    class DominatorTree {
+      public:
+        DominatorTree();
+        //builds the tree from the immediate dominator of every node, which is IdType(-1) for the
+        //nodes the root does not reach; the root is its own immediate dominator
+        DominatorTree(IdType root_id, const util::Vector< IdType >& immediate_dominators);
+        DominatorTree(const DominatorTree& rhs);
+        DominatorTree& operator = (const DominatorTree& rhs);
+        virtual ~DominatorTree();
+
+        IdType root() const;
+        IdType node_count() const;
+
+        bool is_reachable(IdType id) const;
+        //the root is its own immediate dominator and unreachable nodes have IdType(-1)
+        IdType immediate_dominator(IdType id) const;
+        //the number of edges between the root and id in the tree, IdType(-1) for unreachable nodes
+        IdType depth(IdType id) const;
+        const util::Vector< IdType >& immediate_dominators() const;
+        const util::Vector< IdType >& depths() const;
+
+        //returns true if a dominates b; a reachable node dominates itself, an unreachable one
+        //neither dominates nor is dominated
+        bool dominates(IdType a, IdType b) const;
+        //returns the dominators of id, from id up to the root, or an empty Vector if id is unreachable
+        util::Vector< IdType > dominators_of(IdType id) const;
+      private:
+        IdType root_;
+        util::Vector< IdType > immediate_dominators_, depths_;
+        //the preorder number of every node in the tree and the largest one in its subtree; only
+        //entries are numbered, so the numbers stay below the node count and fit in IdType
+        util::Vector< IdType > enter_, last_;
+    };
+
+    template<typename IdType>
+    DominatorTree<IdType>::DominatorTree() : root_(IdType(-1)) {}
+
+    template<typename IdType>
+    DominatorTree<IdType>::DominatorTree(IdType root_id, const util::Vector<IdType> &immediate_dominators) :
+            root_(root_id), immediate_dominators_(immediate_dominators),
+            depths_(immediate_dominators.size(), IdType(-1)),
+            enter_(immediate_dominators.size(), IdType(-1)), last_(immediate_dominators.size(), IdType(-1)) {
+        //the children of every node, grouped by parent as in a CSR
+        util::size_t node_count = immediate_dominators.size();
+        util::Vector< util::size_t > first(node_count + 1, 0);
+        for (util::size_t id = 0; id < node_count; ++id)
+            if (id != (util::size_t)root_id && immediate_dominators[id] != IdType(-1))
+                first[immediate_dominators[id] + 1]++;
+        for (util::size_t id = 0; id < node_count; ++id)
+            first[id + 1] += first[id];
+        util::Vector< IdType > children(first[node_count], 0);
+        util::Vector< util::size_t > next(first);
+        for (util::size_t id = 0; id < node_count; ++id)
+            if (id != (util::size_t)root_id && immediate_dominators[id] != IdType(-1))
+                children[next[immediate_dominators[id]]++] = (IdType)id;
+
+        IdType counter = 0;
+        util::Stack< std::pair<IdType, util::size_t> > stack;
+        depths_[root_id] = 0;
+        enter_[root_id] = counter++;
+        stack.push(std::make_pair(root_id, first[root_id]));
+        while (!stack.empty()) {
+            std::pair<IdType, util::size_t>& top = stack.top();
+            if (top.second == first[top.first + 1]) {
+                last_[top.first] = counter - 1;
+                stack.pop();
+                continue;
+            }
+            IdType child = children[top.second++];
+            depths_[child] = depths_[top.first] + 1;
+            enter_[child] = counter++;
+            stack.push(std::make_pair(child, first[child]));
+        }
+    }
+
+    template<typename IdType>
+    DominatorTree<IdType>::DominatorTree(const DominatorTree &rhs) :
+            root_(rhs.root_), immediate_dominators_(rhs.immediate_dominators_), depths_(rhs.depths_),
+            enter_(rhs.enter_), last_(rhs.last_) {}
+
+    template<typename IdType>
+    DominatorTree<IdType>& DominatorTree<IdType>::operator=(const DominatorTree &rhs) {
+        root_ = rhs.root_;
+        immediate_dominators_ = rhs.immediate_dominators_;
+        depths_ = rhs.depths_;
+        enter_ = rhs.enter_;
+        last_ = rhs.last_;
+        return (*this);
+    }
+
+    template<typename IdType>
+    DominatorTree<IdType>::~DominatorTree() {}
+
+    template<typename IdType>
+    IdType DominatorTree<IdType>::root() const { return root_; }
+
+    template<typename IdType>
+    IdType DominatorTree<IdType>::node_count() const { return (IdType)immediate_dominators_.size(); }
+
+    template<typename IdType>
+    bool DominatorTree<IdType>::is_reachable(IdType id) const {
+        return immediate_dominators_[id] != IdType(-1);
+    }
+
+    template<typename IdType>
+    IdType DominatorTree<IdType>::immediate_dominator(IdType id) const {
+        return immediate_dominators_[id];
+    }
+
+    template<typename IdType>
+    IdType DominatorTree<IdType>::depth(IdType id) const {
+        return depths_[id];
+    }
+
+    template<typename IdType>
+    const util::Vector< IdType >& DominatorTree<IdType>::immediate_dominators() const {
+        return immediate_dominators_;
+    }
+
+    template<typename IdType>
+    const util::Vector< IdType >& DominatorTree<IdType>::depths() const {
+        return depths_;
+    }
+
+    template<typename IdType>
+    bool DominatorTree<IdType>::dominates(IdType a, IdType b) const {
+        //a dominates b iff b lies in the subtree of a, whose preorder numbers are consecutive
+        return is_reachable(a) && is_reachable(b) && enter_[a] <= enter_[b] && enter_[b] <= last_[a];
+    }
+
+    template<typename IdType>
+    util::Vector< IdType > DominatorTree<IdType>::dominators_of(IdType id) const {
+        util::Vector< IdType > res;
+        if (!is_reachable(id))
+            return res;
+        for (; id != root_; id = immediate_dominators_[id])
+            res.push_back(id);
+        res.push_back(root_);
+        return res;
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_DOMINATOR_TREE_H
@@ -0,0 +1,698 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "util_dary_heap.h"
+#include "util_trace.h"
+#include "external_directed_graph.h"
+
+namespace dgraph {
+
+    namespace {
+        //an edge as stored in the sorted runs: the node whose list holds it, then the other end
+        struct EdgeRecord {
+            int owner;
+            int neighbor;
+
+            bool operator < (const EdgeRecord& rhs) const {
+                return owner < rhs.owner || (owner == rhs.owner && neighbor < rhs.neighbor);
+            }
+        };
+
+        //smallest partition, so that even a tiny budget reads the files in large blocks
+        const unsigned long long min_partition_bytes = 1 << 16;
+        //a read of a few bytes at a random position costs about as much as a sequential read of this many
+        const unsigned long long random_read_cost = 1 << 12;
+        //every run being merged has a buffer of this size; at most max_merge_width runs are merged at once
+        const std::size_t run_buffer_size = 1 << 16;
+        const std::size_t max_merge_width = 256;
+
+        std::runtime_error file_error(const std::string& what, const std::string& path) {
+            return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+
+        //removes the temporary files of a build, whether it succeeds or not
+        struct TemporaryFiles {
+            ~TemporaryFiles() {
+                for (util::size_t i = 0; i < paths.size(); ++i)
+                    unlink(paths[i].c_str());
+            }
+
+            std::string add(const std::string& directory, const char* kind) {
+                std::ostringstream path;
+                path << directory << "/run." << kind << "." << paths.size();
+                paths.push_back(path.str());
+                return paths.back();
+            }
+
+            util::Vector< std::string > paths;
+        };
+
+        void write_run(const util::Vector< EdgeRecord >& edges, const std::string& path) {
+            std::ofstream out(path.data(), std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw file_error("cannot create", path);
+            util::BinaryWriter writer(out);
+            if (!edges.empty())
+                writer.put_bytes(edges.begin(), edges.size() * sizeof(EdgeRecord));
+            writer.flush();
+            if (!out)
+                throw file_error("cannot write", path);
+        }
+
+        //one sorted run being merged
+        struct RunReader {
+            explicit RunReader(const std::string& path) : in(path.data(), std::ios::binary), reader(in) {
+                if (!in)
+                    throw file_error("cannot open", path);
+            }
+
+            std::ifstream in;
+            util::BinaryReader reader;
+        };
+
+        //hands the records of runs[begin, end) to sink, in sorted order
+        template<typename Sink>
+        void merge_runs(const util::Vector< std::string >& runs, util::size_t begin, util::size_t end, Sink& sink) {
+            util::Vector< RunReader* > readers;
+            util::DaryHeap< EdgeRecord, util::size_t > heap;
+            try {
+                for (util::size_t i = begin; i < end; ++i) {
+                    readers.push_back(new RunReader(runs[i]));
+                    EdgeRecord edge;
+                    if (readers.back()->reader.get(edge))
+                        heap.push(edge, readers.size() - 1);
+                }
+                while (!heap.empty()) {
+                    EdgeRecord edge = heap.top().first;
+                    util::size_t run = heap.top().second;
+                    heap.pop();
+                    sink(edge);
+                    if (readers[run]->reader.get(edge))
+                        heap.push(edge, run);
+                }
+            }
+            catch (...) {
+                for (util::size_t i = 0; i < readers.size(); ++i)
+                    delete readers[i];
+                throw;
+            }
+            for (util::size_t i = 0; i < readers.size(); ++i)
+                delete readers[i];
+        }
+
+        //writes the merged records to another run
+        struct RunSink {
+            explicit RunSink(std::ostream& out) : writer(out) {}
+
+            void operator () (const EdgeRecord& edge) {
+                writer.put(edge);
+            }
+
+            util::BinaryWriter writer;
+        };
+
+        //writes the merged records as delta-encoded lists, in the format of CompressedDirectedGraph,
+        //keeping the offset of every list; a record equal to the previous one is a duplicate edge
+        struct ListSink {
+            ListSink(std::ostream& out, int node_count) :
+                    writer(out), offsets(node_count + 1, 0), node_count(node_count),
+                    current(0), last_neighbor(-1), size(0) {}
+
+            void operator () (const EdgeRecord& edge) {
+                if (edge.owner == current && edge.neighbor == last_neighbor)
+                    throw bad_dgraph_config();
+                for (; current < edge.owner; ++current) {
+                    offsets[current + 1] = size;
+                    last_neighbor = -1;
+                }
+                unsigned char bytes[8];
+                int length = 0;
+                unsigned int value = (unsigned int)(edge.neighbor - last_neighbor - 1);
+                for (; value >= 0x80; value >>= 7)
+                    bytes[length++] = (unsigned char)(value | 0x80);
+                bytes[length++] = (unsigned char)value;
+                writer.put_bytes(bytes, (std::size_t)length);
+                size += (unsigned long long)length;
+                last_neighbor = edge.neighbor;
+            }
+
+            void finish() {
+                for (; current < node_count; ++current)
+                    offsets[current + 1] = size;
+                writer.flush();
+            }
+
+            util::BinaryWriter writer;
+            util::Vector< unsigned long long > offsets;
+            int node_count;
+            int current;
+            int last_neighbor;
+            unsigned long long size;
+        };
+
+        //merges the runs into one list file, first merging groups of them until they are few enough
+        util::Vector< unsigned long long > merge_lists(util::Vector< std::string > runs, TemporaryFiles& temporary,
+                                                       const std::string& directory, const char* kind,
+                                                       const std::string& path, int node_count,
+                                                       std::size_t memory_budget) {
+            std::size_t width = std::min(max_merge_width, std::max((std::size_t)2, memory_budget / run_buffer_size));
+            while (runs.size() > width) {
+                util::Vector< std::string > merged;
+                for (util::size_t begin = 0; begin < runs.size(); begin += (util::size_t)width) {
+                    util::size_t end = std::min(runs.size(), begin + (util::size_t)width);
+                    std::string merged_path = temporary.add(directory, kind);
+                    {
+                        std::ofstream out(merged_path.data(), std::ios::binary | std::ios::trunc);
+                        if (!out)
+                            throw file_error("cannot create", merged_path);
+                        RunSink sink(out);
+                        merge_runs(runs, begin, end, sink);
+                        sink.writer.flush();
+                        if (!out)
+                            throw file_error("cannot write", merged_path);
+                    }
+                    for (util::size_t i = begin; i < end; ++i)
+                        unlink(runs[i].c_str());
+                    merged.push_back(merged_path);
+                }
+                runs = merged;
+            }
+
+            std::ofstream out(path.data(), std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw file_error("cannot create", path);
+            ListSink sink(out, node_count);
+            merge_runs(runs, 0, runs.size(), sink);
+            sink.finish();
+            if (!out)
+                throw file_error("cannot write", path);
+            return sink.offsets;
+        }
+
+        //per-node step of the semi-external bfs: claim holds the position in the current level of the
+        //frontier nodes and, for the nodes of the next level, the smallest such position that reaches them
+        struct BfsVisitor {
+            BfsVisitor(util::Vector< int >& level_of, util::Vector< int >& claim, util::Vector< int >& next, int level) :
+                    level_of(level_of), claim(claim), next(next), level(level) {}
+
+            void operator () (int node, AdjacencyCursor& successors) {
+                int position = claim[node];
+                while (successors.has_next()) {
+                    int successor = successors.next();
+                    if (level_of[successor] == -1) {
+                        level_of[successor] = level;
+                        claim[successor] = position;
+                        next.push_back(successor);
+                    }
+                    else if (level_of[successor] == level && claim[successor] > position)
+                        claim[successor] = position;
+                }
+            }
+
+            util::Vector< int >& level_of;
+            util::Vector< int >& claim;
+            util::Vector< int >& next;
+            int level;
+        };
+
+        //counts the incoming and outgoing edges of every active node among the active nodes
+        struct DegreeVisitor {
+            DegreeVisitor(const util::Vector< char >& active, util::Vector< int >& in_count, util::Vector< int >& out_count) :
+                    active(active), in_count(in_count), out_count(out_count) {}
+
+            void operator () (int node, AdjacencyCursor& successors) {
+                if (!active[node])
+                    return;
+                while (successors.has_next()) {
+                    int successor = successors.next();
+                    if (active[successor]) {
+                        out_count[node]++;
+                        in_count[successor]++;
+                    }
+                }
+            }
+
+            const util::Vector< char >& active;
+            util::Vector< int >& in_count;
+            util::Vector< int >& out_count;
+        };
+
+        //takes the edges of removed nodes away from the counts of their neighbors, removing
+        //the neighbors whose count drops to zero
+        struct TrimVisitor {
+            TrimVisitor(util::Vector< char >& active, util::Vector< int >& component,
+                        util::Vector< int >& count, util::Vector< int >& removed) :
+                    active(active), component(component), count(count), removed(removed) {}
+
+            void operator () (int, AdjacencyCursor& neighbors) {
+                while (neighbors.has_next()) {
+                    int neighbor = neighbors.next();
+                    if (active[neighbor] && --count[neighbor] == 0) {
+                        active[neighbor] = 0;
+                        component[neighbor] = neighbor;
+                        removed.push_back(neighbor);
+                    }
+                }
+            }
+
+            util::Vector< char >& active;
+            util::Vector< int >& component;
+            util::Vector< int >& count;
+            util::Vector< int >& removed;
+        };
+
+        //one step of the color propagation; a neighbor that changes is rescanned with its partition,
+        //unless the scan in progress has yet to reach it
+        struct ColorVisitor {
+            ColorVisitor(const util::Vector< int >& partition_begin, const util::Vector< char >& active,
+                         util::Vector< int >& color, util::Vector< char >* marked, util::Vector< char >& dirty) :
+                    partition_begin(partition_begin), active(active), color(color), marked(marked), dirty(dirty),
+                    forward(true), node_partition(0) {}
+
+            int partition_of(int node) const {
+                return (int)(std::upper_bound(partition_begin.begin(), partition_begin.end(), node) -
+                             partition_begin.begin()) - 1;
+            }
+
+            void changed(int node, int neighbor) {
+                int neighbor_partition = partition_of(neighbor);
+                if (neighbor_partition == node_partition && (forward ? neighbor > node : neighbor < node))
+                    return;
+                dirty[neighbor_partition] = 1;
+            }
+
+            void operator () (int node, AdjacencyCursor& neighbors) {
+                if (!active[node] || (marked != NULL && !(*marked)[node]))
+                    return;
+                if (node < partition_begin[node_partition] || node >= partition_begin[node_partition + 1])
+                    node_partition = partition_of(node);
+                int node_color = color[node];
+                while (neighbors.has_next()) {
+                    int neighbor = neighbors.next();
+                    if (!active[neighbor])
+                        continue;
+                    if (marked == NULL) {
+                        if (color[neighbor] < node_color) {
+                            color[neighbor] = node_color;
+                            changed(node, neighbor);
+                        }
+                    }
+                    else if (!(*marked)[neighbor] && color[neighbor] == node_color) {
+                        (*marked)[neighbor] = 1;
+                        changed(node, neighbor);
+                    }
+                }
+            }
+
+            const util::Vector< int >& partition_begin;
+            const util::Vector< char >& active;
+            util::Vector< int >& color;
+            util::Vector< char >* marked;
+            util::Vector< char >& dirty;
+            bool forward;
+            int node_partition;
+        };
+    }
+
+    //implementation of ExternalDirectedGraph's methods
+    ExternalDirectedGraph::ExternalDirectedGraph(const std::string &directory, std::size_t memory_budget) :
+            directory_(directory), memory_budget_(memory_budget),
+            partition_bytes_(std::max(min_partition_bytes, (unsigned long long)memory_budget / 4)),
+            node_count_(0), edge_count_(0), bytes_read_(0), read_count_(0) {
+        std::string index_path = directory_ + "/index.bin";
+        std::ifstream in(index_path.data(), std::ios::binary);
+        if (!in)
+            throw file_error("cannot open", index_path);
+        util::BinaryReader index(in);
+        char magic[4];
+        unsigned int checksum;
+        //the counts have their own checksum, so that a corrupted count is not used to allocate the offsets
+        if (!index.get_bytes(magic, 4) || std::memcmp(magic, "DGX1", 4) != 0 ||
+                !index.get(node_count_) || !index.get(edge_count_))
+            throw bad_dgraph_config();
+        unsigned int expected = index.checksum();
+        if (!index.get(checksum) || checksum != expected || node_count_ < 0 || edge_count_ < 0)
+            throw bad_dgraph_config();
+
+        try {
+            open_file(successors_, index, "successors.bin");
+            open_file(predecessors_, index, "predecessors.bin");
+            expected = index.checksum();
+            if (!index.get(checksum) || checksum != expected)
+                throw bad_dgraph_config();
+        }
+        catch (...) {
+            if (successors_.fd >= 0)
+                close(successors_.fd);
+            if (predecessors_.fd >= 0)
+                close(predecessors_.fd);
+            throw;
+        }
+    }
+
+    ExternalDirectedGraph::~ExternalDirectedGraph() {
+        close(successors_.fd);
+        close(predecessors_.fd);
+    }
+
+    void ExternalDirectedGraph::build(std::istream &in, const std::string &directory, std::size_t memory_budget) {
+        DGRAPH_TRACE_SCOPE("external/build");
+        int node_count;
+        long long edge_count;
+        if (!(in >> node_count)) throw bad_dgraph_config();
+        if (!(in >> edge_count)) throw bad_dgraph_config();
+        if (node_count < 0 || edge_count < 0) throw bad_dgraph_config();
+        if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+            throw file_error("cannot create", directory);
+        //the index is written last, so the directory cannot be opened until the build is complete
+        std::string index_path = directory + "/index.bin";
+        unlink(index_path.c_str());
+
+        //each run is sorted twice, by source for the successor lists and by destination for the
+        //predecessor lists, in the same buffer
+        util::size_t run_capacity = (util::size_t)std::min((unsigned long long)(memory_budget / sizeof(EdgeRecord)),
+                                                           (unsigned long long)(1u << 30));
+        run_capacity = std::max(run_capacity, (util::size_t)1024);
+        TemporaryFiles temporary;
+        util::Vector< std::string > successor_runs, predecessor_runs;
+        util::Vector< EdgeRecord > batch;
+        batch.reserve((util::size_t)std::min((long long)run_capacity, edge_count));
+        for (long long i = 0; i < edge_count; ++i) {
+            EdgeRecord edge;
+            if (!(in >> edge.owner)) throw bad_dgraph_config();
+            if (!(in >> edge.neighbor)) throw bad_dgraph_config();
+            if (0 > edge.owner || edge.owner >= node_count ||
+                    0 > edge.neighbor || edge.neighbor >= node_count)
+                throw bad_dgraph_config();
+            if (edge.owner == edge.neighbor)
+                throw bad_dgraph_config();
+            batch.push_back(edge);
+
+            if (batch.size() == run_capacity || i + 1 == edge_count) {
+                std::sort(batch.begin(), batch.end());
+                successor_runs.push_back(temporary.add(directory, "successors"));
+                write_run(batch, successor_runs.back());
+                for (util::size_t k = 0; k < batch.size(); ++k)
+                    std::swap(batch[k].owner, batch[k].neighbor);
+                std::sort(batch.begin(), batch.end());
+                predecessor_runs.push_back(temporary.add(directory, "predecessors"));
+                write_run(batch, predecessor_runs.back());
+                //clear would release the buffer
+                while (!batch.empty())
+                    batch.pop_back();
+            }
+        }
+
+        util::Vector< unsigned long long > successor_offsets, predecessor_offsets;
+        try {
+            successor_offsets = merge_lists(successor_runs, temporary, directory, "successors",
+                                            directory + "/successors.bin", node_count, memory_budget);
+            predecessor_offsets = merge_lists(predecessor_runs, temporary, directory, "predecessors",
+                                              directory + "/predecessors.bin", node_count, memory_budget);
+        }
+        catch (...) {
+            unlink((directory + "/successors.bin").c_str());
+            unlink((directory + "/predecessors.bin").c_str());
+            throw;
+        }
+
+        std::ofstream out(index_path.data(), std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw file_error("cannot create", index_path);
+        util::BinaryWriter index(out);
+        index.put_bytes("DGX1", 4);
+        index.put(node_count);
+        index.put(edge_count);
+        index.put(index.checksum());
+        index.put_bytes(successor_offsets.begin(), successor_offsets.size() * sizeof(unsigned long long));
+        index.put_bytes(predecessor_offsets.begin(), predecessor_offsets.size() * sizeof(unsigned long long));
+        index.put(index.checksum());
+        index.flush();
+        if (!out)
+            throw file_error("cannot write", index_path);
+    }
+
+    int ExternalDirectedGraph::node_count() const { return node_count_; }
+    long long ExternalDirectedGraph::edge_count() const { return edge_count_; }
+    std::size_t ExternalDirectedGraph::memory_budget() const { return memory_budget_; }
+
+    int ExternalDirectedGraph::partition_count() const {
+        return (int)successors_.partition_begin.size() - 1;
+    }
+
+    unsigned long long ExternalDirectedGraph::bytes_read() const { return bytes_read_; }
+    unsigned long long ExternalDirectedGraph::read_count() const { return read_count_; }
+
+    void ExternalDirectedGraph::open_file(AdjacencyFile &file, util::BinaryReader &index, const std::string &name) {
+        file.path = directory_ + "/" + name;
+        file.offsets = util::Vector< unsigned long long >((util::size_t)node_count_ + 1, 0);
+        if (!index.get_bytes(file.offsets.begin(), file.offsets.size() * sizeof(unsigned long long)))
+            throw bad_dgraph_config();
+        if (file.offsets[0] != 0)
+            throw bad_dgraph_config();
+        for (int node = 0; node < node_count_; ++node)
+            if (file.offsets[node + 1] < file.offsets[node])
+                throw bad_dgraph_config();
+
+        file.fd = open(file.path.c_str(), O_RDONLY);
+        if (file.fd < 0)
+            throw file_error("cannot open", file.path);
+        struct stat status;
+        if (fstat(file.fd, &status) != 0)
+            throw file_error("cannot access", file.path);
+        if ((unsigned long long)status.st_size != file.offsets[node_count_])
+            throw bad_dgraph_config();
+        split_partitions(file);
+    }
+
+    void ExternalDirectedGraph::split_partitions(AdjacencyFile &file) const {
+        file.partition_begin.push_back(0);
+        for (int node = 0; node < node_count_; ++node) {
+            int begin = file.partition_begin.back();
+            //a list larger than a partition gets one of its own
+            if (node > begin && file.offsets[node + 1] - file.offsets[begin] > partition_bytes_)
+                file.partition_begin.push_back(node);
+        }
+        if (node_count_ > 0)
+            file.partition_begin.push_back(node_count_);
+    }
+
+    int ExternalDirectedGraph::partition_of(const AdjacencyFile &file, int node) const {
+        return (int)(std::upper_bound(file.partition_begin.begin(), file.partition_begin.end(), node) -
+                     file.partition_begin.begin()) - 1;
+    }
+
+    void ExternalDirectedGraph::read_range(const AdjacencyFile &file, unsigned long long begin, unsigned long long end,
+                                           util::Vector< unsigned char > &buffer) const {
+        std::size_t size = (std::size_t)(end - begin);
+        if (buffer.size() < size)
+            buffer = util::Vector< unsigned char >((util::size_t)size, 0);
+        std::size_t done = 0;
+        while (done < size) {
+            ssize_t count = pread(file.fd, buffer.begin() + done, size - done, (off_t)(begin + done));
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count < 0)
+                throw file_error("cannot read", file.path);
+            if (count == 0)
+                throw bad_dgraph_config(); //the file is shorter than its offsets say
+            done += (std::size_t)count;
+        }
+        bytes_read_ += size;
+        read_count_++;
+    }
+
+    template<typename Visitor>
+    void ExternalDirectedGraph::visit_lists(const AdjacencyFile &file, const util::Vector< int > &nodes,
+                                            Visitor &visitor) const {
+        util::Vector< unsigned char > buffer;
+        util::size_t i = 0;
+        while (i < nodes.size()) {
+            int partition = partition_of(file, nodes[i]);
+            int begin = file.partition_begin[partition], end = file.partition_begin[partition + 1];
+            util::size_t j = i;
+            unsigned long long targeted_cost = 0;
+            for (; j < nodes.size() && nodes[j] < end; ++j)
+                targeted_cost += file.offsets[nodes[j] + 1] - file.offsets[nodes[j]] + random_read_cost;
+
+            if (targeted_cost < file.offsets[end] - file.offsets[begin]) {
+                for (; i < j; ++i) {
+                    unsigned long long list_begin = file.offsets[nodes[i]], list_end = file.offsets[nodes[i] + 1];
+                    if (list_begin == list_end)
+                        continue;
+                    read_range(file, list_begin, list_end, buffer);
+                    AdjacencyCursor list(buffer.begin(), buffer.begin() + (list_end - list_begin));
+                    visitor(nodes[i], list);
+                }
+            }
+            else {
+                read_range(file, file.offsets[begin], file.offsets[end], buffer);
+                for (; i < j; ++i) {
+                    const unsigned char* data = buffer.begin();
+                    AdjacencyCursor list(data + (file.offsets[nodes[i]] - file.offsets[begin]),
+                                         data + (file.offsets[nodes[i] + 1] - file.offsets[begin]));
+                    visitor(nodes[i], list);
+                }
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void ExternalDirectedGraph::scan(const AdjacencyFile &file, util::Vector< char > &partitions, bool forward,
+                                     Visitor &visitor) const {
+        util::Vector< unsigned char > buffer;
+        int count = (int)partitions.size();
+        for (int k = 0; k < count; ++k) {
+            int partition = (forward ? k : count - 1 - k);
+            if (!partitions[partition])
+                continue;
+            partitions[partition] = 0;
+            int begin = file.partition_begin[partition], end = file.partition_begin[partition + 1];
+            if (file.offsets[begin] == file.offsets[end])
+                continue;
+            read_range(file, file.offsets[begin], file.offsets[end], buffer);
+            const unsigned char* data = buffer.begin();
+            for (int step = 0; step < end - begin; ++step) {
+                int node = (forward ? begin + step : end - 1 - step);
+                AdjacencyCursor list(data + (file.offsets[node] - file.offsets[begin]),
+                                     data + (file.offsets[node + 1] - file.offsets[begin]));
+                visitor(node, list);
+            }
+        }
+    }
+
+    util::Vector< int > ExternalDirectedGraph::breadth_first_search(int source_id) const {
+        DGRAPH_TRACE_SCOPE("external/bfs");
+        if (source_id < 0 || source_id >= node_count_)
+            throw std::out_of_range("Invalid node id!");
+
+        //DirectedGraph visits the successors of the nodes of a level in the order of the level,
+        //each list in increasing order, so a node of the next level comes after the nodes reached
+        //from an earlier position, and after the smaller ids reached from the same position
+        util::Vector< int > order, level_of((util::size_t)node_count_, -1), claim((util::size_t)node_count_, 0);
+        order.push_back(source_id);
+        level_of[source_id] = 0;
+        util::size_t level_begin = 0;
+        for (int level = 1; level_begin < order.size(); ++level) {
+            util::size_t level_end = order.size();
+            util::Vector< int > nodes;
+            nodes.reserve(level_end - level_begin);
+            for (util::size_t i = level_begin; i < level_end; ++i) {
+                claim[order[i]] = (int)(i - level_begin);
+                nodes.push_back(order[i]);
+            }
+            std::sort(nodes.begin(), nodes.end());
+
+            util::Vector< int > next;
+            BfsVisitor visitor(level_of, claim, next, level);
+            visit_lists(successors_, nodes, visitor);
+
+            util::Vector< std::pair< int, int > > ranked;
+            ranked.reserve(next.size());
+            for (util::size_t i = 0; i < next.size(); ++i)
+                ranked.push_back(std::make_pair(claim[next[i]], next[i]));
+            std::sort(ranked.begin(), ranked.end());
+            for (util::size_t i = 0; i < ranked.size(); ++i)
+                order.push_back(ranked[i].second);
+            level_begin = level_end;
+        }
+        return order;
+    }
+
+    void ExternalDirectedGraph::trim(util::Vector< char > &active, util::Vector< int > &component) const {
+        util::Vector< int > in_count((util::size_t)node_count_, 0), out_count((util::size_t)node_count_, 0);
+        util::Vector< char > partitions((util::size_t)partition_count(), 1);
+        DegreeVisitor degrees(active, in_count, out_count);
+        scan(successors_, partitions, true, degrees);
+
+        util::Vector< int > removed;
+        for (int node = 0; node < node_count_; ++node)
+            if (active[node] && (in_count[node] == 0 || out_count[node] == 0)) {
+                active[node] = 0;
+                component[node] = node;
+                removed.push_back(node);
+            }
+        //every removed node takes its edges away from its neighbors that are still active
+        while (!removed.empty()) {
+            std::sort(removed.begin(), removed.end());
+            util::Vector< int > next;
+            TrimVisitor successors(active, component, in_count, next);
+            visit_lists(successors_, removed, successors);
+            TrimVisitor predecessors(active, component, out_count, next);
+            visit_lists(predecessors_, removed, predecessors);
+            removed = next;
+        }
+    }
+
+    void ExternalDirectedGraph::propagate(const AdjacencyFile &file, const util::Vector< char > &active,
+                                          util::Vector< int > &color, util::Vector< char > *marked) const {
+        int count = (int)file.partition_begin.size() - 1;
+        util::Vector< char > dirty((util::size_t)count, 0);
+        bool any = false;
+        for (int partition = 0; partition < count; ++partition)
+            for (int node = file.partition_begin[partition]; node < file.partition_begin[partition + 1]; ++node)
+                if (active[node] && (marked == NULL || (*marked)[node])) {
+                    dirty[partition] = 1;
+                    any = true;
+                    break;
+                }
+
+        ColorVisitor visitor(file.partition_begin, active, color, marked, dirty);
+        while (any) {
+            scan(file, dirty, visitor.forward, visitor);
+            visitor.forward = !visitor.forward;
+            any = false;
+            for (int partition = 0; partition < count && !any; ++partition)
+                any = (dirty[partition] != 0);
+        }
+    }
+
+    util::Vector< util::Vector< int > > ExternalDirectedGraph::get_strongly_connected_components() const {
+        DGRAPH_TRACE_SCOPE("external/scc");
+        util::Vector< char > active((util::size_t)node_count_, 1), marked((util::size_t)node_count_, 0);
+        util::Vector< int > component((util::size_t)node_count_, -1), color((util::size_t)node_count_, 0);
+        for (;;) {
+            trim(active, component);
+            bool any = false;
+            for (int node = 0; node < node_count_; ++node)
+                if (active[node]) {
+                    color[node] = node;
+                    any = true;
+                }
+            if (!any)
+                break;
+
+            //the nodes of the component of a root are the ones of its color that reach it
+            propagate(successors_, active, color, NULL);
+            for (int node = 0; node < node_count_; ++node)
+                marked[node] = (char)(active[node] && color[node] == node);
+            propagate(predecessors_, active, color, &marked);
+            for (int node = 0; node < node_count_; ++node)
+                if (active[node] && marked[node]) {
+                    component[node] = color[node];
+                    active[node] = 0;
+                }
+        }
+
+        //the nodes are visited in increasing order, so the components come sorted by their smallest id
+        util::Vector< int > index((util::size_t)node_count_, -1);
+        util::Vector< util::Vector< int > > components;
+        for (int node = 0; node < node_count_; ++node) {
+            int root = component[node];
+            if (index[root] == -1) {
+                index[root] = (int)components.size();
+                components.push_back(util::Vector< int >());
+            }
+            components[index[root]].push_back(node);
+        }
+        return components;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef DIRECTEDGRAPHHANDLER_EXTERNAL_DIRECTED_GRAPH_H
+#define DIRECTEDGRAPHHANDLER_EXTERNAL_DIRECTED_GRAPH_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include "util_vector.h"
+#include "util_binary_io.h"
+#include "compressed_directed_graph.h"
+#include "directed_graph_exceptions.h"
+
+namespace dgraph {
+
+    //read-only graph whose adjacency lists stay on disk, for graphs larger than the memory
+    //the successor and predecessor lists are stored in CSR order in two files, delta-encoded as
+    //in CompressedDirectedGraph, and split into partitions of consecutive nodes whose lists fit in
+    //the memory budget. Only the O(N) per-node state lives in memory: the offsets of the lists
+    //and whatever the algorithms keep per node; the lists themselves are streamed one partition
+    //at a time, so the algorithms mostly read the files sequentially.
+    //the directory holds "index.bin", "successors.bin" and "predecessors.bin"
+    class ExternalDirectedGraph {
+      public:
+        //opens a graph laid out in directory by build
+        //throws std::runtime_error if the files cannot be read and bad_dgraph_config if they are not valid
+        explicit ExternalDirectedGraph(const std::string& directory, std::size_t memory_budget = 64 << 20);
+        virtual ~ExternalDirectedGraph();
+
+        //reads a graph in the text format of DirectedGraph and lays it out in directory
+        //the edges are sorted in runs of at most memory_budget bytes, which are written to
+        //temporary files and merged; throws bad_dgraph_config for invalid input, as operator>> does
+        static void build(std::istream& in, const std::string& directory, std::size_t memory_budget = 64 << 20);
+
+        int node_count() const;
+        long long edge_count() const;
+        std::size_t memory_budget() const;
+        int partition_count() const;
+
+        //semi-external bfs: one pass over the partitions that hold the current level, per level;
+        //a partition with only a few nodes of the level has just their lists read
+        //returns the nodes in the same order as DirectedGraph::breadth_first_search
+        util::Vector< int > breadth_first_search(int source_id = 0) const;
+
+        //semi-external scc by coloring: the largest id that reaches a node is propagated along
+        //the successor lists, then every node whose color is its own id collects its component
+        //along the predecessor lists among the nodes of that color; the colored nodes are removed
+        //and the rest is colored again. The nodes without incoming or outgoing edges among the
+        //remaining ones are split off first. The propagation rescans only the partitions whose
+        //nodes changed color, alternating the direction of the scans.
+        //returns the components sorted by their smallest id, each sorted by id
+        util::Vector< util::Vector< int > > get_strongly_connected_components() const;
+
+        //number of bytes read from the adjacency files so far, and the number of reads
+        unsigned long long bytes_read() const;
+        unsigned long long read_count() const;
+      private:
+        ExternalDirectedGraph(const ExternalDirectedGraph& rhs);
+        ExternalDirectedGraph& operator = (const ExternalDirectedGraph& rhs);
+
+        //one adjacency file with its offsets and partitions
+        struct AdjacencyFile {
+            AdjacencyFile() : fd(-1) {}
+            int fd;
+            std::string path;
+            //the list of node i takes the bytes [offsets[i], offsets[i + 1])
+            util::Vector< unsigned long long > offsets;
+            //partition p holds the nodes [partition_begin[p], partition_begin[p + 1])
+            util::Vector< int > partition_begin;
+        };
+
+        //reads the offsets of the lists of one file and opens it
+        void open_file(AdjacencyFile& file, util::BinaryReader& index, const std::string& name);
+        //cuts the nodes into partitions whose lists take at most partition_bytes
+        void split_partitions(AdjacencyFile& file) const;
+        int partition_of(const AdjacencyFile& file, int node) const;
+        //reads the bytes [begin, end) of a file to the start of buffer, which grows when it is too small
+        void read_range(const AdjacencyFile& file, unsigned long long begin, unsigned long long end,
+                        util::Vector< unsigned char >& buffer) const;
+
+        //calls visitor(node, cursor) with the list of every node in nodes, which must be sorted;
+        //a partition is read whole, unless its nodes in the list are so few that reading
+        //just their lists costs less
+        template<typename Visitor>
+        void visit_lists(const AdjacencyFile& file, const util::Vector< int >& nodes, Visitor& visitor) const;
+        //calls visitor(node, cursor) with the list of every node in the partitions p with
+        //partitions[p] set, which are cleared as they are read; the nodes come in increasing
+        //or decreasing order
+        template<typename Visitor>
+        void scan(const AdjacencyFile& file, util::Vector< char >& partitions, bool forward, Visitor& visitor) const;
+
+        //propagates colors along the edges of file among the active nodes until they are stable:
+        //without marked, the largest color reaching a node wins; with marked, a marked node marks
+        //its neighbors of the same color
+        void propagate(const AdjacencyFile& file, const util::Vector< char >& active,
+                       util::Vector< int >& color, util::Vector< char >* marked) const;
+        //removes from active the nodes left without incoming or outgoing edges among the active
+        //ones, repeatedly, making each of them a component of its own
+        void trim(util::Vector< char >& active, util::Vector< int >& component) const;
+
+        std::string directory_;
+        std::size_t memory_budget_;
+        unsigned long long partition_bytes_;
+        int node_count_;
+        long long edge_count_;
+        AdjacencyFile successors_, predecessors_;
+        mutable unsigned long long bytes_read_, read_count_;
+    };
+}
+
+#endif //DIRECTEDGRAPHHANDLER_EXTERNAL_DIRECTED_GRAPH_H
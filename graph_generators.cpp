@@ -0,0 +1,156 @@
+#include <sstream>
+#include "graph_generators.h"
+
+namespace dgraph {
+    namespace generators {
+
+        namespace {
+            void sort_and_deduplicate(util::Vector< Edge >& edges) {
+                std::sort(edges.begin(), edges.end());
+                util::Vector< Edge > unique_edges;
+                for (int i = 0; i < (int)edges.size(); ++i)
+                    if (i == 0 || edges[i] != edges[i - 1])
+                        unique_edges.push_back(edges[i]);
+                edges = unique_edges;
+            }
+        }
+
+        //implementation of Random's methods
+        Random::Random(unsigned long long seed) : state_(seed == 0 ? 0x9E3779B97F4A7C15ULL : seed) {}
+
+        unsigned long long Random::next() {
+            //xorshift64* as described here:
+            //https://en.wikipedia.org/wiki/Xorshift#xorshift*
+            state_ ^= state_ >> 12;
+            state_ ^= state_ << 25;
+            state_ ^= state_ >> 27;
+            return state_ * 0x2545F4914F6CDD1DULL;
+        }
+
+        int Random::next_int(int bound) {
+            return (int)(next() % (unsigned long long)bound);
+        }
+
+        double Random::next_double() {
+            return (double)(next() >> 11) / 9007199254740992.0; //divided by 2^53
+        }
+
+        util::Vector< Edge > rmat(int node_count, int average_degree, unsigned long long seed) {
+            //implementation of R-MAT as explained here:
+            //https://www.cs.cmu.edu/~christos/PUBLICATIONS/siam04.pdf
+            const double a = 0.57, b = 0.19, c = 0.19;
+            Random random(seed);
+            int scale = 0;
+            while ((1 << scale) < node_count)
+                scale++;
+
+            util::Vector< Edge > edges;
+            long long samples = (long long)node_count * average_degree;
+            for (long long k = 0; k < samples; ++k) {
+                int from = 0, to = 0;
+                for (int bit = 0; bit < scale; ++bit) {
+                    double p = random.next_double();
+                    from <<= 1;
+                    to <<= 1;
+                    if (p < a)
+                        continue;
+                    else if (p < a + b)
+                        to |= 1;
+                    else if (p < a + b + c)
+                        from |= 1;
+                    else {
+                        from |= 1;
+                        to |= 1;
+                    }
+                }
+                //ids outside the range are folded back when node_count is not a power of 2
+                from %= node_count;
+                to %= node_count;
+                if (from != to)
+                    edges.push_back(Edge(from, to));
+            }
+            sort_and_deduplicate(edges);
+            return edges;
+        }
+
+        util::Vector< Edge > erdos_renyi(int node_count, int average_degree, unsigned long long seed) {
+            Random random(seed);
+            util::Vector< Edge > edges;
+            long long samples = (long long)node_count * average_degree;
+            for (long long k = 0; k < samples; ++k) {
+                int from = random.next_int(node_count);
+                int to = random.next_int(node_count);
+                if (from != to)
+                    edges.push_back(Edge(from, to));
+            }
+            sort_and_deduplicate(edges);
+            return edges;
+        }
+
+        util::Vector< Edge > chain(int node_count) {
+            util::Vector< Edge > edges;
+            for (int i = 0; i + 1 < node_count; ++i)
+                edges.push_back(Edge(i, i + 1));
+            return edges;
+        }
+
+        util::Vector< Edge > layered_dag(int node_count, int average_degree, int layer_width,
+                                         unsigned long long seed) {
+            Random random(seed);
+            util::Vector< Edge > edges;
+            if (layer_width < 1)
+                layer_width = 1;
+            for (int from = 0; from < node_count; ++from) {
+                int next_layer_begin = (from / layer_width + 1) * layer_width;
+                int next_layer_size = std::min(layer_width, node_count - next_layer_begin);
+                if (next_layer_size <= 0)
+                    break;
+                for (int k = 0; k < average_degree; ++k)
+                    edges.push_back(Edge(from, next_layer_begin + random.next_int(next_layer_size)));
+            }
+            sort_and_deduplicate(edges);
+            return edges;
+        }
+
+        void shuffle_ids(int node_count, util::Vector< Edge >& edges, unsigned long long seed) {
+            Random random(seed);
+            util::Vector< int > label(node_count, 0);
+            for (int i = 0; i < node_count; ++i)
+                label[i] = i;
+            for (int i = node_count - 1; i > 0; --i)
+                std::swap(label[i], label[random.next_int(i + 1)]);
+            for (int i = 0; i < (int)edges.size(); ++i)
+                edges[i] = Edge(label[edges[i].from_node_id()], label[edges[i].to_node_id()]);
+            sort_and_deduplicate(edges);
+        }
+
+        util::Vector< WeightedEdge > add_random_weights(const util::Vector< Edge >& edges, int max_weight,
+                                                        unsigned long long seed) {
+            Random random(seed);
+            util::Vector< WeightedEdge > res;
+            res.reserve(edges.size());
+            for (int i = 0; i < (int)edges.size(); ++i)
+                res.push_back(WeightedEdge(edges[i].from_node_id(), edges[i].to_node_id(),
+                                           1 + random.next_int(max_weight)));
+            return res;
+        }
+
+        std::string to_text(int node_count, util::Vector< Edge >& edges) {
+            sort_and_deduplicate(edges);
+            std::ostringstream out;
+            out << node_count << ' ' << edges.size() << '\n';
+            for (int i = 0; i < (int)edges.size(); ++i)
+                out << edges[i].from_node_id() << ' ' << edges[i].to_node_id() << '\n';
+            return out.str();
+        }
+
+        std::string to_text(int node_count, const util::Vector< WeightedEdge >& edges) {
+            std::ostringstream out;
+            out << node_count << ' ' << edges.size() << '\n';
+            for (int i = 0; i < (int)edges.size(); ++i)
+                out << edges[i].from_node_id() << ' ' << edges[i].to_node_id() << ' '
+                    << edges[i].payload() << '\n';
+            return out.str();
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef DIRECTEDGRAPHHANDLER_GRAPH_GENERATORS_H
+#define DIRECTEDGRAPHHANDLER_GRAPH_GENERATORS_H
+
+#include <string>
+#include "util_vector.h"
+#include "directed_graph.h"
+
+namespace dgraph {
+    namespace generators {
+
+        //small xorshift generator, so that the same seed gives the same graph on every platform
+        class Random {
+          public:
+            explicit Random(unsigned long long seed = 1);
+
+            unsigned long long next();
+            //uniform integer in [0, bound)
+            int next_int(int bound);
+            //uniform real in [0, 1)
+            double next_double();
+          private:
+            unsigned long long state_;
+        };
+
+        //every generator below returns a list of edges without self-loops or duplicates,
+        //sorted by (source, destination), over the nodes 0 .. node_count - 1
+
+        //recursive matrix (R-MAT) graph with node_count * average_degree edge samples
+        //and the usual (0.57, 0.19, 0.19, 0.05) quadrant probabilities; yields power-law degrees
+        util::Vector< Edge > rmat(int node_count, int average_degree, unsigned long long seed);
+
+        //Erdos-Renyi G(n, m) graph with m = node_count * average_degree uniformly chosen edges
+        util::Vector< Edge > erdos_renyi(int node_count, int average_degree, unsigned long long seed);
+
+        //the path 0 -> 1 -> ... -> node_count - 1, the worst case for recursion depth
+        util::Vector< Edge > chain(int node_count);
+
+        //DAG whose nodes are split into layers of layer_width nodes; every node gets up to
+        //average_degree edges towards random nodes of the next layer
+        util::Vector< Edge > layered_dag(int node_count, int average_degree, int layer_width,
+                                         unsigned long long seed);
+
+        //relabels the nodes with a random permutation, mimicking arbitrarily assigned ids
+        void shuffle_ids(int node_count, util::Vector< Edge >& edges, unsigned long long seed);
+
+        //attaches a uniform weight in [1, max_weight] to every edge, keeping their order
+        util::Vector< WeightedEdge > add_random_weights(const util::Vector< Edge >& edges, int max_weight,
+                                                        unsigned long long seed);
+
+        //sorts and deduplicates the edges, then writes them in the format read by DirectedGraph
+        std::string to_text(int node_count, util::Vector< Edge >& edges);
+        //writes the edges, which must already be sorted and unique, with their weights as a third column
+        std::string to_text(int node_count, const util::Vector< WeightedEdge >& edges);
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_GRAPH_GENERATORS_H
@@ -0,0 +1,412 @@
+#ifndef DIRECTEDGRAPHHANDLER_GRAPH_JOURNAL_H
+#define DIRECTEDGRAPHHANDLER_GRAPH_JOURNAL_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "util_binary_io.h"
+#include "directed_graph.h"
+
+namespace dgraph {
+
+    //keeps a graph recoverable across restarts: every mutation applied to the graph is appended
+    //to a binary log, and every checkpoint_interval mutations the whole graph is written to a
+    //checkpoint, after which the log starts over. Recovery loads the checkpoint and replays the
+    //log, so it costs one binary load plus the mutations since the last checkpoint, instead of
+    //parsing the original text and replaying the whole history.
+    //a log record is [length][CRC-32][sequence number][type][data]; the first record that is cut
+    //short or fails its checksum, as left by a crash in the middle of a write, ends the log and
+    //is truncated together with everything after it.
+    //the directory holds "checkpoint" and "mutations.log"; a checkpoint is written to a temporary
+    //file that is renamed over the previous one, so a crash leaves either the old or the new one,
+    //and the records it already covers are recognized by their sequence numbers
+    template<typename Graph = DirectedGraph>
+    class GraphJournal : public MutationListener< typename Graph::id_type, typename Graph::payload_type > {
+      public:
+        typedef typename Graph::id_type IdType;
+        typedef typename Graph::offset_type OffsetType;
+        typedef typename Graph::payload_type PayloadType;
+        typedef typename Graph::Edge Edge;
+
+        //replaces graph by the one recovered from directory, or writes graph there as the first
+        //checkpoint if the directory holds none, then records the mutations of graph until the
+        //journal is destroyed. throws std::runtime_error if a file cannot be accessed and
+        //bad_dgraph_config if the checkpoint or the log do not describe a valid graph
+        GraphJournal(Graph& graph, const std::string& directory, std::size_t checkpoint_interval = 1 << 16);
+        //detaches from the graph; the log is kept, so nothing recorded is lost
+        virtual ~GraphJournal();
+
+        //method that writes a checkpoint of the graph now and empties the log
+        void checkpoint();
+
+        //method that sets the number of records after which a checkpoint is written (0 for never)
+        void set_checkpoint_interval(std::size_t records);
+        //when set, every record reaches stable storage (fdatasync) before the mutation returns;
+        //otherwise it is only handed to the operating system, which survives a crash of the
+        //process but not of the machine. Checkpoints are always synced
+        void set_sync(bool sync);
+
+        //number of records replayed by the recovery, and of log bytes it truncated
+        std::size_t replayed_records() const;
+        std::size_t truncated_bytes() const;
+        //number of records in the log, i.e. written since the last checkpoint
+        std::size_t log_records() const;
+        //sequence number of the last mutation recorded
+        unsigned long long sequence() const;
+
+        //the MutationListener interface; throw std::runtime_error if the record cannot be written,
+        //in which case the mutation stays applied to the graph in memory
+        virtual void node_added(IdType id, const util::Vector< Edge >& edges);
+        virtual void edge_removed(IdType from, IdType to);
+        virtual void node_removed(IdType id);
+      private:
+        GraphJournal(const GraphJournal& rhs);
+        GraphJournal& operator = (const GraphJournal& rhs);
+
+        enum RecordType {
+            NODE_ADDED = 1, EDGE_REMOVED = 2, NODE_REMOVED = 3
+        };
+
+        //size of the length and checksum that precede the body of a record
+        static const std::size_t record_header_size = 2 * sizeof(unsigned int);
+
+        std::string checkpoint_path() const;
+        std::string log_path() const;
+
+        //loads the checkpoint (or writes the first one) and replays the log into graph_
+        void recover();
+        //applies the records of log that follow the checkpoint; returns the length of the valid prefix
+        std::size_t replay(const std::string& log);
+        void apply(util::BinaryReader& record, unsigned char type);
+
+        //starts a record of the given type with the next sequence number
+        void begin_record(util::BinaryWriter& body, RecordType type);
+        //frames the body and appends it to the log, checkpointing if the interval is reached
+        void append(const util::BinaryWriter& body);
+
+        Graph& graph_;
+        std::string directory_;
+        std::size_t checkpoint_interval_;
+        bool sync_;
+        int log_fd_;
+        unsigned long long sequence_;
+        std::size_t log_records_, replayed_records_, truncated_bytes_;
+    };
+
+    namespace detail {
+        inline std::runtime_error journal_error(const std::string& what, const std::string& path) {
+            return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+
+        //forces a file, or the entries of a directory, to stable storage
+        inline void sync_path(const std::string& path) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw journal_error("cannot open", path);
+            int status = fsync(fd);
+            close(fd);
+            if (status != 0)
+                throw journal_error("cannot sync", path);
+        }
+
+        inline int sync_data(int fd) {
+#ifdef __APPLE__
+            return fsync(fd);
+#else
+            return fdatasync(fd);
+#endif
+        }
+    }
+
+    //implementation of GraphJournal's methods
+    template<typename Graph>
+    GraphJournal<Graph>::GraphJournal(Graph &graph, const std::string &directory, std::size_t checkpoint_interval) :
+            graph_(graph), directory_(directory), checkpoint_interval_(checkpoint_interval), sync_(false),
+            log_fd_(-1), sequence_(0), log_records_(0), replayed_records_(0), truncated_bytes_(0) {
+        //the replayed mutations must not be reported to anyone
+        graph_.set_mutation_listener(NULL);
+        try {
+            recover();
+        }
+        catch (...) {
+            if (log_fd_ >= 0)
+                close(log_fd_);
+            throw;
+        }
+        graph_.set_mutation_listener(this);
+    }
+
+    template<typename Graph>
+    GraphJournal<Graph>::~GraphJournal() {
+        if (graph_.get_mutation_listener() == this)
+            graph_.set_mutation_listener(NULL);
+        if (log_fd_ >= 0)
+            close(log_fd_);
+    }
+
+    template<typename Graph>
+    std::string GraphJournal<Graph>::checkpoint_path() const {
+        return directory_ + "/checkpoint";
+    }
+
+    template<typename Graph>
+    std::string GraphJournal<Graph>::log_path() const {
+        return directory_ + "/mutations.log";
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::recover() {
+        DGRAPH_TRACE_SCOPE("journal_recover");
+        if (mkdir(directory_.c_str(), 0777) != 0 && errno != EEXIST)
+            throw detail::journal_error("cannot create", directory_);
+        log_fd_ = open(log_path().c_str(), O_RDWR | O_CREAT | O_APPEND, 0666);
+        if (log_fd_ < 0)
+            throw detail::journal_error("cannot open", log_path());
+
+        std::ifstream checkpoint_in(checkpoint_path().data(), std::ios::binary);
+        if (!checkpoint_in) {
+            //a log without a checkpoint cannot be replayed onto anything
+            if (lseek(log_fd_, 0, SEEK_END) > 0)
+                throw bad_dgraph_config();
+            checkpoint();
+            return;
+        }
+        {
+            util::BinaryReader reader(checkpoint_in);
+            char magic[4];
+            unsigned int checksum;
+            if (!reader.get_bytes(magic, 4) || std::memcmp(magic, "DGJC", 4) != 0 || !reader.get(sequence_))
+                throw bad_dgraph_config();
+            unsigned int expected = reader.checksum();
+            if (!reader.get(checksum) || checksum != expected)
+                throw bad_dgraph_config();
+        }
+        //the graph image starts right after the 16 bytes of the header
+        checkpoint_in.clear();
+        checkpoint_in.seekg(4 + sizeof(unsigned long long) + sizeof(unsigned int));
+        graph_.read_binary(checkpoint_in);
+        checkpoint_in.close();
+
+        std::string log;
+        char chunk[1 << 16];
+        lseek(log_fd_, 0, SEEK_SET);
+        for (;;) {
+            ssize_t count = read(log_fd_, chunk, sizeof(chunk));
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count < 0)
+                throw detail::journal_error("cannot read", log_path());
+            if (count == 0)
+                break;
+            log.append(chunk, (std::size_t)count);
+        }
+        std::size_t valid = replay(log);
+        if (valid < log.size()) {
+            truncated_bytes_ = log.size() - valid;
+            if (ftruncate(log_fd_, (off_t)valid) != 0)
+                throw detail::journal_error("cannot truncate", log_path());
+        }
+    }
+
+    template<typename Graph>
+    std::size_t GraphJournal<Graph>::replay(const std::string &log) {
+        std::size_t position = 0;
+        while (log.size() - position >= record_header_size) {
+            unsigned int length, checksum;
+            std::memcpy(&length, log.data() + position, sizeof(unsigned int));
+            std::memcpy(&checksum, log.data() + position + sizeof(unsigned int), sizeof(unsigned int));
+            const char* body = log.data() + position + record_header_size;
+            if (length > log.size() - position - record_header_size || util::crc32(body, length) != checksum)
+                break; //a torn or corrupted tail
+
+            util::BinaryReader record(body, length);
+            unsigned long long sequence;
+            unsigned char type;
+            if (!record.get(sequence) || !record.get(type))
+                throw bad_dgraph_config();
+            //a record may already be part of a checkpoint written just before a crash
+            if (sequence > sequence_) {
+                if (sequence != sequence_ + 1)
+                    throw bad_dgraph_config(); //records are missing
+                apply(record, type);
+                sequence_ = sequence;
+                replayed_records_++;
+            }
+            log_records_++;
+            position += record_header_size + length;
+        }
+        return position;
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::apply(util::BinaryReader &record, unsigned char type) {
+        //the graph reports invalid ids as out_of_range, which here means a log that does not
+        //belong to the checkpoint
+        try {
+            if (type == NODE_ADDED) {
+                IdType id;
+                OffsetType count;
+                if (!record.get(id) || !record.get(count) || id != graph_.node_count() || count < 0)
+                    throw bad_dgraph_config();
+                util::Vector< Edge > edges;
+                for (OffsetType k = 0; k < count; ++k) {
+                    IdType from, to;
+                    PayloadType payload = PayloadType();
+                    if (!record.get(from) || !record.get(to) ||
+                            !PayloadTraits<PayloadType>::read_binary(record, payload))
+                        throw bad_dgraph_config();
+                    edges.push_back(Edge(from, to, payload));
+                }
+                graph_.add_new_node(edges);
+            }
+            else if (type == EDGE_REMOVED) {
+                IdType from, to;
+                if (!record.get(from) || !record.get(to))
+                    throw bad_dgraph_config();
+                graph_.remove_edge(from, to);
+            }
+            else if (type == NODE_REMOVED) {
+                IdType id;
+                if (!record.get(id))
+                    throw bad_dgraph_config();
+                graph_.remove_node(id);
+            }
+            else
+                throw bad_dgraph_config();
+        }
+        catch (std::out_of_range&) {
+            throw bad_dgraph_config();
+        }
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::checkpoint() {
+        DGRAPH_TRACE_SCOPE("journal_checkpoint");
+        std::string temporary_path = checkpoint_path() + ".tmp";
+        {
+            std::ofstream out(temporary_path.data(), std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw detail::journal_error("cannot create", temporary_path);
+            util::BinaryWriter header(out);
+            header.put_bytes("DGJC", 4);
+            header.put(sequence_);
+            header.put(header.checksum());
+            header.flush();
+            graph_.write_binary(out);
+            out.close();
+            if (!out)
+                throw detail::journal_error("cannot write", temporary_path);
+        }
+        detail::sync_path(temporary_path);
+        if (std::rename(temporary_path.c_str(), checkpoint_path().c_str()) != 0)
+            throw detail::journal_error("cannot replace", checkpoint_path());
+        detail::sync_path(directory_);
+
+        //a crash before this point leaves records that the new checkpoint already covers,
+        //which recovery skips by their sequence numbers
+        if (ftruncate(log_fd_, 0) != 0)
+            throw detail::journal_error("cannot truncate", log_path());
+        log_records_ = 0;
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::set_checkpoint_interval(std::size_t records) {
+        checkpoint_interval_ = records;
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::set_sync(bool sync) {
+        sync_ = sync;
+    }
+
+    template<typename Graph>
+    std::size_t GraphJournal<Graph>::replayed_records() const {
+        return replayed_records_;
+    }
+
+    template<typename Graph>
+    std::size_t GraphJournal<Graph>::truncated_bytes() const {
+        return truncated_bytes_;
+    }
+
+    template<typename Graph>
+    std::size_t GraphJournal<Graph>::log_records() const {
+        return log_records_;
+    }
+
+    template<typename Graph>
+    unsigned long long GraphJournal<Graph>::sequence() const {
+        return sequence_;
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::begin_record(util::BinaryWriter &body, RecordType type) {
+        body.put(sequence_ + 1);
+        body.put((unsigned char)type);
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::append(const util::BinaryWriter &body) {
+        //the record goes out with a single write, so a crash can only cut it at its end
+        util::BinaryWriter record;
+        record.put((unsigned int)body.buffer().size());
+        record.put(body.checksum());
+        record.put_bytes(body.buffer().data(), body.buffer().size());
+        const std::string& data = record.buffer();
+        std::size_t written = 0;
+        while (written < data.size()) {
+            ssize_t count = write(log_fd_, data.data() + written, data.size() - written);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                throw detail::journal_error("cannot append to", log_path());
+            written += (std::size_t)count;
+        }
+        if (sync_ && detail::sync_data(log_fd_) != 0)
+            throw detail::journal_error("cannot sync", log_path());
+        sequence_++;
+        log_records_++;
+        if (checkpoint_interval_ > 0 && log_records_ >= checkpoint_interval_)
+            checkpoint();
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::node_added(IdType id, const util::Vector<Edge> &edges) {
+        util::BinaryWriter body;
+        begin_record(body, NODE_ADDED);
+        body.put(id);
+        body.put((OffsetType)edges.size());
+        for (util::size_t k = 0; k < edges.size(); ++k) {
+            body.put(edges[k].from_node_id());
+            body.put(edges[k].to_node_id());
+            PayloadTraits<PayloadType>::write_binary(body, edges[k].payload());
+        }
+        append(body);
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::edge_removed(IdType from, IdType to) {
+        util::BinaryWriter body;
+        begin_record(body, EDGE_REMOVED);
+        body.put(from);
+        body.put(to);
+        append(body);
+    }
+
+    template<typename Graph>
+    void GraphJournal<Graph>::node_removed(IdType id) {
+        util::BinaryWriter body;
+        begin_record(body, NODE_REMOVED);
+        body.put(id);
+        append(body);
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_GRAPH_JOURNAL_H
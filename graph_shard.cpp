@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "util_trace.h"
+#include "graph_shard.h"
+
+namespace dgraph {
+
+    namespace {
+        //orders the candidates of an expansion by node, the smallest position first
+        bool by_node(const ShardEntry& lhs, const ShardEntry& rhs) {
+            return lhs.node < rhs.node || (lhs.node == rhs.node && lhs.rank < rhs.rank);
+        }
+
+        void fail(std::string& response, ShardStatus status, const char* message) {
+            response.assign(1, (char)status);
+            response += message;
+        }
+
+        bool write_all(int fd, const char* data, std::size_t size) {
+            std::size_t written = 0;
+            while (written < size) {
+#ifdef MSG_NOSIGNAL
+                //a coordinator that went away must not kill the shard with SIGPIPE
+                ssize_t count = send(fd, data + written, size - written, MSG_NOSIGNAL);
+                if (count < 0 && errno == ENOTSOCK)
+                    count = write(fd, data + written, size - written);
+#else
+                ssize_t count = write(fd, data + written, size - written);
+#endif
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                    return false;
+                written += (std::size_t)count;
+            }
+            return true;
+        }
+
+        bool read_all(int fd, char* data, std::size_t size) {
+            std::size_t done = 0;
+            while (done < size) {
+                ssize_t count = read(fd, data + done, size - done);
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                    return false;
+                done += (std::size_t)count;
+            }
+            return true;
+        }
+    }
+
+    namespace detail {
+        bool write_frame(int fd, const std::string& message) {
+            unsigned int length = (unsigned int)message.size();
+            return write_all(fd, reinterpret_cast<const char*>(&length), sizeof(length)) &&
+                   write_all(fd, message.data(), message.size());
+        }
+
+        bool read_frame(int fd, std::string& message) {
+            unsigned int length;
+            if (!read_all(fd, reinterpret_cast<char*>(&length), sizeof(length)))
+                return false;
+            message.resize(length);
+            return length == 0 || read_all(fd, &message[0], length);
+        }
+    }
+
+    //implementation of GraphShard's methods
+    GraphShard::GraphShard() : node_count_(0), begin_(0), end_(0), offsets_(1, 0) {}
+
+    GraphShard::~GraphShard() {}
+
+    void GraphShard::handle(const std::string &request, std::string &response) {
+        try {
+            run(request, response);
+        }
+        catch (bad_dgraph_config&) {
+            fail(response, SHARD_BAD_CONFIG, "");
+        }
+        catch (std::out_of_range& error) {
+            fail(response, SHARD_OUT_OF_RANGE, error.what());
+        }
+        catch (std::exception& error) {
+            fail(response, SHARD_ERROR, error.what());
+        }
+    }
+
+    void GraphShard::run(const std::string &request, std::string &response) {
+        detail::MessageReader reader(request);
+        unsigned char type = reader.get< unsigned char >();
+        response.assign(1, (char)SHARD_OK);
+        util::Vector< ShardEntry > entries;
+        switch (type) {
+            case SHARD_LOAD: {
+                int node_count = reader.get< int >(), begin = reader.get< int >(), end = reader.get< int >();
+                if (node_count < 0 || begin < 0 || begin > end || end > node_count)
+                    throw bad_dgraph_config();
+                node_count_ = node_count;
+                begin_ = begin;
+                end_ = end;
+                pending_ = util::Vector< ShardEntry >();
+                offsets_ = util::Vector< long long >((util::size_t)(end_ - begin_) + 1, 0);
+                targets_ = util::Vector< int >();
+                visited_ = util::Vector< char >((util::size_t)(end_ - begin_), 0);
+                break;
+            }
+            case SHARD_EDGES:
+                reader.get_entries(entries);
+                for (util::size_t i = 0; i < entries.size(); ++i) {
+                    if (entries[i].rank < begin_ || entries[i].rank >= end_ ||
+                            entries[i].node < 0 || entries[i].node >= node_count_)
+                        throw bad_dgraph_config();
+                    pending_.push_back(entries[i]);
+                }
+                break;
+            case SHARD_FINISH: {
+                DGRAPH_TRACE_SCOPE("shard/build");
+                std::sort(pending_.begin(), pending_.end());
+                for (util::size_t i = 1; i < pending_.size(); ++i)
+                    if (pending_[i].rank == pending_[i - 1].rank && pending_[i].node == pending_[i - 1].node)
+                        throw bad_dgraph_config();
+                targets_ = util::Vector< int >(pending_.size(), 0);
+                util::size_t edge = 0;
+                for (int node = begin_; node < end_; ++node) {
+                    for (; edge < pending_.size() && pending_[edge].rank == node; ++edge)
+                        targets_[edge] = pending_[edge].node;
+                    offsets_[node - begin_ + 1] = (long long)edge;
+                }
+                pending_ = util::Vector< ShardEntry >();
+                detail::append_field(response, (long long)targets_.size());
+                break;
+            }
+            case SHARD_RESET:
+                for (util::size_t i = 0; i < visited_.size(); ++i)
+                    visited_[i] = 0;
+                break;
+            case SHARD_EXPAND: {
+                DGRAPH_TRACE_SCOPE("shard/expand");
+                reader.get_entries(entries);
+                util::Vector< ShardEntry > candidates;
+                for (util::size_t i = 0; i < entries.size(); ++i) {
+                    check_owned(entries[i].node);
+                    int local = entries[i].node - begin_;
+                    for (long long edge = offsets_[local]; edge < offsets_[local + 1]; ++edge)
+                        candidates.push_back(ShardEntry(entries[i].rank, targets_[(util::size_t)edge]));
+                }
+                std::sort(candidates.begin(), candidates.end(), by_node);
+                util::Vector< ShardEntry > successors;
+                for (util::size_t i = 0; i < candidates.size(); ++i)
+                    if (i == 0 || candidates[i].node != candidates[i - 1].node)
+                        successors.push_back(candidates[i]);
+                detail::append_entries(response, successors);
+                break;
+            }
+            case SHARD_CLAIM: {
+                DGRAPH_TRACE_SCOPE("shard/claim");
+                reader.get_entries(entries);
+                //after sorting, the first entry of a node holds its smallest position
+                std::sort(entries.begin(), entries.end());
+                util::Vector< ShardEntry > claimed;
+                for (util::size_t i = 0; i < entries.size(); ++i) {
+                    check_owned(entries[i].node);
+                    char& visited = visited_[entries[i].node - begin_];
+                    if (!visited) {
+                        visited = 1;
+                        claimed.push_back(entries[i]);
+                    }
+                }
+                detail::append_entries(response, claimed);
+                break;
+            }
+            default:
+                throw std::runtime_error("unknown shard request");
+        }
+        if (!reader.at_end())
+            throw std::runtime_error("malformed shard message");
+    }
+
+    void GraphShard::check_owned(int node) const {
+        if (node < begin_ || node >= end_)
+            throw std::out_of_range("Invalid node id!");
+    }
+
+    void GraphShard::serve(int fd) {
+        std::string request, response;
+        while (detail::read_frame(fd, request)) {
+            handle(request, response);
+            if (!detail::write_frame(fd, response))
+                return;
+        }
+    }
+
+    void GraphShard::serve_socket(const std::string &path) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+            throw std::runtime_error("socket path too long: " + path);
+        std::strcpy(address.sun_path, path.c_str());
+
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0)
+            throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+        unlink(path.c_str());
+        if (bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 1) < 0) {
+            std::string message = std::string("cannot listen on ") + path + ": " + std::strerror(errno);
+            close(listener);
+            throw std::runtime_error(message);
+        }
+        int client;
+        do {
+            client = accept(listener, NULL, NULL);
+        } while (client < 0 && errno == EINTR);
+        close(listener);
+        unlink(path.c_str());
+        if (client < 0)
+            throw std::runtime_error(std::string("accept: ") + std::strerror(errno));
+        serve(client);
+        close(client);
+    }
+}
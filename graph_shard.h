@@ -0,0 +1,137 @@
+#ifndef DIRECTEDGRAPHHANDLER_GRAPH_SHARD_H
+#define DIRECTEDGRAPHHANDLER_GRAPH_SHARD_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "util_vector.h"
+#include "directed_graph_exceptions.h"
+
+namespace dgraph {
+
+    //the requests understood by a GraphShard; a request is its type byte followed by its fields,
+    //and is answered by exactly one response whose first byte is a ShardStatus
+    // -SHARD_LOAD node_count begin end: starts over as the owner of the ids [begin, end)
+    // -SHARD_EDGES entries: adds edges, as (source, destination) entries, whose sources it owns
+    // -SHARD_FINISH: builds the adjacency of the edges added since SHARD_LOAD
+    // -SHARD_RESET: forgets the nodes visited by the previous traversal
+    // -SHARD_EXPAND entries: (position, node) entries of the current level, for nodes it owns;
+    //          answers the successors of these nodes as (smallest position, successor) entries,
+    //          one per successor, sorted by successor
+    // -SHARD_CLAIM entries: (position, node) entries for nodes it owns; marks the unvisited ones
+    //          visited and answers them as (smallest position, node) entries, sorted
+    //a list of entries is a 32-bit count followed by the entries
+    enum ShardRequest {
+        SHARD_LOAD, SHARD_EDGES, SHARD_FINISH, SHARD_RESET, SHARD_EXPAND, SHARD_CLAIM
+    };
+
+    //a failed request answers its status followed by a message
+    enum ShardStatus {
+        SHARD_OK, SHARD_BAD_CONFIG, SHARD_OUT_OF_RANGE, SHARD_ERROR
+    };
+
+    //one entry of the frontier batches exchanged with the shards
+    struct ShardEntry {
+        ShardEntry() : rank(0), node(0) {}
+        ShardEntry(int rank, int node) : rank(rank), node(node) {}
+
+        bool operator < (const ShardEntry& rhs) const {
+            return rank < rhs.rank || (rank == rhs.rank && node < rhs.node);
+        }
+
+        int rank;
+        int node;
+    };
+
+    //the part of a sharded graph owned by one process: the successor lists of a range of node
+    //ids and which of those nodes the current traversal has visited
+    class GraphShard {
+      public:
+        GraphShard();
+        virtual ~GraphShard();
+
+        //method that answers one request; failures are reported in the response, never thrown
+        void handle(const std::string& request, std::string& response);
+
+        //method that answers the framed requests read from fd until it is closed
+        void serve(int fd);
+        //the same for the first coordinator that connects to a unix domain socket at path
+        //throws std::runtime_error if the socket cannot be created
+        void serve_socket(const std::string& path);
+      private:
+        GraphShard(const GraphShard& rhs);
+        GraphShard& operator = (const GraphShard& rhs);
+
+        void run(const std::string& request, std::string& response);
+        void check_owned(int node) const;
+
+        int node_count_, begin_, end_;
+        //edges added since SHARD_LOAD, as (source, destination) entries
+        util::Vector< ShardEntry > pending_;
+        //successors of the node begin_ + i are targets_[offsets_[i], offsets_[i + 1])
+        util::Vector< long long > offsets_;
+        util::Vector< int > targets_;
+        util::Vector< char > visited_;
+    };
+
+    namespace detail {
+        //the messages are framed on a stream by a 32-bit length; both return false once
+        //the stream is closed or fails
+        bool write_frame(int fd, const std::string& message);
+        bool read_frame(int fd, std::string& message);
+
+        //the fields are appended and read in the native byte order of the host, without the
+        //checksum of util::BinaryWriter, which a socket does not need
+        template<typename T>
+        void append_field(std::string& message, const T& value) {
+            message.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        inline void append_entries(std::string& message, const util::Vector< ShardEntry >& entries) {
+            append_field(message, (unsigned int)entries.size());
+            if (!entries.empty())
+                message.append(reinterpret_cast<const char*>(entries.begin()), entries.size() * sizeof(ShardEntry));
+        }
+
+        //reads the fields of a message in order; throws std::runtime_error past its end
+        class MessageReader {
+          public:
+            explicit MessageReader(const std::string& message, std::size_t position = 0) :
+                    message_(message), position_(position) {}
+
+            template<typename T>
+            T get() {
+                T value;
+                get_bytes(&value, sizeof(T));
+                return value;
+            }
+
+            void get_entries(util::Vector< ShardEntry >& entries) {
+                unsigned int count = get< unsigned int >();
+                if (count > (message_.size() - position_) / sizeof(ShardEntry))
+                    throw std::runtime_error("malformed shard message");
+                entries = util::Vector< ShardEntry >(count);
+                get_bytes(entries.begin(), count * sizeof(ShardEntry));
+            }
+
+            bool at_end() const { return position_ == message_.size(); }
+          private:
+            MessageReader(const MessageReader& rhs);
+            MessageReader& operator = (const MessageReader& rhs);
+
+            void get_bytes(void* data, std::size_t size) {
+                if (size > message_.size() - position_)
+                    throw std::runtime_error("malformed shard message");
+                if (size > 0)
+                    std::memcpy(data, message_.data() + position_, size);
+                position_ += size;
+            }
+
+            const std::string& message_;
+            std::size_t position_;
+        };
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_GRAPH_SHARD_H
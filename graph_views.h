@@ -0,0 +1,206 @@
+#ifndef DIRECTEDGRAPHHANDLER_GRAPH_VIEWS_H
+#define DIRECTEDGRAPHHANDLER_GRAPH_VIEWS_H
+
+#include <stdexcept>
+#include "util_vector.h"
+#include "util_trace.h"
+#include "directed_graph.h"
+
+namespace dgraph {
+
+    //Views show a graph differently without copying its adjacency lists: they only decide which
+    //of its nodes and edges are visible and which way the edges point, so building one is O(1).
+    //A view refers to its graph, which must outlive it, and sees the later changes of the graph;
+    //a view built on another view keeps a copy of it, so views can be nested as temporaries,
+    //e.g. transposed(induced_subgraph(graph, mask)).
+    //every view provides the interface used by the algorithms at the end of this file and by
+    //detail::ParallelScc:
+    //  node_count(), is_node_deleted(id) for the nodes outside of the view,
+    //  is_edge_deleted(from, to) for the edges outside of the view,
+    //  successors(id), predecessors(id): lists that may hold edges outside of the view,
+    //  get_node_by_id(id): the node of the graph, whose own lists are not those of the view
+
+    namespace detail {
+        //how a view keeps the graph or view it is built on
+        template<typename Graph>
+        struct ViewOperand {
+            typedef Graph type;
+        };
+
+        template<typename IdType, typename OffsetType, typename PayloadType>
+        struct ViewOperand< BasicDirectedGraph< IdType, OffsetType, PayloadType > > {
+            typedef const BasicDirectedGraph< IdType, OffsetType, PayloadType >& type;
+        };
+    }
+
+    //the graph with every edge reversed, which reads the predecessor lists every node keeps
+    template<typename Graph>
+    class TransposedView {
+      public:
+        typedef typename Graph::id_type id_type;
+        typedef typename Graph::Node Node;
+
+        explicit TransposedView(const Graph& graph) : graph_(graph) {}
+
+        id_type node_count() const { return graph_.node_count(); }
+        bool is_node_deleted(id_type id) const { return graph_.is_node_deleted(id); }
+        bool is_edge_deleted(id_type from, id_type to) const { return graph_.is_edge_deleted(to, from); }
+        const util::Vector< id_type >& successors(id_type id) const { return detail::predecessor_list(graph_, id); }
+        const util::Vector< id_type >& predecessors(id_type id) const { return detail::successor_list(graph_, id); }
+        const Node* get_node_by_id(id_type id) const { return graph_.get_node_by_id(id); }
+      private:
+        typename detail::ViewOperand< Graph >::type graph_;
+    };
+
+    //the nodes whose entry in mask is true and the edges between them; the nodes are not renumbered
+    //the mask must outlive the view; nodes added to the graph later are outside of the view
+    template<typename Graph>
+    class InducedSubgraphView {
+      public:
+        typedef typename Graph::id_type id_type;
+        typedef typename Graph::Node Node;
+
+        //throws bad_dgraph_config unless the mask has an entry for every node of the graph
+        InducedSubgraphView(const Graph& graph, const util::Vector< bool >& mask) : graph_(graph), mask_(mask) {
+            if ((std::size_t)mask.size() != (std::size_t)graph.node_count())
+                throw bad_dgraph_config();
+        }
+
+        id_type node_count() const { return graph_.node_count(); }
+        bool is_node_deleted(id_type id) const { return !contains(id) || graph_.is_node_deleted(id); }
+        bool is_edge_deleted(id_type from, id_type to) const {
+            return !contains(from) || !contains(to) || graph_.is_edge_deleted(from, to);
+        }
+        const util::Vector< id_type >& successors(id_type id) const { return detail::successor_list(graph_, id); }
+        const util::Vector< id_type >& predecessors(id_type id) const { return detail::predecessor_list(graph_, id); }
+        const Node* get_node_by_id(id_type id) const { return graph_.get_node_by_id(id); }
+      private:
+        bool contains(id_type id) const { return (util::size_t)id < mask_.size() && mask_[id]; }
+
+        typename detail::ViewOperand< Graph >::type graph_;
+        const util::Vector< bool >& mask_;
+    };
+
+    //every node of the graph and the edges (from, to) for which predicate(from, to) is true
+    //the predicate is copied into the view and called whenever an algorithm looks at an edge
+    template<typename Graph, typename EdgePredicate>
+    class FilteredView {
+      public:
+        typedef typename Graph::id_type id_type;
+        typedef typename Graph::Node Node;
+
+        FilteredView(const Graph& graph, const EdgePredicate& predicate) : graph_(graph), predicate_(predicate) {}
+
+        id_type node_count() const { return graph_.node_count(); }
+        bool is_node_deleted(id_type id) const { return graph_.is_node_deleted(id); }
+        bool is_edge_deleted(id_type from, id_type to) const {
+            return graph_.is_edge_deleted(from, to) || !predicate_(from, to);
+        }
+        const util::Vector< id_type >& successors(id_type id) const { return detail::successor_list(graph_, id); }
+        const util::Vector< id_type >& predecessors(id_type id) const { return detail::predecessor_list(graph_, id); }
+        const Node* get_node_by_id(id_type id) const { return graph_.get_node_by_id(id); }
+      private:
+        typename detail::ViewOperand< Graph >::type graph_;
+        EdgePredicate predicate_;
+    };
+
+    //shorthands that deduce the type of the view
+    template<typename Graph>
+    TransposedView< Graph > transposed(const Graph& graph) {
+        return TransposedView< Graph >(graph);
+    }
+
+    template<typename Graph>
+    InducedSubgraphView< Graph > induced_subgraph(const Graph& graph, const util::Vector< bool >& mask) {
+        return InducedSubgraphView< Graph >(graph, mask);
+    }
+
+    template<typename Graph, typename EdgePredicate>
+    FilteredView< Graph, EdgePredicate > filtered(const Graph& graph, EdgePredicate predicate) {
+        return FilteredView< Graph, EdgePredicate >(graph, predicate);
+    }
+
+    //The traversals and component algorithms of DirectedGraph, for any view (or graph); they return
+    //what the member functions would return on a graph holding only the visible nodes and edges,
+    //and run the same code, from the detail namespace of directed_graph.h.
+    //the sources must be visible nodes, otherwise they throw out_of_range
+
+    namespace detail {
+        template<typename Graph>
+        void check_visible_node(const Graph& graph, typename Graph::id_type id) {
+            if (id < 0 || id >= graph.node_count() || graph.is_node_deleted(id))
+                throw std::out_of_range("Invalid node id!");
+        }
+    }
+
+    template<typename Graph>
+    util::Vector< const typename Graph::Node* > breadth_first_search(const Graph& graph,
+                                                                     typename Graph::id_type source_id = 0) {
+        detail::check_visible_node(graph, source_id);
+        DGRAPH_TRACE_SCOPE("view/breadth_first_search");
+        util::Vector< const typename Graph::Node* > res;
+        detail::run_bfs(graph, source_id, res);
+        return res;
+    }
+
+    template<typename Graph>
+    util::Vector< const typename Graph::Node* > depth_first_search(const Graph& graph,
+                                                                   typename Graph::id_type source_id = 0) {
+        detail::check_visible_node(graph, source_id);
+        DGRAPH_TRACE_SCOPE("view/depth_first_search");
+        util::Vector< const typename Graph::Node* > res;
+        detail::run_dfs(graph, source_id, res);
+        return res;
+    }
+
+    template<typename Graph>
+    util::Vector< util::Vector< const typename Graph::Node* > > strongly_connected_components(const Graph& graph) {
+        DGRAPH_TRACE_SCOPE("view/strongly_connected_components");
+        util::Vector< util::Vector< const typename Graph::Node* > > scc;
+        detail::tarjan_components(graph, scc);
+        return scc;
+    }
+
+    //the same components as strongly_connected_components, ordered as by
+    //DirectedGraph::parallel_strongly_connected_components
+    template<typename Graph>
+    util::Vector< util::Vector< const typename Graph::Node* > > parallel_strongly_connected_components(const Graph& graph) {
+        DGRAPH_TRACE_SCOPE("view/parallel_strongly_connected_components");
+        util::Vector< util::Vector< const typename Graph::Node* > > res;
+        detail::ParallelScc< Graph > scc(graph);
+        scc.run(res);
+        return res;
+    }
+
+    //throws bad_top_sort if the visible part of the graph has cycles
+    template<typename Graph>
+    util::Vector< const typename Graph::Node* > topological_sort(const Graph& graph) {
+        DGRAPH_TRACE_SCOPE("view/topological_sort");
+        util::Vector< const typename Graph::Node* > res;
+        detail::topological_order(graph, res);
+        return res;
+    }
+
+    //the dominators from root_id over the visible edges, as DirectedGraph::dominator_tree;
+    //on transposed(graph) from an exit node, these are the post-dominators
+    template<typename Graph>
+    DominatorTree< typename Graph::id_type > dominator_tree(const Graph& graph, typename Graph::id_type root_id = 0) {
+        typedef typename Graph::id_type IdType;
+        detail::check_visible_node(graph, root_id);
+        DGRAPH_TRACE_SCOPE("view/dominator_tree");
+        util::Vector< IdType > immediate_dominators;
+        detail::compute_dominators(graph, root_id, immediate_dominators);
+        return DominatorTree< IdType >(root_id, immediate_dominators);
+    }
+
+    //a bidirectional bfs, as DirectedGraph::has_path
+    template<typename Graph>
+    bool has_path(const Graph& graph, typename Graph::id_type from_id, typename Graph::id_type to_id) {
+        detail::check_visible_node(graph, from_id);
+        detail::check_visible_node(graph, to_id);
+        DGRAPH_TRACE_SCOPE("view/has_path");
+        return detail::bidirectional_reachable(graph, from_id, to_id);
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_GRAPH_VIEWS_H
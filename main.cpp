@@ -1,7 +1,11 @@
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
 #include <string>
+#include <stdexcept>
 #include "directed_graph.h"
+#include "query_server.h"
+#include "graph_shard.h"
 
 class Tester {
   public:
@@ -110,17 +114,108 @@ class Tester {
     dgraph::DirectedGraph directed_graph_, directed_graph_2_;
 };
 
-int main() {
-    Tester tester;
-    tester.load_test("data.in");
-    //tester.topological_sort("topological_sort.out");
-    tester.bfs("bfs.out");
-    tester.dfs("dfs.out");
-    tester.scc("scc.out");
-    tester.path_matrix("path_matrix.out");
-    tester.graph_reunion("graph_reunion.out");
-    tester.add_new_node("");
-    tester.print_graph("data.out");
+//loads the first graph of graph_path once, then answers queries about it until told to stop
+//(see QueryServer for the commands), from stdin or from a unix domain socket
+int serve(const std::string& graph_path, const std::string& socket_path, double time_limit) {
+    try {
+        dgraph::DirectedGraph graph;
+        std::ifstream fin(graph_path.data());
+        if (!fin)
+            throw std::runtime_error("cannot open " + graph_path);
+        fin >> graph;
+        fin.close();
 
+        dgraph::QueryServer server(graph);
+        server.set_time_limit(time_limit);
+        if (socket_path == "")
+            server.serve_stream(0, 1);
+        else
+            server.serve_socket(socket_path);
+        server.write_latency_report(std::cerr);
+    }
+    catch (std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+//serves one shard of a ShardedDirectedGraph to the first coordinator that connects to the
+//unix domain socket at socket_path (see UnixSocketTransport), until it disconnects
+int serve_shard(const std::string& socket_path) {
+    try {
+        dgraph::GraphShard shard;
+        shard.serve_socket(socket_path);
+    }
+    catch (std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
     return 0;
+}
+
+int main(int argc, char** argv) {
+#ifdef DGRAPH_ENABLE_TRACING
+    util::trace::set_enabled(true);
+#endif
+    bool server_mode = false;
+    std::string graph_path = "data.in", socket_path, shard_path;
+    double time_limit = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--serve")
+            server_mode = true;
+        else if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+            server_mode = true;
+        }
+        else if (arg == "--graph" && i + 1 < argc)
+            graph_path = argv[++i];
+        else if (arg == "--shard" && i + 1 < argc)
+            shard_path = argv[++i];
+        else if (arg == "--time-limit" && i + 1 < argc)
+            time_limit = std::atof(argv[++i]) / 1000;
+        else {
+            std::cerr << "usage: " << argv[0] << " [--serve] [--socket PATH] [--graph FILE] [--shard PATH]\n"
+                      << "       [--time-limit MS]\n"
+                      << "  without options, runs the operations of the Tester on data.in\n"
+                      << "  --serve         loads the graph once and answers commands read from stdin\n"
+                      << "  --socket PATH   the same, over a unix domain socket at PATH\n"
+                      << "  --graph FILE    graph loaded by the server (default data.in)\n"
+                      << "  --time-limit MS cancels the scc and topological_sort commands of the server\n"
+                      << "                  that run longer than MS milliseconds\n"
+                      << "  --shard PATH    serves one shard of a sharded graph to the coordinator that\n"
+                      << "                  connects to the unix domain socket at PATH\n";
+            return 1;
+        }
+    }
+
+    int status = 0;
+    if (shard_path != "")
+        status = serve_shard(shard_path);
+    else if (server_mode)
+        status = serve(graph_path, socket_path, time_limit);
+    else {
+        Tester tester;
+        tester.load_test("data.in");
+        //tester.topological_sort("topological_sort.out");
+        tester.bfs("bfs.out");
+        tester.dfs("dfs.out");
+        tester.scc("scc.out");
+        tester.path_matrix("path_matrix.out");
+        tester.graph_reunion("graph_reunion.out");
+        tester.add_new_node("");
+        tester.print_graph("data.out");
+    }
+
+#ifdef DGRAPH_ENABLE_TRACING
+    std::ofstream trace_out("trace.json");
+    util::trace::write_chrome_trace(trace_out);
+    trace_out.close();
+    std::ofstream summary_out("trace_summary.out");
+    util::trace::write_summary(summary_out);
+    summary_out.close();
+#endif
+
+    return status;
 }
\ No newline at end of file
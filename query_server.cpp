@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "query_server.h"
+
+namespace dgraph {
+
+    namespace {
+        const char* command_names[] = {
+            "bfs", "dfs", "scc", "topological_sort", "reach", "add_node", "remove_edge", "remove_node",
+            "stats", "latency", "quit", "shutdown", "unknown"
+        };
+
+        const std::size_t read_buffer_size = 1 << 16;
+
+        double now_us() {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+        }
+
+        int read_id(std::istream& arguments) {
+            int id;
+            if (!(arguments >> id))
+                throw std::invalid_argument("missing or invalid node id");
+            return id;
+        }
+
+        //the arguments must be followed by nothing but whitespace
+        void expect_end(std::istream& arguments) {
+            std::string extra;
+            if (arguments >> extra)
+                throw std::invalid_argument("too many arguments");
+        }
+
+        void write_nodes(std::ostream& out, const util::Vector< const Node* >& nodes) {
+            for (util::size_t i = 0; i < nodes.size(); ++i)
+                out << (i == 0 ? "" : " ") << nodes[i]->get_id();
+        }
+
+        //waits at most time_limit seconds for the result of operation, which is cancelled after that
+        template<typename Result>
+        const Result& wait_result(const AsyncOperation< Result >& operation, double time_limit) {
+            if (!operation.wait_for(time_limit)) {
+                operation.cancel();
+                throw std::runtime_error("time limit exceeded");
+            }
+            return operation.get();
+        }
+
+        //writes the whole buffer, which may take several calls for sockets and pipes
+        bool write_all(int fd, const std::string& data) {
+            std::size_t written = 0;
+            while (written < data.size()) {
+#ifdef MSG_NOSIGNAL
+                //a client that disconnected must not kill the server with SIGPIPE
+                ssize_t count = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+                if (count < 0 && errno == ENOTSOCK)
+                    count = write(fd, data.data() + written, data.size() - written);
+#else
+                ssize_t count = write(fd, data.data() + written, data.size() - written);
+#endif
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                    return false;
+                written += (std::size_t)count;
+            }
+            return true;
+        }
+    }
+
+    //implementation of QueryServer's methods
+    QueryServer::QueryServer(DirectedGraph &graph) : graph_(graph), time_limit_(0), shutdown_(false) {}
+
+    QueryServer::~QueryServer() {}
+
+    void QueryServer::set_time_limit(double seconds) {
+        time_limit_ = seconds;
+    }
+
+    QueryServer::Command QueryServer::parse_command(const std::string &name) {
+        for (int command = 0; command < UNKNOWN; ++command)
+            if (name == command_names[command])
+                return (Command)command;
+        return UNKNOWN;
+    }
+
+    bool QueryServer::execute(const std::string &command, std::string &out) {
+        double start_us = now_us();
+        std::istringstream arguments(command);
+        std::string name;
+        if (!(arguments >> name))
+            return true; //blank lines get no response
+        Command parsed = parse_command(name);
+
+        std::ostringstream result;
+        bool failed = false;
+        try {
+            run(parsed, arguments, result);
+        }
+        catch (std::exception& error) {
+            failed = true;
+            result.str(error.what());
+        }
+
+        double latency_us = now_us() - start_us;
+        CommandStats& stats = stats_[parsed];
+        stats.calls++;
+        stats.errors += (failed ? 1 : 0);
+        stats.total_us += latency_us;
+        stats.max_us = std::max(stats.max_us, latency_us);
+
+        char header[64];
+        std::snprintf(header, sizeof(header), "%s %.1f", (failed ? "error" : "ok"), latency_us);
+        out += header;
+        std::string payload = result.str();
+        if (!payload.empty()) {
+            out += ' ';
+            out += payload;
+        }
+        out += '\n';
+        if (parsed == SHUTDOWN && !failed)
+            shutdown_ = true;
+        return (failed || (parsed != QUIT && parsed != SHUTDOWN));
+    }
+
+    void QueryServer::run(Command command, std::istream &arguments, std::ostream &out) {
+        switch (command) {
+            case BFS: {
+                int source_id = read_id(arguments);
+                expect_end(arguments);
+                write_nodes(out, graph_.breadth_first_search(source_id));
+                break;
+            }
+            case DFS: {
+                int source_id = read_id(arguments);
+                expect_end(arguments);
+                write_nodes(out, graph_.depth_first_search(source_id));
+                break;
+            }
+            case SCC: {
+                expect_end(arguments);
+                //the operation is waited for before the next command, which may change the graph
+                util::Vector< util::Vector< const Node* > > scc;
+                if (time_limit_ > 0)
+                    scc = wait_result(graph_.async_strongly_connected_components(), time_limit_);
+                else
+                    scc = graph_.get_strongly_connected_components();
+                for (util::size_t i = 0; i < scc.size(); ++i) {
+                    out << (i == 0 ? "" : " | ");
+                    write_nodes(out, scc[i]);
+                }
+                break;
+            }
+            case TOPOLOGICAL_SORT:
+                expect_end(arguments);
+                if (time_limit_ > 0)
+                    write_nodes(out, wait_result(graph_.async_topological_sort(), time_limit_));
+                else
+                    write_nodes(out, graph_.topological_sort());
+                break;
+            case REACH: {
+                int from_id = read_id(arguments), to_id = read_id(arguments);
+                expect_end(arguments);
+                out << (graph_.has_path(from_id, to_id) ? 1 : 0);
+                break;
+            }
+            case ADD_NODE:
+                //the rest of the line is in the format read by add_new_node
+                graph_.add_new_node(arguments);
+                expect_end(arguments);
+                out << graph_.node_count() - 1;
+                break;
+            case REMOVE_EDGE: {
+                int from_id = read_id(arguments), to_id = read_id(arguments);
+                expect_end(arguments);
+                graph_.remove_edge(from_id, to_id);
+                break;
+            }
+            case REMOVE_NODE: {
+                int id = read_id(arguments);
+                expect_end(arguments);
+                graph_.remove_node(id);
+                break;
+            }
+            case STATS:
+                expect_end(arguments);
+                out << "nodes " << graph_.live_node_count() << " edges " << graph_.edge_count();
+                break;
+            case LATENCY: {
+                expect_end(arguments);
+                std::ostringstream report;
+                write_latency_report(report);
+                //one response is one line
+                std::string text = report.str();
+                for (std::size_t i = 0; i + 1 < text.size(); ++i)
+                    out << (text[i] == '\n' ? ';' : text[i]);
+                break;
+            }
+            case QUIT:
+            case SHUTDOWN:
+                expect_end(arguments);
+                break;
+            default:
+                throw std::invalid_argument("unknown command");
+        }
+    }
+
+    bool QueryServer::execute_lines(std::string &buffer, std::string &out, bool flush_partial) {
+        std::size_t line_begin = 0;
+        bool open = true;
+        while (open) {
+            std::size_t line_end = buffer.find('\n', line_begin);
+            if (line_end == std::string::npos) {
+                if (flush_partial && line_begin < buffer.size()) {
+                    open = execute(buffer.substr(line_begin), out);
+                    line_begin = buffer.size();
+                }
+                break;
+            }
+            open = execute(buffer.substr(line_begin, line_end - line_begin), out);
+            line_begin = line_end + 1;
+        }
+        buffer.erase(0, line_begin);
+        return open;
+    }
+
+    void QueryServer::serve_stream(int in_fd, int out_fd) {
+        DGRAPH_TRACE_SCOPE("serve_stream");
+        std::string pending, out;
+        char chunk[read_buffer_size];
+        bool open = true;
+        while (open) {
+            ssize_t count = read(in_fd, chunk, sizeof(chunk));
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0) {
+                execute_lines(pending, out, true);
+                write_all(out_fd, out);
+                return;
+            }
+            pending.append(chunk, (std::size_t)count);
+            open = execute_lines(pending, out, false);
+            //all the answers to one read leave with one write
+            if (!write_all(out_fd, out))
+                return;
+            out.clear();
+        }
+    }
+
+    void QueryServer::serve_socket(const std::string &path) {
+        DGRAPH_TRACE_SCOPE("serve_socket");
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+            throw std::runtime_error("socket path too long: " + path);
+        std::strcpy(address.sun_path, path.c_str());
+
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0)
+            throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+        unlink(path.c_str());
+        if (bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 64) < 0) {
+            std::string message = std::string("cannot listen on ") + path + ": " + std::strerror(errno);
+            close(listener);
+            throw std::runtime_error(message);
+        }
+
+        //the clients are served one read at a time, in turn, by this thread alone, so the commands
+        //of different clients never run concurrently; pending[i] holds the partial line of client i
+        util::Vector< pollfd > fds;
+        util::Vector< std::string > pending;
+        pollfd listener_fd;
+        listener_fd.fd = listener;
+        listener_fd.events = POLLIN;
+        listener_fd.revents = 0;
+        fds.push_back(listener_fd);
+        pending.push_back(std::string());
+
+        char chunk[read_buffer_size];
+        std::string out;
+        shutdown_ = false;
+        while (!shutdown_) {
+            if (poll(fds.begin(), (nfds_t)fds.size(), -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            if (fds[0].revents & POLLIN) {
+                int client = accept(listener, NULL, NULL);
+                if (client >= 0) {
+                    pollfd client_fd;
+                    client_fd.fd = client;
+                    client_fd.events = POLLIN;
+                    client_fd.revents = 0;
+                    fds.push_back(client_fd);
+                    pending.push_back(std::string());
+                }
+            }
+            for (util::size_t i = 1; i < fds.size() && !shutdown_; ++i) {
+                if (fds[i].revents == 0)
+                    continue;
+                ssize_t count = read(fds[i].fd, chunk, sizeof(chunk));
+                if (count < 0 && errno == EINTR)
+                    continue;
+                bool open = (count > 0);
+                if (open)
+                    pending[i].append(chunk, (std::size_t)count);
+                out.clear();
+                open = execute_lines(pending[i], out, !open) && open;
+                open = write_all(fds[i].fd, out) && open;
+                if (!open) {
+                    //the last client takes the place of the closed one
+                    close(fds[i].fd);
+                    fds[i] = fds.back();
+                    pending[i] = pending.back();
+                    fds.pop_back();
+                    pending.pop_back();
+                    --i;
+                }
+            }
+        }
+
+        for (util::size_t i = 0; i < fds.size(); ++i)
+            close(fds[i].fd);
+        unlink(path.c_str());
+    }
+
+    void QueryServer::write_latency_report(std::ostream &out) const {
+        char line[160];
+        for (int command = 0; command < COMMAND_COUNT; ++command) {
+            const CommandStats& stats = stats_[command];
+            if (stats.calls == 0)
+                continue;
+            std::snprintf(line, sizeof(line), "%s calls %lld errors %lld mean_us %.1f max_us %.1f\n",
+                          command_names[command], stats.calls, stats.errors,
+                          stats.total_us / (double)stats.calls, stats.max_us);
+            out << line;
+        }
+    }
+}
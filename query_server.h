@@ -0,0 +1,79 @@
+#ifndef DIRECTEDGRAPHHANDLER_QUERY_SERVER_H
+#define DIRECTEDGRAPHHANDLER_QUERY_SERVER_H
+
+#include <iostream>
+#include <string>
+#include "util_vector.h"
+#include "directed_graph.h"
+
+namespace dgraph {
+
+    //answers queries about a graph that stays loaded between them
+    //the protocol is line based: every command is one line and gets exactly one line back,
+    //"ok <latency in us> <result>" or "error <latency in us> <message>", in the order the commands
+    //were sent, so a client may pipeline any number of commands without waiting for the answers.
+    //the complete commands received by one read are answered together, by one write
+    //commands:
+    //  bfs S, dfs S            the nodes in the order the search from S visits them
+    //  scc                     the strongly connected components, separated by '|'
+    //  topological_sort        the nodes in topological order
+    //                          (these two stop with an error once they run longer than the time limit)
+    //  reach A B               1 if there is a path from A to B, 0 otherwise
+    //  add_node K A1 B1 ...    adds a node with K edges (given as in add_new_node), answers its id
+    //  remove_edge A B, remove_node A
+    //  stats                   the number of live nodes and of edges
+    //  latency                 the number of calls and the latency of every command so far
+    //  quit                    closes the connection, shutdown also stops the server
+    class QueryServer {
+      public:
+        explicit QueryServer(DirectedGraph& graph);
+        virtual ~QueryServer();
+
+        //method that runs one command and appends its response line to out
+        //returns false if the command ends the connection (quit or shutdown)
+        bool execute(const std::string& command, std::string& out);
+
+        //method that answers the commands read from in_fd on out_fd, until the end of the input
+        //or a quit or shutdown command
+        void serve_stream(int in_fd, int out_fd);
+        //method that listens on a unix domain socket at path and answers the commands of every
+        //client, until one of them sends shutdown; throws std::runtime_error if it cannot listen
+        void serve_socket(const std::string& path);
+
+        //method that bounds the time of the scc and topological_sort commands, which are then run
+        //asynchronously and cancelled once they exceed it; 0, the default, means no limit
+        void set_time_limit(double seconds);
+
+        //method that writes the calls, errors, mean and maximum latency of every command used so far
+        void write_latency_report(std::ostream& out) const;
+      private:
+        QueryServer(const QueryServer& rhs);
+        QueryServer& operator = (const QueryServer& rhs);
+
+        enum Command {
+            BFS, DFS, SCC, TOPOLOGICAL_SORT, REACH, ADD_NODE, REMOVE_EDGE, REMOVE_NODE,
+            STATS, LATENCY, QUIT, SHUTDOWN, UNKNOWN,
+            COMMAND_COUNT
+        };
+
+        struct CommandStats {
+            CommandStats() : calls(0), errors(0), total_us(0), max_us(0) {}
+            long long calls, errors;
+            double total_us, max_us;
+        };
+
+        static Command parse_command(const std::string& name);
+        //runs a parsed command, writing its result to out; throws on invalid arguments
+        void run(Command command, std::istream& arguments, std::ostream& out);
+        //executes every complete line of buffer, removing them from it, and appends the responses
+        //to out; a trailing line without newline is executed too if flush_partial is set
+        bool execute_lines(std::string& buffer, std::string& out, bool flush_partial);
+
+        DirectedGraph& graph_;
+        CommandStats stats_[COMMAND_COUNT];
+        double time_limit_;
+        bool shutdown_;
+    };
+}
+
+#endif //DIRECTEDGRAPHHANDLER_QUERY_SERVER_H
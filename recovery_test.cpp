@@ -0,0 +1,194 @@
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "directed_graph.h"
+#include "graph_journal.h"
+
+//checks the crash recovery of GraphJournal, by damaging its log the way a crash would.
+//exits with a non-zero status if any check fails
+
+using namespace dgraph;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << '\n';
+        failures++;
+    }
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path.data(), std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+static void write_file(const std::string& path, const std::string& contents) {
+    std::ofstream out(path.data(), std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+}
+
+static DirectedGraph initial_graph() {
+    DirectedGraph graph;
+    std::istringstream in("6 7\n0 1\n0 2\n1 3\n2 3\n3 4\n4 5\n2 5\n");
+    in >> graph;
+    return graph;
+}
+
+//adds a node with an edge from every third existing node
+static void add_node(DirectedGraph& graph) {
+    util::Vector< Edge > edges;
+    for (int i = 0; i < graph.node_count(); i += 3)
+        if (!graph.is_node_deleted(i))
+            edges.push_back(Edge(i, graph.node_count()));
+    graph.add_new_node(edges);
+}
+
+//recovers a graph from directory, as a restarted process would
+static DirectedGraph recover(const std::string& directory, std::size_t* replayed = NULL,
+                             std::size_t* truncated = NULL) {
+    DirectedGraph graph;
+    GraphJournal<> journal(graph, directory, 0);
+    if (replayed != NULL)
+        *replayed = journal.replayed_records();
+    if (truncated != NULL)
+        *truncated = journal.truncated_bytes();
+    return graph;
+}
+
+static void test_replay(const std::string& directory) {
+    DirectedGraph graph = initial_graph();
+    {
+        GraphJournal<> journal(graph, directory, 0);
+        add_node(graph);
+        add_node(graph);
+        graph.remove_edge(0, 1);
+        graph.remove_node(4);
+        add_node(graph);
+    }
+    std::size_t replayed = 0, truncated = 0;
+    DirectedGraph recovered = recover(directory, &replayed, &truncated);
+    check(recovered == graph, "replay: the recovered graph differs");
+    check(replayed == 5, "replay: expected 5 replayed records");
+    check(truncated == 0, "replay: an intact log was truncated");
+}
+
+static void test_torn_tail(const std::string& directory) {
+    std::string log_path = directory + "/mutations.log";
+    DirectedGraph graph = initial_graph(), before_last;
+    std::size_t intact_size;
+    {
+        GraphJournal<> journal(graph, directory, 0);
+        add_node(graph);
+        graph.remove_edge(2, 3);
+        before_last = graph;
+        intact_size = read_file(log_path).size();
+        add_node(graph);
+    }
+    std::string log = read_file(log_path);
+
+    //the last record cut short
+    write_file(log_path, log.substr(0, log.size() - 3));
+    std::size_t replayed = 0, truncated = 0;
+    DirectedGraph recovered = recover(directory, &replayed, &truncated);
+    check(recovered == before_last, "torn tail: the recovered graph differs");
+    check(replayed == 2, "torn tail: expected 2 replayed records");
+    check(truncated == log.size() - 3 - intact_size, "torn tail: wrong number of truncated bytes");
+    check(read_file(log_path).size() == intact_size, "torn tail: the log was not truncated");
+
+    //the last record complete but corrupted
+    log[log.size() - 1] ^= 0x5a;
+    write_file(log_path, log);
+    recovered = recover(directory, &replayed, &truncated);
+    check(recovered == before_last, "corrupted tail: the recovered graph differs");
+    check(truncated == log.size() - intact_size, "corrupted tail: wrong number of truncated bytes");
+
+    //the log stays usable after the truncation
+    {
+        DirectedGraph continued;
+        GraphJournal<> journal(continued, directory, 0);
+        add_node(continued);
+        before_last = continued;
+    }
+    check(recover(directory) == before_last, "torn tail: records appended after recovery were lost");
+}
+
+static void test_checkpoint_crash(const std::string& directory) {
+    std::string log_path = directory + "/mutations.log";
+    DirectedGraph graph = initial_graph(), expected;
+    {
+        GraphJournal<> journal(graph, directory, 0);
+        add_node(graph);
+        graph.remove_node(1);
+        add_node(graph);
+        std::string stale_log = read_file(log_path);
+        journal.checkpoint();
+        //a crash between the rename of the checkpoint and the truncation of the log
+        //leaves records that the checkpoint already covers
+        write_file(log_path, stale_log);
+    }
+    std::size_t replayed = 0, truncated = 0;
+    DirectedGraph recovered = recover(directory, &replayed, &truncated);
+    check(recovered == graph, "checkpoint crash: the recovered graph differs");
+    check(replayed == 0, "checkpoint crash: records covered by the checkpoint were replayed");
+    check(truncated == 0, "checkpoint crash: covered records were truncated");
+
+    //new records follow the covered ones, and only they are replayed
+    {
+        GraphJournal<> journal(recovered, directory, 0);
+        recovered.remove_edge(0, 2);
+        add_node(recovered);
+        expected = recovered;
+    }
+    recovered = recover(directory, &replayed, &truncated);
+    check(recovered == expected, "checkpoint crash: records after the covered ones were lost");
+    check(replayed == 2, "checkpoint crash: expected 2 replayed records");
+
+    //the interval checkpoints as the records come in; the records of the earlier sessions are
+    //still in the log, so the first one checkpoints at once, then every second one does
+    {
+        GraphJournal<> journal(recovered, directory, 2);
+        for (int k = 0; k < 4; ++k)
+            add_node(recovered);
+        check(journal.log_records() == 1, "checkpoint interval: the log was not emptied");
+    }
+    check(recover(directory, &replayed) == recovered, "checkpoint interval: the recovered graph differs");
+    check(replayed == 1, "checkpoint interval: expected 1 replayed record");
+}
+
+int main() {
+    char directory_template[] = "recovery_test_XXXXXX";
+    if (mkdtemp(directory_template) == NULL) {
+        std::cerr << "cannot create a temporary directory\n";
+        return 1;
+    }
+    std::string directory = directory_template;
+    const char* cases[] = {"replay", "torn_tail", "checkpoint_crash"};
+    void (*tests[])(const std::string&) = {test_replay, test_torn_tail, test_checkpoint_crash};
+    for (int t = 0; t < 3; ++t) {
+        std::string case_directory = directory + "/" + cases[t];
+        try {
+            tests[t](case_directory);
+        }
+        catch (std::exception& e) {
+            check(false, std::string(cases[t]) + ": " + e.what());
+        }
+        std::remove((case_directory + "/checkpoint").c_str());
+        std::remove((case_directory + "/mutations.log").c_str());
+        rmdir(case_directory.c_str());
+    }
+    rmdir(directory.c_str());
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "all checks passed\n";
+    return 0;
+}
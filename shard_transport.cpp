@@ -0,0 +1,135 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "shard_transport.h"
+
+namespace dgraph {
+
+    namespace {
+        std::runtime_error shard_error(const char* what, int shard) {
+            std::ostringstream message;
+            message << what << " shard " << shard;
+            if (errno != 0)
+                message << ": " << std::strerror(errno);
+            return std::runtime_error(message.str());
+        }
+    }
+
+    //implementation of InProcessTransport's methods
+    InProcessTransport::InProcessTransport(int shard_count) : responses_((util::size_t)shard_count) {
+        for (int shard = 0; shard < shard_count; ++shard)
+            shards_.push_back(new GraphShard());
+    }
+
+    InProcessTransport::~InProcessTransport() {
+        for (util::size_t i = 0; i < shards_.size(); ++i)
+            delete shards_[i];
+    }
+
+    int InProcessTransport::shard_count() const {
+        return (int)shards_.size();
+    }
+
+    void InProcessTransport::send(int shard, const std::string &request) {
+        shards_[shard]->handle(request, responses_[shard]);
+    }
+
+    void InProcessTransport::receive(int shard, std::string &response) {
+        response.swap(responses_[shard]);
+    }
+
+    //implementation of UnixSocketTransport's methods
+    UnixSocketTransport::UnixSocketTransport(int shard_count) {
+        //what is buffered would otherwise be written once more by every child
+        std::fflush(NULL);
+        for (int shard = 0; shard < shard_count; ++shard) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+                std::runtime_error error = shard_error("cannot connect to", shard);
+                close_all();
+                throw error;
+            }
+            pid_t child = fork();
+            if (child < 0) {
+                std::runtime_error error = shard_error("cannot start", shard);
+                close(pair[0]);
+                close(pair[1]);
+                close_all();
+                throw error;
+            }
+            if (child == 0) {
+                //the child keeps only its own socket, so every other shard sees its
+                //coordinator go away when the coordinator does
+                for (util::size_t i = 0; i < fds_.size(); ++i)
+                    close(fds_[i]);
+                close(pair[0]);
+                {
+                    GraphShard graph_shard;
+                    graph_shard.serve(pair[1]);
+                }
+                _exit(0);
+            }
+            close(pair[1]);
+            fds_.push_back(pair[0]);
+            children_.push_back(child);
+        }
+    }
+
+    UnixSocketTransport::UnixSocketTransport(const util::Vector< std::string > &socket_paths) {
+        for (util::size_t shard = 0; shard < socket_paths.size(); ++shard) {
+            sockaddr_un address;
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (socket_paths[shard].size() >= sizeof(address.sun_path)) {
+                close_all();
+                throw std::runtime_error("socket path too long: " + socket_paths[shard]);
+            }
+            std::strcpy(address.sun_path, socket_paths[shard].c_str());
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+                std::runtime_error error = shard_error("cannot connect to", (int)shard);
+                if (fd >= 0)
+                    close(fd);
+                close_all();
+                throw error;
+            }
+            fds_.push_back(fd);
+        }
+    }
+
+    UnixSocketTransport::~UnixSocketTransport() {
+        close_all();
+    }
+
+    void UnixSocketTransport::close_all() {
+        //a forked shard returns from serve once its socket is closed
+        for (util::size_t i = 0; i < fds_.size(); ++i)
+            close(fds_[i]);
+        for (util::size_t i = 0; i < children_.size(); ++i)
+            while (waitpid(children_[i], NULL, 0) < 0 && errno == EINTR) {}
+        fds_ = util::Vector< int >();
+        children_ = util::Vector< pid_t >();
+    }
+
+    int UnixSocketTransport::shard_count() const {
+        return (int)fds_.size();
+    }
+
+    void UnixSocketTransport::send(int shard, const std::string &request) {
+        errno = 0;
+        if (!detail::write_frame(fds_[shard], request))
+            throw shard_error("lost", shard);
+    }
+
+    void UnixSocketTransport::receive(int shard, std::string &response) {
+        errno = 0;
+        if (!detail::read_frame(fds_[shard], response))
+            throw shard_error("lost", shard);
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef DIRECTEDGRAPHHANDLER_SHARD_TRANSPORT_H
+#define DIRECTEDGRAPHHANDLER_SHARD_TRANSPORT_H
+
+#include <string>
+#include <sys/types.h>
+#include "util_vector.h"
+#include "graph_shard.h"
+
+namespace dgraph {
+
+    //carries the requests of a ShardedDirectedGraph to its shards and their responses back
+    //a request may be sent to every shard before any response is received, so the shards
+    //work at the same time; a shard has at most one request outstanding
+    class ShardTransport {
+      public:
+        virtual ~ShardTransport() {}
+
+        virtual int shard_count() const = 0;
+        virtual void send(int shard, const std::string& request) = 0;
+        //waits for the response to the request sent to shard
+        virtual void receive(int shard, std::string& response) = 0;
+    };
+
+    //the shards live in this process and answer as soon as they are sent a request;
+    //for tests and for graphs that fit a single process
+    class InProcessTransport : public ShardTransport {
+      public:
+        explicit InProcessTransport(int shard_count);
+        virtual ~InProcessTransport();
+
+        virtual int shard_count() const;
+        virtual void send(int shard, const std::string& request);
+        virtual void receive(int shard, std::string& response);
+      private:
+        InProcessTransport(const InProcessTransport& rhs);
+        InProcessTransport& operator = (const InProcessTransport& rhs);
+
+        util::Vector< GraphShard* > shards_;
+        util::Vector< std::string > responses_;
+    };
+
+    //the shards run in processes of their own, each holding only its part of the graph,
+    //and are reached over unix domain sockets; the methods throw std::runtime_error when
+    //a shard cannot be reached
+    class UnixSocketTransport : public ShardTransport {
+      public:
+        //forks shard_count processes on this host, each serving a GraphShard over a socket pair;
+        //they exit when the transport is destroyed
+        explicit UnixSocketTransport(int shard_count);
+        //connects to shards that are already listening at the given paths, for instance
+        //started by DirectedGraphHandler --shard PATH
+        explicit UnixSocketTransport(const util::Vector< std::string >& socket_paths);
+        virtual ~UnixSocketTransport();
+
+        virtual int shard_count() const;
+        virtual void send(int shard, const std::string& request);
+        virtual void receive(int shard, std::string& response);
+      private:
+        UnixSocketTransport(const UnixSocketTransport& rhs);
+        UnixSocketTransport& operator = (const UnixSocketTransport& rhs);
+
+        void close_all();
+
+        util::Vector< int > fds_;
+        util::Vector< pid_t > children_;
+    };
+}
+
+#endif //DIRECTEDGRAPHHANDLER_SHARD_TRANSPORT_H
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <stdexcept>
+#include "util_trace.h"
+#include "sharded_directed_graph.h"
+
+namespace dgraph {
+
+    namespace {
+        //edges sent to a shard at once while loading
+        const util::size_t load_batch_size = 1 << 15;
+    }
+
+    //implementation of ShardedDirectedGraph's methods
+    ShardedDirectedGraph::ShardedDirectedGraph(ShardTransport &transport) :
+            transport_(transport), node_count_(0), edge_count_(0),
+            shard_begin_((util::size_t)transport.shard_count() + 1, 0), bytes_exchanged_(0) {
+        if (transport.shard_count() < 1)
+            throw bad_dgraph_config();
+    }
+
+    ShardedDirectedGraph::~ShardedDirectedGraph() {}
+
+    void ShardedDirectedGraph::load(std::istream &in) {
+        DGRAPH_TRACE_SCOPE("sharded/load");
+        int node_count;
+        long long edge_count;
+        if (!(in >> node_count)) throw bad_dgraph_config();
+        if (!(in >> edge_count)) throw bad_dgraph_config();
+        if (node_count < 0 || edge_count < 0) throw bad_dgraph_config();
+
+        int shard_count = transport_.shard_count();
+        node_count_ = edge_count_ = 0;
+        for (int shard = 0; shard <= shard_count; ++shard)
+            shard_begin_[shard] = (int)((long long)shard * node_count / shard_count);
+        util::Vector< std::string > requests((util::size_t)shard_count), responses;
+        for (int shard = 0; shard < shard_count; ++shard) {
+            requests[shard].assign(1, (char)SHARD_LOAD);
+            detail::append_field(requests[shard], node_count);
+            detail::append_field(requests[shard], shard_begin_[shard]);
+            detail::append_field(requests[shard], shard_begin_[shard + 1]);
+        }
+        exchange(requests, responses);
+
+        //a batch is sent as soon as it is full, so the coordinator never holds more than
+        //one batch per shard
+        util::Vector< util::Vector< ShardEntry > > batches((util::size_t)shard_count);
+        for (long long i = 0; i <= edge_count; ++i) {
+            int full = -1;
+            if (i < edge_count) {
+                int from, to;
+                if (!(in >> from)) throw bad_dgraph_config();
+                if (!(in >> to)) throw bad_dgraph_config();
+                if (0 > from || from >= node_count ||
+                        0 > to || to >= node_count)
+                    throw bad_dgraph_config();
+                if (from == to)
+                    throw bad_dgraph_config();
+                full = owner(from);
+                batches[full].push_back(ShardEntry(from, to));
+                if (batches[full].size() < load_batch_size)
+                    continue;
+            }
+            for (int shard = 0; shard < shard_count; ++shard) {
+                requests[shard].clear();
+                if ((full == -1 || full == shard) && !batches[shard].empty()) {
+                    requests[shard].assign(1, (char)SHARD_EDGES);
+                    detail::append_entries(requests[shard], batches[shard]);
+                    //clear would release the batch
+                    while (!batches[shard].empty())
+                        batches[shard].pop_back();
+                }
+            }
+            exchange(requests, responses);
+        }
+
+        for (int shard = 0; shard < shard_count; ++shard)
+            requests[shard].assign(1, (char)SHARD_FINISH);
+        exchange(requests, responses);
+        node_count_ = node_count;
+        edge_count_ = edge_count;
+    }
+
+    int ShardedDirectedGraph::node_count() const { return node_count_; }
+    long long ShardedDirectedGraph::edge_count() const { return edge_count_; }
+    int ShardedDirectedGraph::shard_count() const { return transport_.shard_count(); }
+    unsigned long long ShardedDirectedGraph::bytes_exchanged() const { return bytes_exchanged_; }
+
+    int ShardedDirectedGraph::owner(int id) const {
+        //an empty shard begins where the next one does, and upper_bound skips it
+        return (int)(std::upper_bound(shard_begin_.begin(), shard_begin_.end(), id) - shard_begin_.begin()) - 1;
+    }
+
+    void ShardedDirectedGraph::check_node(int id) const {
+        if (id < 0 || id >= node_count_)
+            throw std::out_of_range("Invalid node id!");
+    }
+
+    void ShardedDirectedGraph::exchange(const util::Vector< std::string > &requests,
+                                        util::Vector< std::string > &responses) const {
+        int shard_count = transport_.shard_count();
+        for (int shard = 0; shard < shard_count; ++shard)
+            if (!requests[shard].empty()) {
+                transport_.send(shard, requests[shard]);
+                bytes_exchanged_ += requests[shard].size();
+            }
+        responses = util::Vector< std::string >((util::size_t)shard_count);
+        for (int shard = 0; shard < shard_count; ++shard)
+            if (!requests[shard].empty()) {
+                transport_.receive(shard, responses[shard]);
+                bytes_exchanged_ += responses[shard].size();
+            }
+
+        //every response is received before any error is thrown, so the shards stay in step
+        for (int shard = 0; shard < shard_count; ++shard) {
+            if (requests[shard].empty())
+                continue;
+            if (responses[shard].empty())
+                throw std::runtime_error("malformed shard message");
+            std::string message = responses[shard].substr(1);
+            switch (responses[shard][0]) {
+                case SHARD_OK:
+                    break;
+                case SHARD_BAD_CONFIG:
+                    throw bad_dgraph_config();
+                case SHARD_OUT_OF_RANGE:
+                    throw std::out_of_range(message);
+                default:
+                    throw std::runtime_error(message);
+            }
+        }
+    }
+
+    void ShardedDirectedGraph::exchange_entries(ShardRequest type, const util::Vector< ShardEntry > &entries,
+                                                util::Vector< std::string > &responses) const {
+        int shard_count = transport_.shard_count();
+        util::Vector< util::Vector< ShardEntry > > parts((util::size_t)shard_count);
+        for (util::size_t i = 0; i < entries.size(); ++i)
+            parts[owner(entries[i].node)].push_back(entries[i]);
+        util::Vector< std::string > requests((util::size_t)shard_count);
+        for (int shard = 0; shard < shard_count; ++shard)
+            if (!parts[shard].empty()) {
+                requests[shard].assign(1, (char)type);
+                detail::append_entries(requests[shard], parts[shard]);
+            }
+        exchange(requests, responses);
+    }
+
+    bool ShardedDirectedGraph::next_level(util::Vector< int > &order, util::size_t level_begin, int target_id) const {
+        util::Vector< ShardEntry > level, candidates, part;
+        level.reserve(order.size() - level_begin);
+        for (util::size_t i = level_begin; i < order.size(); ++i)
+            level.push_back(ShardEntry((int)(i - level_begin), order[i]));
+
+        //the expansion finds every successor with the smallest position of the level that reaches
+        //it; its owner keeps the ones not visited, and the next level is sorted by (position, id),
+        //which is the order in which DirectedGraph would have queued them
+        util::Vector< std::string > responses;
+        exchange_entries(SHARD_EXPAND, level, responses);
+        for (util::size_t shard = 0; shard < responses.size(); ++shard) {
+            if (responses[shard].empty())
+                continue;
+            detail::MessageReader reader(responses[shard], 1);
+            reader.get_entries(part);
+            for (util::size_t i = 0; i < part.size(); ++i)
+                candidates.push_back(part[i]);
+        }
+
+        exchange_entries(SHARD_CLAIM, candidates, responses);
+        util::Vector< ShardEntry > claimed;
+        for (util::size_t shard = 0; shard < responses.size(); ++shard) {
+            if (responses[shard].empty())
+                continue;
+            detail::MessageReader reader(responses[shard], 1);
+            reader.get_entries(part);
+            for (util::size_t i = 0; i < part.size(); ++i)
+                claimed.push_back(part[i]);
+        }
+        std::sort(claimed.begin(), claimed.end());
+
+        bool found = false;
+        for (util::size_t i = 0; i < claimed.size(); ++i) {
+            order.push_back(claimed[i].node);
+            found = found || (claimed[i].node == target_id);
+        }
+        return found;
+    }
+
+    util::Vector< int > ShardedDirectedGraph::breadth_first_search(int source_id) const {
+        DGRAPH_TRACE_SCOPE("sharded/bfs");
+        check_node(source_id);
+        util::Vector< std::string > requests((util::size_t)transport_.shard_count(), std::string(1, (char)SHARD_RESET));
+        util::Vector< std::string > responses;
+        exchange(requests, responses);
+        exchange_entries(SHARD_CLAIM, util::Vector< ShardEntry >(1, ShardEntry(0, source_id)), responses);
+
+        util::Vector< int > order(1, source_id);
+        for (util::size_t level_begin = 0; level_begin < order.size(); ) {
+            util::size_t level_end = order.size();
+            next_level(order, level_begin, -1);
+            level_begin = level_end;
+        }
+        return order;
+    }
+
+    bool ShardedDirectedGraph::has_path(int from_id, int to_id) const {
+        DGRAPH_TRACE_SCOPE("sharded/has_path");
+        check_node(from_id);
+        check_node(to_id);
+        if (from_id == to_id)
+            return true;
+        util::Vector< std::string > requests((util::size_t)transport_.shard_count(), std::string(1, (char)SHARD_RESET));
+        util::Vector< std::string > responses;
+        exchange(requests, responses);
+        exchange_entries(SHARD_CLAIM, util::Vector< ShardEntry >(1, ShardEntry(0, from_id)), responses);
+
+        //the search keeps only the current level
+        util::Vector< int > order(1, from_id);
+        while (!order.empty()) {
+            util::size_t level_end = order.size();
+            if (next_level(order, 0, to_id))
+                return true;
+            util::Vector< int > next;
+            next.reserve(order.size() - level_end);
+            for (util::size_t i = level_end; i < order.size(); ++i)
+                next.push_back(order[i]);
+            order = next;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef DIRECTEDGRAPHHANDLER_SHARDED_DIRECTED_GRAPH_H
+#define DIRECTEDGRAPHHANDLER_SHARDED_DIRECTED_GRAPH_H
+
+#include <iostream>
+#include <string>
+#include "util_vector.h"
+#include "graph_shard.h"
+#include "shard_transport.h"
+
+namespace dgraph {
+
+    //graph partitioned by ranges of node ids across the shards of a transport, which may be
+    //processes that each hold only their own successor lists; this coordinator keeps nothing
+    //but the ranges and the result being built. The traversals are level-synchronous: each
+    //level is sent to the shards that own its nodes, which expand it at the same time, and the
+    //successors they find are sent on to their owners, which claim the ones not visited yet.
+    //a graph runs one traversal at a time, since the shards keep the visited nodes
+    class ShardedDirectedGraph {
+      public:
+        //throws bad_dgraph_config for a transport without shards
+        explicit ShardedDirectedGraph(ShardTransport& transport);
+        virtual ~ShardedDirectedGraph();
+
+        //reads a graph in the text format of DirectedGraph, handing every edge to the owner of
+        //its source in batches; shard k owns the ids [k * N / S, (k + 1) * N / S).
+        //throws bad_dgraph_config for invalid input, as operator>> does
+        void load(std::istream& in);
+
+        int node_count() const;
+        long long edge_count() const;
+        int shard_count() const;
+        //the shard that owns the node
+        int owner(int id) const;
+
+        //returns the nodes in the same order as DirectedGraph::breadth_first_search
+        util::Vector< int > breadth_first_search(int source_id = 0) const;
+        //the same search, which stops at the level that reaches to_id
+        bool has_path(int from_id, int to_id) const;
+
+        //bytes of the requests and responses exchanged with the shards so far
+        unsigned long long bytes_exchanged() const;
+      private:
+        ShardedDirectedGraph(const ShardedDirectedGraph& rhs);
+        ShardedDirectedGraph& operator = (const ShardedDirectedGraph& rhs);
+
+        //sends every non-empty request, then collects their responses, so the shards work at
+        //the same time; throws the error reported by a shard
+        void exchange(const util::Vector< std::string >& requests, util::Vector< std::string >& responses) const;
+        //one request of the given type to every shard, holding the entries that shard owns
+        void exchange_entries(ShardRequest type, const util::Vector< ShardEntry >& entries,
+                              util::Vector< std::string >& responses) const;
+        //expands a level, appending the next one to order, in order; returns true if it holds target_id
+        bool next_level(util::Vector< int >& order, util::size_t level_begin, int target_id) const;
+        void check_node(int id) const;
+
+        ShardTransport& transport_;
+        int node_count_;
+        long long edge_count_;
+        //shard k owns the ids [shard_begin_[k], shard_begin_[k + 1])
+        util::Vector< int > shard_begin_;
+        mutable unsigned long long bytes_exchanged_;
+    };
+}
+
+#endif //DIRECTEDGRAPHHANDLER_SHARDED_DIRECTED_GRAPH_H
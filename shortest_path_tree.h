@@ -0,0 +1,110 @@
+#ifndef DIRECTEDGRAPHHANDLER_SHORTEST_PATH_TREE_H
+#define DIRECTEDGRAPHHANDLER_SHORTEST_PATH_TREE_H
+
+#include <algorithm>
+#include <stdexcept>
+#include "util_vector.h"
+
+namespace dgraph {
+
+    //result of a single-source shortest path computation: the distance from the source
+    //to every node, and the predecessor of every node on one of its shortest paths
+    template<typename IdType, typename WeightType>
+    class ShortestPathTree {
+      public:
+        ShortestPathTree();
+        //a tree where only the source is reachable, at distance 0
+        ShortestPathTree(IdType node_count, IdType source_id);
+        ShortestPathTree(const ShortestPathTree& rhs);
+        ShortestPathTree& operator = (const ShortestPathTree& rhs);
+        virtual ~ShortestPathTree();
+
+        IdType source() const;
+        IdType node_count() const;
+
+        bool is_reachable(IdType id) const;
+        //the distance is only meaningful for reachable nodes
+        const WeightType& distance(IdType id) const;
+        //the node before id on its shortest path; the source is its own predecessor
+        //and unreachable nodes have IdType(-1)
+        IdType predecessor(IdType id) const;
+
+        //returns the ids on a shortest path from the source to id, or an empty Vector
+        //if id is unreachable
+        util::Vector< IdType > path_to(IdType id) const;
+
+        //records a shorter path to id, used by the algorithms that build the tree
+        void update(IdType id, const WeightType& distance, IdType predecessor);
+      private:
+        IdType source_;
+        util::Vector< WeightType > distances_;
+        util::Vector< IdType > predecessors_;
+    };
+
+    template<typename IdType, typename WeightType>
+    ShortestPathTree<IdType, WeightType>::ShortestPathTree() : source_(IdType(-1)) {}
+
+    template<typename IdType, typename WeightType>
+    ShortestPathTree<IdType, WeightType>::ShortestPathTree(IdType node_count, IdType source_id) :
+            source_(source_id),
+            distances_(node_count, WeightType()),
+            predecessors_(node_count, IdType(-1)) {
+        predecessors_[source_id] = source_id;
+    }
+
+    template<typename IdType, typename WeightType>
+    ShortestPathTree<IdType, WeightType>::ShortestPathTree(const ShortestPathTree &rhs) :
+            source_(rhs.source_), distances_(rhs.distances_), predecessors_(rhs.predecessors_) {}
+
+    template<typename IdType, typename WeightType>
+    ShortestPathTree<IdType, WeightType>& ShortestPathTree<IdType, WeightType>::operator=(const ShortestPathTree &rhs) {
+        source_ = rhs.source_;
+        distances_ = rhs.distances_;
+        predecessors_ = rhs.predecessors_;
+        return (*this);
+    }
+
+    template<typename IdType, typename WeightType>
+    ShortestPathTree<IdType, WeightType>::~ShortestPathTree() {}
+
+    template<typename IdType, typename WeightType>
+    IdType ShortestPathTree<IdType, WeightType>::source() const { return source_; }
+
+    template<typename IdType, typename WeightType>
+    IdType ShortestPathTree<IdType, WeightType>::node_count() const { return (IdType)distances_.size(); }
+
+    template<typename IdType, typename WeightType>
+    bool ShortestPathTree<IdType, WeightType>::is_reachable(IdType id) const {
+        return predecessors_[id] != IdType(-1);
+    }
+
+    template<typename IdType, typename WeightType>
+    const WeightType& ShortestPathTree<IdType, WeightType>::distance(IdType id) const {
+        return distances_[id];
+    }
+
+    template<typename IdType, typename WeightType>
+    IdType ShortestPathTree<IdType, WeightType>::predecessor(IdType id) const {
+        return predecessors_[id];
+    }
+
+    template<typename IdType, typename WeightType>
+    util::Vector< IdType > ShortestPathTree<IdType, WeightType>::path_to(IdType id) const {
+        util::Vector< IdType > res;
+        if (!is_reachable(id))
+            return res;
+        for (; id != source_; id = predecessors_[id])
+            res.push_back(id);
+        res.push_back(source_);
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+    template<typename IdType, typename WeightType>
+    void ShortestPathTree<IdType, WeightType>::update(IdType id, const WeightType &distance, IdType predecessor) {
+        distances_[id] = distance;
+        predecessors_[id] = predecessor;
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_SHORTEST_PATH_TREE_H
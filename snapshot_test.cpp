@@ -0,0 +1,111 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "directed_graph.h"
+#include "versioned_graph.h"
+#include "util_epoch.h"
+
+//checks the epoch reclamation behind VersionedGraph: a retired object outlives every reader that
+//could still hold it, and snapshots taken while the writer publishes see complete, unchanging versions.
+//exits with a non-zero status if any check fails
+
+using namespace dgraph;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << '\n';
+        failures++;
+    }
+}
+
+//counts its deletions, so the test sees when the domain reclaims it
+struct Tracked {
+    explicit Tracked(std::atomic< int >& deleted) : deleted(deleted) {}
+    ~Tracked() { deleted++; }
+    std::atomic< int >& deleted;
+};
+
+static void test_reclamation() {
+    std::atomic< int > deleted(0);
+    util::EpochDomain domain(4);
+    //a reader active before the retirement may still hold the object
+    util::size_t early_reader = domain.enter();
+    domain.retire(new Tracked(deleted));
+    check(domain.reclaim() == 1 && deleted.load() == 0, "reclamation: an object was deleted under a reader");
+    //a reader that starts afterwards cannot reach it, so it does not hold it back
+    util::size_t late_reader = domain.enter();
+    domain.exit(early_reader);
+    check(domain.reclaim() == 0 && deleted.load() == 1, "reclamation: the object outlived its readers");
+    domain.exit(late_reader);
+
+    //the domain deletes what is still retired when it is destroyed
+    {
+        util::EpochDomain short_lived(4);
+        short_lived.retire(new Tracked(deleted));
+        short_lived.retire(new Tracked(deleted));
+        check(short_lived.pending_count() == 2, "reclamation: wrong number of pending objects");
+    }
+    check(deleted.load() == 3, "reclamation: the destroyed domain leaked its objects");
+}
+
+static void test_concurrent_snapshots() {
+    const int reader_count = 4, publish_count = 300;
+    DirectedGraph initial;
+    std::istringstream in("6 7\n0 1\n0 2\n1 3\n2 3\n3 4\n4 5\n2 5\n");
+    in >> initial;
+    int initial_nodes = initial.node_count();
+    VersionedGraph<> versioned(initial, 8);
+    std::atomic< bool > finished(false);
+    std::atomic< int > reader_failures(0);
+
+    std::thread readers[reader_count];
+    for (int r = 0; r < reader_count; ++r)
+        readers[r] = std::thread([&]() {
+            unsigned long long last_version = 0;
+            while (!finished.load()) {
+                VersionedGraph<>::Snapshot snapshot = versioned.snapshot();
+                //every version adds one node, and nothing changes a version once it is published
+                unsigned long long version = snapshot.version();
+                int node_count = snapshot->node_count();
+                if (version < last_version || (unsigned long long)node_count != initial_nodes + version ||
+                        snapshot->breadth_first_search(0).size() != (util::size_t)node_count)
+                    reader_failures++;
+                if (snapshot->node_count() != node_count || snapshot.version() != version)
+                    reader_failures++;
+                last_version = version;
+            }
+        });
+
+    for (int k = 0; k < publish_count; ++k) {
+        //every new node is reachable from node 0, which the readers check with a bfs
+        util::Vector< Edge > edges;
+        edges.push_back(Edge(0, versioned.writer().node_count()));
+        versioned.writer().add_new_node(edges);
+        versioned.publish();
+    }
+    finished.store(true);
+    for (int r = 0; r < reader_count; ++r)
+        readers[r].join();
+
+    check(reader_failures.load() == 0, "snapshots: a reader saw a version change or a wrong version");
+    check(versioned.version() == (unsigned long long)publish_count, "snapshots: wrong final version");
+    check(versioned.snapshot()->node_count() == initial_nodes + publish_count, "snapshots: wrong final graph");
+    versioned.publish();
+    check(versioned.pending_versions() == 0, "snapshots: replaced versions were not reclaimed");
+}
+
+int main() {
+    test_reclamation();
+    test_concurrent_snapshots();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include "util_binary_io.h"
+
+namespace util {
+
+    namespace {
+        //the table of the reflected polynomial 0xEDB88320, one entry per byte value
+        struct Crc32Table {
+            Crc32Table() {
+                for (unsigned int i = 0; i < 256; ++i) {
+                    unsigned int value = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                        value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : (value >> 1);
+                    entries[i] = value;
+                }
+            }
+            unsigned int entries[256];
+        };
+
+        const Crc32Table crc32_table;
+    }
+
+    unsigned int crc32(const void *data, std::size_t size, unsigned int crc) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        crc = ~crc;
+        for (std::size_t i = 0; i < size; ++i)
+            crc = crc32_table.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    //implementation of BinaryWriter's methods
+    BinaryWriter::BinaryWriter() : out_(NULL), checksum_(0) {}
+
+    BinaryWriter::BinaryWriter(std::ostream &out) : out_(&out), checksum_(0) {
+        buffer_.reserve(block_size);
+    }
+
+    BinaryWriter::~BinaryWriter() {
+        flush();
+    }
+
+    void BinaryWriter::put_bytes(const void *data, std::size_t size) {
+        checksum_ = crc32(data, size, checksum_);
+        buffer_.append(static_cast<const char*>(data), size);
+        if (out_ != NULL && buffer_.size() >= block_size)
+            flush();
+    }
+
+    void BinaryWriter::flush() {
+        if (out_ == NULL || buffer_.empty())
+            return;
+        out_->write(buffer_.data(), (std::streamsize)buffer_.size());
+        buffer_.clear();
+    }
+
+    unsigned int BinaryWriter::checksum() const {
+        return checksum_;
+    }
+
+    const std::string& BinaryWriter::buffer() const {
+        return buffer_;
+    }
+
+    //implementation of BinaryReader's methods
+    BinaryReader::BinaryReader(std::istream &in) : in_(&in), position_(NULL), end_(NULL), checksum_(0) {}
+
+    BinaryReader::BinaryReader(const char *data, std::size_t size) :
+            in_(NULL), position_(data), end_(data + size), checksum_(0) {}
+
+    BinaryReader::~BinaryReader() {}
+
+    bool BinaryReader::get_bytes(void *data, std::size_t size) {
+        char* destination = static_cast<char*>(data);
+        while (size > 0) {
+            if (position_ == end_ && !refill())
+                return false;
+            std::size_t count = std::min(size, (std::size_t)(end_ - position_));
+            std::memcpy(destination, position_, count);
+            checksum_ = crc32(position_, count, checksum_);
+            position_ += count;
+            destination += count;
+            size -= count;
+        }
+        return true;
+    }
+
+    unsigned int BinaryReader::checksum() const {
+        return checksum_;
+    }
+
+    bool BinaryReader::refill() {
+        if (in_ == NULL)
+            return false;
+        buffer_.resize(block_size);
+        in_->read(&buffer_[0], (std::streamsize)block_size);
+        std::size_t count = (std::size_t)in_->gcount();
+        position_ = buffer_.data();
+        end_ = position_ + count;
+        return count > 0;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_BINARY_IO_H
+#define DIRECTEDGRAPHHANDLER_UTIL_BINARY_IO_H
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace util {
+
+    //returns the CRC-32 (the one of zlib and PNG) of data, continuing from the crc of the bytes before it
+    unsigned int crc32(const void* data, std::size_t size, unsigned int crc = 0);
+
+    //writes values in their native representation, keeping the CRC-32 of everything written
+    //the bytes are gathered in a buffer, which is handed to the stream in large blocks;
+    //without a stream the buffer simply grows and can be taken with buffer()
+    class BinaryWriter {
+      public:
+        BinaryWriter();
+        explicit BinaryWriter(std::ostream& out);
+        //flushes what is left in the buffer
+        virtual ~BinaryWriter();
+
+        template<typename T>
+        void put(const T& value);
+        void put_bytes(const void* data, std::size_t size);
+
+        //method that hands the buffered bytes to the stream
+        void flush();
+
+        //CRC-32 of every byte written so far
+        unsigned int checksum() const;
+        const std::string& buffer() const;
+      private:
+        BinaryWriter(const BinaryWriter& rhs);
+        BinaryWriter& operator = (const BinaryWriter& rhs);
+
+        static const std::size_t block_size = 1 << 16;
+
+        std::ostream* out_;
+        std::string buffer_;
+        unsigned int checksum_;
+    };
+
+    //reads values written by a BinaryWriter, from a stream or from memory, keeping the CRC-32
+    //of everything read; every method returns false once the input ends before the value does
+    class BinaryReader {
+      public:
+        explicit BinaryReader(std::istream& in);
+        BinaryReader(const char* data, std::size_t size);
+        virtual ~BinaryReader();
+
+        template<typename T>
+        bool get(T& value);
+        bool get_bytes(void* data, std::size_t size);
+
+        //CRC-32 of every byte read so far
+        unsigned int checksum() const;
+      private:
+        BinaryReader(const BinaryReader& rhs);
+        BinaryReader& operator = (const BinaryReader& rhs);
+
+        static const std::size_t block_size = 1 << 16;
+
+        //refills the buffer from the stream; returns false at the end of the input
+        bool refill();
+
+        std::istream* in_;
+        std::string buffer_;
+        const char* position_;
+        const char* end_;
+        unsigned int checksum_;
+    };
+
+    //implementation of BinaryWriter's template methods
+    template<typename T>
+    void BinaryWriter::put(const T &value) {
+        put_bytes(&value, sizeof(T));
+    }
+
+    //implementation of BinaryReader's template methods
+    template<typename T>
+    bool BinaryReader::get(T &value) {
+        //the common case of a value that lies within the buffer avoids the general path
+        if ((std::size_t)(end_ - position_) >= sizeof(T)) {
+            std::memcpy(&value, position_, sizeof(T));
+            checksum_ = crc32(position_, sizeof(T), checksum_);
+            position_ += sizeof(T);
+            return true;
+        }
+        return get_bytes(&value, sizeof(T));
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_BINARY_IO_H
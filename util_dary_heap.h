@@ -0,0 +1,141 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_DARY_HEAP_H
+#define DIRECTEDGRAPHHANDLER_UTIL_DARY_HEAP_H
+
+#include <utility>
+#include "util_vector.h"
+
+namespace util {
+
+    //implementation of a min-heap of (key, value) pairs stored as an implicit Arity-ary tree
+    //a larger arity makes the tree shallower, so push is cheaper and the children compared
+    //by pop are adjacent in memory; 4 is a good default for Dijkstra-like workloads
+    template<typename Key, typename T, int Arity = 4,
+             typename Alloc = Allocator< std::pair<Key, T> > >
+    class DaryHeap {
+      public:
+        typedef std::pair<Key, T> value_type;
+
+        //constructors
+        DaryHeap();
+        explicit DaryHeap(const Alloc& allocator);
+        DaryHeap(const DaryHeap& rhs);
+
+        //assignment operator
+        DaryHeap& operator = (const DaryHeap& rhs);
+
+        //destructor
+        virtual ~DaryHeap();
+
+        //method that returns the number of elements in the heap
+        size_t size() const;
+
+        //method that returns true if the heap is empty
+        bool empty() const;
+
+        //method that returns the element with the smallest key
+        const value_type& top() const;
+
+        //method to insert a value with the given key
+        void push(const Key& key, const T& value);
+
+        //method to erase the element with the smallest key
+        void pop();
+
+        //method that erases all elements from the heap
+        void clear();
+      private:
+        Vector<value_type, Alloc> data_;
+
+        void sift_up(size_t index);
+        void sift_down(size_t index);
+    };
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    DaryHeap<Key, T, Arity, Alloc>::DaryHeap() {}
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    DaryHeap<Key, T, Arity, Alloc>::DaryHeap(const Alloc& allocator) : data_(allocator) {}
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    DaryHeap<Key, T, Arity, Alloc>::DaryHeap(const DaryHeap &rhs) : data_(rhs.data_) {}
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    DaryHeap<Key, T, Arity, Alloc>& DaryHeap<Key, T, Arity, Alloc>::operator=(const DaryHeap &rhs) {
+        data_ = rhs.data_;
+        return (*this);
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    DaryHeap<Key, T, Arity, Alloc>::~DaryHeap() {}
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    size_t DaryHeap<Key, T, Arity, Alloc>::size() const {
+        return data_.size();
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    bool DaryHeap<Key, T, Arity, Alloc>::empty() const {
+        return data_.empty();
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    const typename DaryHeap<Key, T, Arity, Alloc>::value_type& DaryHeap<Key, T, Arity, Alloc>::top() const {
+        return data_.front();
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    void DaryHeap<Key, T, Arity, Alloc>::push(const Key &key, const T &value) {
+        data_.push_back(value_type(key, value));
+        sift_up(data_.size() - 1);
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    void DaryHeap<Key, T, Arity, Alloc>::pop() {
+        data_.front() = data_.back();
+        data_.pop_back();
+        if (!data_.empty())
+            sift_down(0);
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    void DaryHeap<Key, T, Arity, Alloc>::clear() {
+        data_.clear();
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    void DaryHeap<Key, T, Arity, Alloc>::sift_up(size_t index) {
+        //the element is held aside and the parents are moved down into the hole
+        value_type value = data_[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!(value.first < data_[parent].first))
+                break;
+            data_[index] = data_[parent];
+            index = parent;
+        }
+        data_[index] = value;
+    }
+
+    template<typename Key, typename T, int Arity, typename Alloc>
+    void DaryHeap<Key, T, Arity, Alloc>::sift_down(size_t index) {
+        value_type value = data_[index];
+        size_t size = data_.size();
+        while (true) {
+            size_t first_child = index * Arity + 1;
+            if (first_child >= size)
+                break;
+            size_t last_child = std::min(first_child + Arity, size);
+            size_t smallest = first_child;
+            for (size_t child = first_child + 1; child < last_child; ++child)
+                if (data_[child].first < data_[smallest].first)
+                    smallest = child;
+            if (!(data_[smallest].first < value.first))
+                break;
+            data_[index] = data_[smallest];
+            index = smallest;
+        }
+        data_[index] = value;
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_DARY_HEAP_H
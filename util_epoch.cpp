@@ -0,0 +1,80 @@
+#include <functional>
+#include <thread>
+#include "util_epoch.h"
+
+namespace util {
+
+    //implementation of EpochDomain's methods
+    EpochDomain::EpochDomain(size_t slot_count) :
+            global_epoch_(1), slots_(new Slot[slot_count == 0 ? 1 : slot_count]),
+            slot_count_(slot_count == 0 ? 1 : slot_count) {}
+
+    EpochDomain::~EpochDomain() {
+        for (size_t i = 0; i < retired_.size(); ++i)
+            retired_[i].deleter(retired_[i].object);
+        delete[] slots_;
+    }
+
+    size_t EpochDomain::enter() {
+        //the scan starts at a slot picked by the thread id, so concurrent readers
+        //usually claim different slots at the first attempt
+        size_t start = std::hash< std::thread::id >()(std::this_thread::get_id()) % slot_count_;
+        for (;;) {
+            for (size_t i = 0; i < slot_count_; ++i) {
+                size_t slot = (start + i) % slot_count_;
+                if (slots_[slot].epoch.load(std::memory_order_relaxed) != 0)
+                    continue;
+                //the epoch is read before the slot is claimed, so the announced epoch can only be
+                //older than the current one, which merely delays a reclamation
+                unsigned long long free_epoch = 0;
+                if (slots_[slot].epoch.compare_exchange_strong(free_epoch, global_epoch_.load()))
+                    return slot;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void EpochDomain::exit(size_t slot) {
+        slots_[slot].epoch.store(0, std::memory_order_release);
+    }
+
+    void EpochDomain::retire(const void *object, void (*deleter)(const void *)) {
+        //the object was unlinked before this point, so only readers that announced
+        //an epoch up to the current one can still hold it
+        retired_.push_back(Retired(object, deleter, global_epoch_.fetch_add(1)));
+    }
+
+    size_t EpochDomain::reclaim() {
+        unsigned long long oldest_epoch = global_epoch_.load();
+        for (size_t i = 0; i < slot_count_; ++i) {
+            unsigned long long epoch = slots_[i].epoch.load();
+            if (epoch != 0 && epoch < oldest_epoch)
+                oldest_epoch = epoch;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < retired_.size(); ++i)
+            if (retired_[i].epoch < oldest_epoch)
+                retired_[i].deleter(retired_[i].object);
+            else
+                retired_[kept++] = retired_[i];
+        while (retired_.size() > kept)
+            retired_.pop_back();
+        return kept;
+    }
+
+    size_t EpochDomain::pending_count() const {
+        return retired_.size();
+    }
+
+    size_t EpochDomain::slot_count() const {
+        return slot_count_;
+    }
+
+    //implementation of EpochGuard's methods
+    EpochGuard::EpochGuard(EpochDomain &domain) : domain_(domain), slot_(domain.enter()) {}
+
+    EpochGuard::~EpochGuard() {
+        domain_.exit(slot_);
+    }
+}
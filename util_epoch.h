@@ -0,0 +1,90 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_EPOCH_H
+#define DIRECTEDGRAPHHANDLER_UTIL_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include "util_vector.h"
+
+namespace util {
+
+    //epoch-based reclamation of objects that readers may still be using after they were unlinked
+    //a reader announces the current epoch in one of a fixed number of slots while it holds
+    //a pointer, and clears the slot afterwards; an object retired during epoch E is deleted
+    //once every announced epoch is larger than E, i.e. once no reader that could have seen it
+    //is still active. Readers never wait for the writer, they only contend with other readers
+    //when more than slot_count() of them are active at once.
+    //enter and exit may be called from any thread; retire and reclaim from a single writer thread
+    class EpochDomain {
+      public:
+        explicit EpochDomain(size_t slot_count = 128);
+        //deletes every object that is still retired; no reader may be active anymore
+        virtual ~EpochDomain();
+
+        //method that claims a slot and announces the current epoch in it; returns the slot
+        size_t enter();
+        //method that releases a slot returned by enter
+        void exit(size_t slot);
+
+        //method that hands over an object that readers can no longer reach, but may still hold
+        template<typename T>
+        void retire(const T* object);
+
+        //method that deletes the retired objects no active reader can hold; returns how many remain
+        size_t reclaim();
+
+        //method that returns the number of retired objects that were not deleted yet
+        size_t pending_count() const;
+
+        size_t slot_count() const;
+      private:
+        EpochDomain(const EpochDomain& rhs);
+        EpochDomain& operator = (const EpochDomain& rhs);
+
+        //each slot is padded to the size of a cache line, so readers on different cores
+        //do not keep invalidating each other's slots
+        struct Slot {
+            Slot() : epoch(0) {}
+            std::atomic< unsigned long long > epoch; //0 while the slot is free
+            char padding[64 - sizeof(std::atomic< unsigned long long >)];
+        };
+
+        struct Retired {
+            Retired() : object(NULL), deleter(NULL), epoch(0) {}
+            Retired(const void* object, void (*deleter)(const void*), unsigned long long epoch) :
+                    object(object), deleter(deleter), epoch(epoch) {}
+            const void* object;
+            void (*deleter)(const void*);
+            unsigned long long epoch;
+        };
+
+        template<typename T>
+        static void delete_object(const void* object) { delete static_cast<const T*>(object); }
+
+        void retire(const void* object, void (*deleter)(const void*));
+
+        std::atomic< unsigned long long > global_epoch_;
+        Slot* slots_;
+        size_t slot_count_;
+        Vector< Retired > retired_;
+    };
+
+    template<typename T>
+    void EpochDomain::retire(const T *object) {
+        retire(static_cast<const void*>(object), &EpochDomain::delete_object<T>);
+    }
+
+    //announces an epoch of a domain for the lifetime of the object
+    class EpochGuard {
+      public:
+        explicit EpochGuard(EpochDomain& domain);
+        virtual ~EpochGuard();
+      private:
+        EpochGuard(const EpochGuard& rhs);
+        EpochGuard& operator = (const EpochGuard& rhs);
+
+        EpochDomain& domain_;
+        size_t slot_;
+    };
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_EPOCH_H
@@ -0,0 +1,160 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_HASH_SET_H
+#define DIRECTEDGRAPHHANDLER_UTIL_HASH_SET_H
+
+#include <cstddef>
+#include <utility>
+#include "util_vector.h"
+
+namespace util {
+
+    //hash functor for integer keys: the splitmix64 finalizer, so that
+    //consecutive keys are spread over the whole table
+    template<typename T>
+    struct Hash {
+        std::size_t operator () (const T& value) const {
+            unsigned long long x = (unsigned long long)value;
+            x ^= x >> 30;
+            x *= 0xBF58476D1CE4E5B9ULL;
+            x ^= x >> 27;
+            x *= 0x94D049BB133111EBULL;
+            x ^= x >> 31;
+            return (std::size_t)x;
+        }
+    };
+
+    template<typename First, typename Second>
+    struct Hash< std::pair<First, Second> > {
+        std::size_t operator () (const std::pair<First, Second>& value) const {
+            std::size_t seed = Hash<First>()(value.first);
+            return Hash<std::size_t>()(seed ^ (Hash<Second>()(value.second) + 0x9E3779B9 + (seed << 6)));
+        }
+    };
+
+    //implementation of a hash set with open addressing and linear probing
+    //the table size is a power of two and stays at most half full;
+    //elements cannot be erased one by one, only all at once through clear()
+    template<typename Key, typename HashFunction = Hash<Key>, typename Alloc = Allocator<Key> >
+    class HashSet {
+      public:
+        //constructors
+        HashSet();
+        HashSet(const HashSet& rhs);
+
+        //assignment operator
+        HashSet& operator = (const HashSet& rhs);
+
+        //destructor
+        virtual ~HashSet();
+
+        //method that returns the number of elements in the set
+        size_t size() const;
+
+        //method that returns true if the set is empty
+        bool empty() const;
+
+        //method that returns true if key is in the set
+        bool contains(const Key& key) const;
+
+        //method that inserts key; returns false if it was already in the set
+        bool insert(const Key& key);
+
+        //method that erases all elements from the set
+        void clear();
+
+        //method that returns the number of bytes held by the table
+        std::size_t memory_bytes() const;
+      private:
+        Vector<Key, Alloc> keys_;
+        Vector<bool> used_;
+        size_t size_;
+
+        //returns the slot that holds key, or the empty slot where it would be inserted
+        size_t find_slot(const Key& key) const;
+        void rehash(size_t slot_count);
+    };
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    HashSet<Key, HashFunction, Alloc>::HashSet() : size_(0) {}
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    HashSet<Key, HashFunction, Alloc>::HashSet(const HashSet &rhs) :
+            keys_(rhs.keys_), used_(rhs.used_), size_(rhs.size_) {}
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    HashSet<Key, HashFunction, Alloc>& HashSet<Key, HashFunction, Alloc>::operator=(const HashSet &rhs) {
+        keys_ = rhs.keys_;
+        used_ = rhs.used_;
+        size_ = rhs.size_;
+        return (*this);
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    HashSet<Key, HashFunction, Alloc>::~HashSet() {}
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    size_t HashSet<Key, HashFunction, Alloc>::size() const {
+        return size_;
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    bool HashSet<Key, HashFunction, Alloc>::empty() const {
+        return size_ == 0;
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    bool HashSet<Key, HashFunction, Alloc>::contains(const Key &key) const {
+        if (size_ == 0)
+            return false;
+        return used_[find_slot(key)];
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    bool HashSet<Key, HashFunction, Alloc>::insert(const Key &key) {
+        if (2 * (size_ + 1) > keys_.size())
+            rehash(keys_.empty() ? 16 : 2 * keys_.size());
+        size_t slot = find_slot(key);
+        if (used_[slot])
+            return false;
+        keys_[slot] = key;
+        used_[slot] = true;
+        size_++;
+        return true;
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    void HashSet<Key, HashFunction, Alloc>::clear() {
+        keys_.clear();
+        used_.clear();
+        size_ = 0;
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    std::size_t HashSet<Key, HashFunction, Alloc>::memory_bytes() const {
+        return keys_.capacity() * sizeof(Key) + used_.capacity() * sizeof(bool);
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    size_t HashSet<Key, HashFunction, Alloc>::find_slot(const Key &key) const {
+        size_t mask = keys_.size() - 1;
+        size_t slot = (size_t)HashFunction()(key) & mask;
+        while (used_[slot] && !(keys_[slot] == key))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    template<typename Key, typename HashFunction, typename Alloc>
+    void HashSet<Key, HashFunction, Alloc>::rehash(size_t slot_count) {
+        Vector<Key, Alloc> old_keys(keys_);
+        Vector<bool> old_used(used_);
+        keys_ = Vector<Key, Alloc>(slot_count, Key(), keys_.get_allocator());
+        used_ = Vector<bool>(slot_count, false);
+        for (size_t i = 0; i < old_keys.size(); ++i)
+            if (old_used[i]) {
+                size_t slot = find_slot(old_keys[i]);
+                keys_[slot] = old_keys[i];
+                used_[slot] = true;
+            }
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_HASH_SET_H
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include "util_memory.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace util {
+
+    namespace {
+        //read by every allocator that is created, on any thread, so it is atomic; the release store
+        //publishes the resource's construction to the threads that acquire it
+        std::atomic< MemoryResource* > default_resource_(NULL);
+
+        //never destroyed, because containers with static storage duration
+        //may still release their memory after every other static object is gone
+        MemoryResource* new_delete_resource() {
+            static NewDeleteResource* resource = new NewDeleteResource();
+            return resource;
+        }
+    }
+
+    //implementation of NewDeleteResource's methods
+    void* NewDeleteResource::allocate(std::size_t bytes) {
+        return ::operator new(bytes);
+    }
+
+    void NewDeleteResource::deallocate(void *pointer, std::size_t) {
+        ::operator delete(pointer);
+    }
+
+    MemoryResource* get_default_resource() {
+        MemoryResource* resource = default_resource_.load(std::memory_order_acquire);
+        return (resource == NULL ? new_delete_resource() : resource);
+    }
+
+    MemoryResource* set_default_resource(MemoryResource *resource) {
+        MemoryResource* previous = default_resource_.exchange(resource, std::memory_order_acq_rel);
+        return (previous == NULL ? new_delete_resource() : previous);
+    }
+
+    //implementation of ScopedDefaultResource's methods
+    ScopedDefaultResource::ScopedDefaultResource(MemoryResource *resource) :
+            previous_(set_default_resource(resource)) {}
+
+    ScopedDefaultResource::~ScopedDefaultResource() {
+        set_default_resource(previous_);
+    }
+
+    //implementation of TrackingResource's methods
+    TrackingResource::TrackingResource(MemoryResource *upstream) :
+            upstream_(upstream == NULL ? get_default_resource() : upstream),
+            current_bytes_(0), peak_bytes_(0), allocation_count_(0) {}
+
+    TrackingResource::~TrackingResource() {}
+
+    void* TrackingResource::allocate(std::size_t bytes) {
+        void* pointer = upstream_->allocate(bytes);
+        raise_peak(current_bytes_.fetch_add(bytes) + bytes);
+        allocation_count_.fetch_add(1);
+        return pointer;
+    }
+
+    void TrackingResource::deallocate(void *pointer, std::size_t bytes) {
+        upstream_->deallocate(pointer, bytes);
+        current_bytes_.fetch_sub(bytes);
+    }
+
+    std::size_t TrackingResource::current_bytes() const { return current_bytes_; }
+    std::size_t TrackingResource::peak_bytes() const { return peak_bytes_; }
+    std::size_t TrackingResource::allocation_count() const { return allocation_count_; }
+
+    void TrackingResource::reset_peak() {
+        peak_bytes_.store(current_bytes_.load());
+    }
+
+    void TrackingResource::raise_peak(std::size_t bytes) {
+        std::size_t peak = peak_bytes_.load();
+        while (peak < bytes && !peak_bytes_.compare_exchange_weak(peak, bytes)) {}
+    }
+
+    //implementation of PeakUsageScope's methods
+    PeakUsageScope::PeakUsageScope(TrackingResource &tracker) :
+            tracker_(tracker),
+            baseline_bytes_(tracker.current_bytes()),
+            outer_peak_bytes_(tracker.peak_bytes()) {
+        tracker_.reset_peak();
+    }
+
+    PeakUsageScope::~PeakUsageScope() {
+        //scopes may be nested, so the enclosing scope must still see its own peak
+        tracker_.raise_peak(outer_peak_bytes_);
+    }
+
+    std::size_t PeakUsageScope::peak_bytes() const {
+        std::size_t peak = tracker_.peak_bytes();
+        return (peak > baseline_bytes_ ? peak - baseline_bytes_ : 0);
+    }
+
+    //implementation of HugePageResource's methods
+    HugePageResource::HugePageResource(std::size_t threshold, MemoryResource *upstream) :
+            threshold_(threshold), upstream_(upstream == NULL ? get_default_resource() : upstream) {}
+
+    HugePageResource::~HugePageResource() {}
+
+    void* HugePageResource::allocate(std::size_t bytes) {
+#ifdef __linux__
+        if (bytes >= threshold_) {
+            void* pointer = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (pointer == MAP_FAILED)
+                throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+            madvise(pointer, bytes, MADV_HUGEPAGE);
+#endif
+            return pointer;
+        }
+#endif
+        return upstream_->allocate(bytes);
+    }
+
+    void HugePageResource::deallocate(void *pointer, std::size_t bytes) {
+#ifdef __linux__
+        if (bytes >= threshold_) {
+            munmap(pointer, bytes);
+            return;
+        }
+#endif
+        upstream_->deallocate(pointer, bytes);
+    }
+}
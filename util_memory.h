@@ -0,0 +1,148 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_MEMORY_H
+#define DIRECTEDGRAPHHANDLER_UTIL_MEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <iostream>
+
+namespace util {
+
+    //source of raw memory for the util containers
+    //a container remembers the resource it was created with, so the default
+    //resource may be changed at any time without freeing memory into the wrong one
+    class MemoryResource {
+      public:
+        virtual ~MemoryResource() {}
+        virtual void* allocate(std::size_t bytes) = 0;
+        virtual void deallocate(void* pointer, std::size_t bytes) = 0;
+    };
+
+    //forwards to the global operator new and operator delete
+    class NewDeleteResource : public MemoryResource {
+      public:
+        virtual void* allocate(std::size_t bytes);
+        virtual void deallocate(void* pointer, std::size_t bytes);
+    };
+
+    //the resource used by containers that were not given one explicitly
+    //both functions are thread-safe, but the default is shared by every thread: containers created
+    //by the workers of a parallel algorithm while it is replaced may take either resource
+    MemoryResource* get_default_resource();
+    //replaces the default resource and returns the previous one; NULL restores new/delete
+    MemoryResource* set_default_resource(MemoryResource* resource);
+
+    //installs a default resource for the lifetime of the object
+    class ScopedDefaultResource {
+      public:
+        explicit ScopedDefaultResource(MemoryResource* resource);
+        virtual ~ScopedDefaultResource();
+      private:
+        ScopedDefaultResource(const ScopedDefaultResource& rhs);
+        ScopedDefaultResource& operator = (const ScopedDefaultResource& rhs);
+
+        MemoryResource* previous_;
+    };
+
+    //counts the bytes that go through it before forwarding them to an upstream resource
+    //the counters are atomic, so it may be shared by the workers of a parallel algorithm
+    class TrackingResource : public MemoryResource {
+      public:
+        explicit TrackingResource(MemoryResource* upstream = NULL);
+        virtual ~TrackingResource();
+
+        virtual void* allocate(std::size_t bytes);
+        virtual void deallocate(void* pointer, std::size_t bytes);
+
+        std::size_t current_bytes() const;
+        std::size_t peak_bytes() const;
+        std::size_t allocation_count() const;
+        //makes the peak equal to the current usage, so a new peak can be measured
+        void reset_peak();
+      private:
+        TrackingResource(const TrackingResource& rhs);
+        TrackingResource& operator = (const TrackingResource& rhs);
+
+        friend class PeakUsageScope;
+
+        MemoryResource* upstream_;
+        std::atomic< std::size_t > current_bytes_, peak_bytes_, allocation_count_;
+
+        //raises peak_bytes_ to at least bytes
+        void raise_peak(std::size_t bytes);
+    };
+
+    //measures how many bytes above the usage at construction a tracking resource reached
+    //during the lifetime of the object, e.g. the temporaries of one graph operation.
+    //it counts the allocations of every thread that uses the resource meanwhile, not only those
+    //of the thread that created it
+    class PeakUsageScope {
+      public:
+        explicit PeakUsageScope(TrackingResource& tracker);
+        virtual ~PeakUsageScope();
+
+        //peak temporary usage so far
+        std::size_t peak_bytes() const;
+      private:
+        PeakUsageScope(const PeakUsageScope& rhs);
+        PeakUsageScope& operator = (const PeakUsageScope& rhs);
+
+        TrackingResource& tracker_;
+        std::size_t baseline_bytes_, outer_peak_bytes_;
+    };
+
+    //serves blocks of at least threshold bytes from anonymous mappings advised for
+    //transparent huge pages (Linux only); smaller blocks go to the upstream resource
+    class HugePageResource : public MemoryResource {
+      public:
+        explicit HugePageResource(std::size_t threshold = (std::size_t)1 << 21,
+                                  MemoryResource* upstream = NULL);
+        virtual ~HugePageResource();
+
+        virtual void* allocate(std::size_t bytes);
+        virtual void deallocate(void* pointer, std::size_t bytes);
+      private:
+        HugePageResource(const HugePageResource& rhs);
+        HugePageResource& operator = (const HugePageResource& rhs);
+
+        std::size_t threshold_;
+        MemoryResource* upstream_;
+    };
+
+    //allocator used by the util containers; it takes its memory from a MemoryResource,
+    //by default the one returned by get_default_resource() when the allocator is created
+    template<typename T>
+    class Allocator {
+      public:
+        Allocator() : resource_(get_default_resource()) {}
+        explicit Allocator(MemoryResource* resource) : resource_(resource) {}
+        Allocator(const Allocator& rhs) : resource_(rhs.resource_) {}
+        Allocator& operator = (const Allocator& rhs) {
+            resource_ = rhs.resource_;
+            return (*this);
+        }
+        ~Allocator() {}
+
+        T* allocate(std::size_t count) {
+            return static_cast<T*>(resource_->allocate(count * sizeof(T)));
+        }
+        void deallocate(T* pointer, std::size_t count) {
+            resource_->deallocate(pointer, count * sizeof(T));
+        }
+        void construct(T* pointer, const T& value) {
+            new (static_cast<void*>(pointer)) T(value);
+        }
+        void destroy(T* pointer) {
+            pointer->~T();
+        }
+
+        MemoryResource* resource() const { return resource_; }
+
+        bool operator == (const Allocator& rhs) const { return resource_ == rhs.resource_; }
+        bool operator != (const Allocator& rhs) const { return resource_ != rhs.resource_; }
+      private:
+        MemoryResource* resource_;
+    };
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_MEMORY_H
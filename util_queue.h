@@ -10,11 +10,12 @@
 namespace util {
 
     //implementation of queue using util::Stack
-    template<typename T>
+    template<typename T, typename Alloc = Allocator<T> >
     class Queue {
       public:
         //constructors
         Queue();
+        explicit Queue(const Alloc& allocator);
         Queue(const Queue& rhs);
 
         //assignment operator
@@ -41,71 +42,79 @@ namespace util {
 
         //method that erases all elements from the queue
         void clear();
+
+        //method that returns the allocator the elements are stored with
+        const Alloc& get_allocator() const;
       private:
-        mutable Stack<T> s1_, s2_;
+        mutable Stack<T, Alloc> s1_, s2_;
         void flush() const;
     };
 
-    template <typename T>
-    Queue<T>::Queue() {}
+    template <typename T, typename Alloc>
+    Queue<T, Alloc>::Queue() {}
 
-    template <typename T>
-    Queue<T>::Queue(const Queue &rhs) {
-        s1_ = rhs.s1_;
-        s2_ = rhs.s2_;
-    }
+    template <typename T, typename Alloc>
+    Queue<T, Alloc>::Queue(const Alloc& allocator) : s1_(allocator), s2_(allocator) {}
 
-    template <typename T>
-    Queue<T>& Queue<T>::operator=(const Queue &rhs) {
+    template <typename T, typename Alloc>
+    Queue<T, Alloc>::Queue(const Queue &rhs) : s1_(rhs.s1_), s2_(rhs.s2_) {}
+
+    template <typename T, typename Alloc>
+    Queue<T, Alloc>& Queue<T, Alloc>::operator=(const Queue &rhs) {
         s1_ = rhs.s1_;
         s2_ = rhs.s2_;
         return (*this);
     }
 
-    template <typename T>
-    Queue<T>::~Queue() {}
+    template <typename T, typename Alloc>
+    Queue<T, Alloc>::~Queue() {}
 
-    template <typename T>
-    size_t Queue<T>::size() const {
+    template <typename T, typename Alloc>
+    size_t Queue<T, Alloc>::size() const {
         return s1_.size() + s2_.size();
     }
 
-    template<typename T>
-    bool Queue<T>::empty() const {
+    template<typename T, typename Alloc>
+    bool Queue<T, Alloc>::empty() const {
         return (size() == 0);
     }
 
-    template<typename T>
-    const T& Queue<T>::front() const {
+    template<typename T, typename Alloc>
+    const T& Queue<T, Alloc>::front() const {
         flush();
         return s1_.top();
     }
 
-    template<typename T>
-    T& Queue<T>::front() {
+    template<typename T, typename Alloc>
+    T& Queue<T, Alloc>::front() {
         flush();
         return s1_.top();
     }
 
-    template<typename T>
-    void Queue<T>::push(const T &value) {
+    template<typename T, typename Alloc>
+    void Queue<T, Alloc>::push(const T &value) {
         s2_.push(value);
     }
 
-    template<typename T>
-    void Queue<T>::pop() {
+    template<typename T, typename Alloc>
+    void Queue<T, Alloc>::pop() {
         flush();
         s1_.pop();
     }
 
-    template<typename T>
-    void Queue<T>::clear() {
+    template<typename T, typename Alloc>
+    void Queue<T, Alloc>::clear() {
         s1_.clear();
         s2_.clear();
     }
 
-    template<typename T>
-    void Queue<T>::flush() const {
+    template<typename T, typename Alloc>
+    const Alloc& Queue<T, Alloc>::get_allocator() const {
+        return s1_.get_allocator();
+    }
+
+    template<typename T, typename Alloc>
+    void Queue<T, Alloc>::flush() const {
         if (!s1_.empty())
             return;
         while (!s2_.empty()) {
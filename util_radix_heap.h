@@ -0,0 +1,170 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_RADIX_HEAP_H
+#define DIRECTEDGRAPHHANDLER_UTIL_RADIX_HEAP_H
+
+#include <utility>
+#include <stdexcept>
+#include "util_vector.h"
+
+namespace util {
+
+    //implementation of a monotone radix heap with unsigned integer keys, as explained here:
+    //https://en.wikipedia.org/wiki/Radix_heap
+    //the keys pushed must never be smaller than the last key removed by pop, which holds for
+    //Dijkstra with non-negative weights; every element is moved between buckets at most
+    //64 times, so push is O(1) and pop is amortized O(log of the key range)
+    template<typename T, typename Alloc = Allocator< std::pair<unsigned long long, T> > >
+    class RadixHeap {
+      public:
+        typedef unsigned long long key_type;
+        typedef std::pair<key_type, T> value_type;
+
+        //constructors
+        RadixHeap();
+        explicit RadixHeap(const Alloc& allocator);
+        RadixHeap(const RadixHeap& rhs);
+
+        //assignment operator
+        RadixHeap& operator = (const RadixHeap& rhs);
+
+        //destructor
+        virtual ~RadixHeap();
+
+        //method that returns the number of elements in the heap
+        size_t size() const;
+
+        //method that returns true if the heap is empty
+        bool empty() const;
+
+        //method that returns the element with the smallest key
+        //(not const, because the elements may first have to be redistributed between buckets)
+        const value_type& top();
+
+        //method to insert a value with the given key; throws std::invalid_argument
+        //if the key is smaller than the last key removed from the heap
+        void push(key_type key, const T& value);
+
+        //method to erase the element with the smallest key
+        void pop();
+
+        //method that erases all elements from the heap and allows any key again
+        void clear();
+      private:
+        //bucket 0 holds the keys equal to last_key_, bucket i > 0 the keys whose
+        //highest bit that differs from last_key_ is bit i - 1
+        enum { BUCKET_COUNT = 65 };
+
+        Vector<value_type, Alloc> buckets_[BUCKET_COUNT];
+        key_type last_key_;
+        size_t size_;
+
+        static int bucket_index(key_type key, key_type last_key);
+        //moves the smallest keys into bucket 0, raising last_key_ to their value
+        void refill();
+    };
+
+    template<typename T, typename Alloc>
+    RadixHeap<T, Alloc>::RadixHeap() : last_key_(0), size_(0) {}
+
+    template<typename T, typename Alloc>
+    RadixHeap<T, Alloc>::RadixHeap(const Alloc& allocator) : last_key_(0), size_(0) {
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+            buckets_[i] = Vector<value_type, Alloc>(allocator);
+    }
+
+    template<typename T, typename Alloc>
+    RadixHeap<T, Alloc>::RadixHeap(const RadixHeap &rhs) : last_key_(rhs.last_key_), size_(rhs.size_) {
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+            buckets_[i] = rhs.buckets_[i];
+    }
+
+    template<typename T, typename Alloc>
+    RadixHeap<T, Alloc>& RadixHeap<T, Alloc>::operator=(const RadixHeap &rhs) {
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+            buckets_[i] = rhs.buckets_[i];
+        last_key_ = rhs.last_key_;
+        size_ = rhs.size_;
+        return (*this);
+    }
+
+    template<typename T, typename Alloc>
+    RadixHeap<T, Alloc>::~RadixHeap() {}
+
+    template<typename T, typename Alloc>
+    size_t RadixHeap<T, Alloc>::size() const {
+        return size_;
+    }
+
+    template<typename T, typename Alloc>
+    bool RadixHeap<T, Alloc>::empty() const {
+        return size_ == 0;
+    }
+
+    template<typename T, typename Alloc>
+    const typename RadixHeap<T, Alloc>::value_type& RadixHeap<T, Alloc>::top() {
+        if (empty())
+            throw std::out_of_range("Container is empty!");
+        if (buckets_[0].empty())
+            refill();
+        return buckets_[0].back();
+    }
+
+    template<typename T, typename Alloc>
+    void RadixHeap<T, Alloc>::push(key_type key, const T &value) {
+        if (key < last_key_)
+            throw std::invalid_argument("Key is smaller than the last removed key!");
+        buckets_[bucket_index(key, last_key_)].push_back(value_type(key, value));
+        size_++;
+    }
+
+    template<typename T, typename Alloc>
+    void RadixHeap<T, Alloc>::pop() {
+        top();
+        buckets_[0].pop_back();
+        size_--;
+    }
+
+    template<typename T, typename Alloc>
+    void RadixHeap<T, Alloc>::clear() {
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+            buckets_[i].clear();
+        last_key_ = 0;
+        size_ = 0;
+    }
+
+    template<typename T, typename Alloc>
+    int RadixHeap<T, Alloc>::bucket_index(key_type key, key_type last_key) {
+        key_type difference = key ^ last_key;
+        if (difference == 0)
+            return 0;
+#ifdef __GNUC__
+        return 64 - __builtin_clzll(difference);
+#else
+        int index = 0;
+        for (; difference != 0; difference >>= 1)
+            index++;
+        return index;
+#endif
+    }
+
+    template<typename T, typename Alloc>
+    void RadixHeap<T, Alloc>::refill() {
+        int index = 1;
+        while (buckets_[index].empty())
+            index++;
+
+        Vector<value_type, Alloc>& bucket = buckets_[index];
+        key_type min_key = bucket[0].first;
+        for (size_t i = 1; i < bucket.size(); ++i)
+            min_key = std::min(min_key, bucket[i].first);
+
+        //relative to the new last key every element of the bucket lands in a lower one;
+        //popping from the back keeps the bucket's storage for later use
+        last_key_ = min_key;
+        while (!bucket.empty()) {
+            buckets_[bucket_index(bucket.back().first, last_key_)].push_back(bucket.back());
+            bucket.pop_back();
+        }
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_RADIX_HEAP_H
@@ -10,11 +10,12 @@
 namespace util {
 
     //implementation of stack using util::Vector
-    template<typename T>
-    class Stack : protected Vector<T> {
+    template<typename T, typename Alloc = Allocator<T> >
+    class Stack : protected Vector<T, Alloc> {
       public:
         //constructors
         Stack();
+        explicit Stack(const Alloc& allocator);
         Stack(const Stack& rhs);
 
         //assignment operator
@@ -41,58 +42,67 @@ namespace util {
 
         //method that erases all elements from the stack
         void clear();
+
+        //method that returns the allocator the elements are stored with
+        const Alloc& get_allocator() const;
     };
 
-    template<typename T>
-    Stack<T>::Stack() : Vector<T>() {}
+    template<typename T, typename Alloc>
+    Stack<T, Alloc>::Stack() : Vector<T, Alloc>() {}
+
+    template<typename T, typename Alloc>
+    Stack<T, Alloc>::Stack(const Alloc& allocator) : Vector<T, Alloc>(allocator) {}
 
-    template<typename T>
-    Stack<T>::Stack(const Stack& rhs) : Vector<T>(rhs) {}
+    template<typename T, typename Alloc>
+    Stack<T, Alloc>::Stack(const Stack& rhs) : Vector<T, Alloc>(rhs) {}
 
-    template<typename T>
-    Stack<T>& Stack<T>::operator = (const Stack &rhs) {
-        Vector<T>::operator=(rhs);
+    template<typename T, typename Alloc>
+    Stack<T, Alloc>& Stack<T, Alloc>::operator = (const Stack &rhs) {
+        Vector<T, Alloc>::operator=(rhs);
         return (*this);
     }
 
-    template<typename T>
-    Stack<T>::~Stack() {
-        Vector<T>::~Vector();
+    template<typename T, typename Alloc>
+    Stack<T, Alloc>::~Stack() {}
+
+    template<typename T, typename Alloc>
+    size_t Stack<T, Alloc>::size() const {
+        return Vector<T, Alloc>::size();
     }
 
-    template<typename T>
-    size_t Stack<T>::size() const {
-        return Vector<T>::size();
+    template<typename T, typename Alloc>
+    bool Stack<T, Alloc>::empty() const {
+        return Vector<T, Alloc>::empty();
     }
 
-    template<typename T>
-    bool Stack<T>::empty() const {
-        return Vector<T>::empty();
+    template<typename T, typename Alloc>
+    const T& Stack<T, Alloc>::top() const {
+        return Vector<T, Alloc>::back();
     }
 
-    template<typename T>
-    const T& Stack<T>::top() const {
-        return Vector<T>::back();
+    template<typename T, typename Alloc>
+    T& Stack<T, Alloc>::top() {
+        return Vector<T, Alloc>::back();
     }
 
-    template<typename T>
-    T& Stack<T>::top() {
-        return Vector<T>::back();
+    template<typename T, typename Alloc>
+    void Stack<T, Alloc>::push(const T &value) {
+        Vector<T, Alloc>::push_back(value);
     }
 
-    template<typename T>
-    void Stack<T>::push(const T &value) {
-        Vector<T>::push_back(value);
+    template<typename T, typename Alloc>
+    void Stack<T, Alloc>::pop() {
+        Vector<T, Alloc>::pop_back();
     }
 
-    template<typename T>
-    void Stack<T>::pop() {
-        Vector<T>::pop_back();
+    template<typename T, typename Alloc>
+    void Stack<T, Alloc>::clear() {
+        Vector<T, Alloc>::clear();
     }
 
-    template<typename T>
-    void Stack<T>::clear() {
-        Vector<T>::clear();
+    template<typename T, typename Alloc>
+    const Alloc& Stack<T, Alloc>::get_allocator() const {
+        return Vector<T, Alloc>::get_allocator();
     }
 }
 
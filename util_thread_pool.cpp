@@ -0,0 +1,189 @@
+#include <cstdlib>
+#include "util_thread_pool.h"
+
+namespace util {
+
+    namespace {
+        //the pool whose worker is running on this thread, and the index of that worker
+        thread_local const ThreadPool* current_pool_ = NULL;
+        thread_local size_t current_index_ = 0;
+
+        ThreadPool* default_pool_ = NULL;
+        size_t default_thread_count_ = 0;
+        std::mutex default_pool_mutex_;
+
+        size_t hardware_thread_count() {
+            unsigned int count = std::thread::hardware_concurrency();
+            return (count == 0 ? 1 : count);
+        }
+    }
+
+    //implementation of ThreadPool's methods
+    ThreadPool::ThreadPool(size_t thread_count) :
+            thread_count_(thread_count == 0 ? hardware_thread_count() : thread_count),
+            queues_(new TaskQueue[thread_count_ + 1]), queued_(0), stopping_(false) {
+        for (size_t i = 0; i < thread_count_; ++i)
+            threads_.push_back(new std::thread(&ThreadPool::worker_loop, this, i));
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard< std::mutex > lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_up_.notify_all();
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            threads_[i]->join();
+            delete threads_[i];
+        }
+        delete[] queues_;
+    }
+
+    size_t ThreadPool::thread_count() const {
+        return thread_count_;
+    }
+
+    size_t ThreadPool::current_thread_index() const {
+        return (current_pool_ == this ? current_index_ : thread_count_);
+    }
+
+    void ThreadPool::submit(const Task &task) {
+        TaskQueue& queue = queues_[current_thread_index()];
+        {
+            std::lock_guard< std::mutex > lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+        queued_.fetch_add(1);
+        //the sleeping workers check queued_ while holding sleep_mutex_, so taking it
+        //here guarantees that none of them misses the notification
+        { std::lock_guard< std::mutex > lock(sleep_mutex_); }
+        wake_up_.notify_one();
+    }
+
+    bool ThreadPool::run_pending_task() {
+        Task task;
+        if (queued_.load() == 0 || !pop_task(current_thread_index(), task))
+            return false;
+        task();
+        return true;
+    }
+
+    bool ThreadPool::pop_task(size_t index, Task &task) {
+        //first the newest task of the own queue, then the oldest one of every other queue
+        if (index < thread_count_) {
+            TaskQueue& own = queues_[index];
+            std::lock_guard< std::mutex > lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        for (size_t i = 1; i <= thread_count_; ++i) {
+            TaskQueue& victim = queues_[(index + i) % (thread_count_ + 1)];
+            std::lock_guard< std::mutex > lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::worker_loop(size_t index) {
+        current_pool_ = this;
+        current_index_ = index;
+        Task task;
+        for (;;) {
+            if (pop_task(index, task)) {
+                task();
+                task = Task();
+                continue;
+            }
+            std::unique_lock< std::mutex > lock(sleep_mutex_);
+            if (queued_.load() != 0)
+                continue;
+            if (stopping_)
+                return;
+            wake_up_.wait(lock);
+        }
+    }
+
+    ThreadPool& default_thread_pool() {
+        std::lock_guard< std::mutex > lock(default_pool_mutex_);
+        if (default_pool_ == NULL) {
+            size_t thread_count = default_thread_count_;
+            const char* variable = std::getenv("DGRAPH_THREADS");
+            if (thread_count == 0 && variable != NULL)
+                thread_count = (size_t)std::strtoul(variable, NULL, 10);
+            default_pool_ = new ThreadPool(thread_count);
+        }
+        return (*default_pool_);
+    }
+
+    void set_default_thread_count(size_t thread_count) {
+        std::lock_guard< std::mutex > lock(default_pool_mutex_);
+        default_thread_count_ = thread_count;
+        delete default_pool_;
+        default_pool_ = NULL;
+    }
+
+    //implementation of TaskGroup's methods
+    TaskGroup::TaskGroup(ThreadPool &pool) : pool_(pool), pending_(0), done_(true) {}
+
+    TaskGroup::~TaskGroup() {
+        try {
+            wait();
+        }
+        catch (...) {}
+    }
+
+    void TaskGroup::run(const Task &task) {
+        //only the owner can start a group from 0, since while a task is running it is still pending
+        if (pending_.fetch_add(1) == 0)
+            done_.store(false);
+        pool_.submit([this, task]() {
+            try {
+                task();
+            }
+            catch (...) {
+                std::lock_guard< std::mutex > lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+            finish_task();
+        });
+    }
+
+    void TaskGroup::finish_task() {
+        if (pending_.fetch_sub(1) == 1) {
+            std::lock_guard< std::mutex > lock(mutex_);
+            done_.store(true);
+            finished_.notify_all();
+        }
+    }
+
+    void TaskGroup::wait() {
+        //a worker must keep running tasks, otherwise a pool whose workers all wait would deadlock
+        if (pool_.current_thread_index() < pool_.thread_count())
+            while (!done_.load())
+                if (!pool_.run_pending_task())
+                    std::this_thread::yield();
+
+        std::unique_lock< std::mutex > lock(mutex_);
+        while (!done_.load())
+            finished_.wait(lock);
+        if (error_) {
+            std::exception_ptr error = error_;
+            error_ = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+    }
+
+    ThreadPool& TaskGroup::pool() const {
+        return pool_;
+    }
+}
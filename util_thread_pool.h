@@ -0,0 +1,204 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_THREAD_POOL_H
+#define DIRECTEDGRAPHHANDLER_UTIL_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "util_vector.h"
+
+namespace util {
+
+    typedef std::function< void() > Task;
+
+    //implementation of a work-stealing thread pool
+    //every worker owns a deque: it pushes and pops the tasks it spawns at the back, so recent
+    //(cache-warm) work runs first, while idle workers steal the oldest tasks from the front,
+    //which in a recursive decomposition are the largest ones. Tasks submitted by threads
+    //outside the pool go to a shared queue that every worker steals from.
+    class ThreadPool {
+      public:
+        //thread_count == 0 starts one worker per hardware thread
+        explicit ThreadPool(size_t thread_count = 0);
+        //the workers finish the queued tasks before they are joined
+        virtual ~ThreadPool();
+
+        //method that returns the number of worker threads
+        size_t thread_count() const;
+
+        //method that returns the index of the calling worker in [0, thread_count()),
+        //or thread_count() if the caller is not one of the workers of this pool
+        size_t current_thread_index() const;
+
+        //method that queues a task; it runs on some worker, exceptions must not escape it
+        void submit(const Task& task);
+
+        //method that runs one queued task on the calling thread, if there is any;
+        //lets a worker that waits for other tasks help instead of blocking
+        bool run_pending_task();
+      private:
+        ThreadPool(const ThreadPool& rhs);
+        ThreadPool& operator = (const ThreadPool& rhs);
+
+        struct TaskQueue {
+            std::mutex mutex;
+            std::deque< Task > tasks;
+        };
+
+        void worker_loop(size_t index);
+        bool pop_task(size_t index, Task& task);
+
+        size_t thread_count_;
+        //queues_[i] belongs to worker i, queues_[thread_count_] is the shared one
+        TaskQueue* queues_;
+        Vector< std::thread* > threads_;
+        std::atomic< size_t > queued_;
+        bool stopping_;
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_up_;
+    };
+
+    //the pool used by every parallel algorithm of the library; it is created on first use with
+    //the number of threads given by the DGRAPH_THREADS environment variable, if it is set,
+    //or by the last call to set_default_thread_count, and one per hardware thread otherwise
+    ThreadPool& default_thread_pool();
+    //replaces the default pool by one with thread_count threads (0 for one per hardware thread);
+    //no parallel algorithm or asynchronous operation may be running meanwhile
+    void set_default_thread_count(size_t thread_count);
+
+    //a set of tasks that can be waited for together
+    //tasks may add more tasks to their own group, which is how recursive decompositions are
+    //expressed; wait() returns once all of them finished and rethrows the first exception
+    class TaskGroup {
+      public:
+        explicit TaskGroup(ThreadPool& pool = default_thread_pool());
+        //waits for the remaining tasks, dropping their exceptions
+        virtual ~TaskGroup();
+
+        //method that queues a task of the group
+        void run(const Task& task);
+
+        //method that waits for every task of the group; a worker runs queued tasks meanwhile
+        void wait();
+
+        ThreadPool& pool() const;
+      private:
+        TaskGroup(const TaskGroup& rhs);
+        TaskGroup& operator = (const TaskGroup& rhs);
+
+        void finish_task();
+
+        ThreadPool& pool_;
+        std::atomic< size_t > pending_;
+        //set under mutex_ by the task that finishes last, so that a waiter cannot
+        //destroy the group while that task still uses it
+        std::atomic< bool > done_;
+        std::mutex mutex_;
+        std::condition_variable finished_;
+        std::exception_ptr error_;
+    };
+
+    //one value per worker of a pool, plus one for the threads outside of it, so that the tasks of
+    //a parallel algorithm can keep scratch buffers and partial results without synchronization
+    //a task must not rely on its value across a TaskGroup::wait, since the worker may run
+    //another task of the same algorithm meanwhile
+    template<typename T>
+    class WorkerLocal {
+      public:
+        explicit WorkerLocal(const T& value = T(), ThreadPool& pool = default_thread_pool());
+        virtual ~WorkerLocal();
+
+        //method that returns the value of the calling thread
+        T& local();
+
+        //methods for combining the values once the parallel part is over
+        size_t size() const;
+        T& operator[] (size_t index);
+      private:
+        WorkerLocal(const WorkerLocal& rhs);
+        WorkerLocal& operator = (const WorkerLocal& rhs);
+
+        ThreadPool& pool_;
+        Vector< T > values_;
+    };
+
+    //calls body(chunk_begin, chunk_end) on consecutive chunks of at most grain indices covering
+    //[begin, end), in parallel, and returns once all of them are done; the chunks start at
+    //begin + k * grain, so a body can tell which chunk it got. A range of a single chunk runs
+    //directly on the calling thread.
+    template<typename Body>
+    void parallel_for(size_t begin, size_t end, size_t grain, const Body& body,
+                      ThreadPool& pool = default_thread_pool());
+
+    //implementation of WorkerLocal's methods
+    template<typename T>
+    WorkerLocal<T>::WorkerLocal(const T &value, ThreadPool &pool) :
+            pool_(pool), values_(pool.thread_count() + 1, value) {}
+
+    template<typename T>
+    WorkerLocal<T>::~WorkerLocal() {}
+
+    template<typename T>
+    T& WorkerLocal<T>::local() {
+        return values_[pool_.current_thread_index()];
+    }
+
+    template<typename T>
+    size_t WorkerLocal<T>::size() const {
+        return values_.size();
+    }
+
+    template<typename T>
+    T& WorkerLocal<T>::operator[](size_t index) {
+        return values_[index];
+    }
+
+    namespace detail {
+        //splits a range in halves, queueing the upper half and continuing with the lower one;
+        //a thief thus takes the largest piece of work that is left
+        template<typename Body>
+        class ParallelForTask {
+          public:
+            ParallelForTask(size_t begin, size_t end, size_t grain, const Body& body, TaskGroup& group) :
+                    begin_(begin), end_(end), grain_(grain), body_(body), group_(group) {}
+
+            void operator () () const {
+                size_t begin = begin_, end = end_;
+                while (end - begin > grain_) {
+                    //the split point stays on a chunk boundary
+                    size_t middle = begin + (end - begin) / grain_ / 2 * grain_;
+                    if (middle == begin)
+                        middle += grain_;
+                    group_.run(ParallelForTask(middle, end, grain_, body_, group_));
+                    end = middle;
+                }
+                body_(begin, end);
+            }
+          private:
+            size_t begin_, end_, grain_;
+            const Body& body_;
+            TaskGroup& group_;
+        };
+    }
+
+    template<typename Body>
+    void parallel_for(size_t begin, size_t end, size_t grain, const Body& body, ThreadPool& pool) {
+        if (begin >= end)
+            return;
+        if (grain == 0)
+            grain = 1;
+        if (end - begin <= grain) {
+            body(begin, end);
+            return;
+        }
+        TaskGroup group(pool);
+        group.run(detail::ParallelForTask<Body>(begin, end, grain, body, group));
+        group.wait();
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_THREAD_POOL_H
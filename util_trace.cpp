@@ -0,0 +1,165 @@
+#include <cstring>
+#include <mutex>
+#include <time.h>
+#include "util_trace.h"
+#include "util_vector.h"
+
+namespace util {
+    namespace trace {
+
+        std::atomic< bool > enabled_(false);
+        std::atomic< long long > counters_[COUNTER_COUNT];
+        thread_local bool recording_ = false;
+
+        namespace {
+            struct TraceEvent {
+                const char* name;
+                int thread;
+                double start_us, duration_us;
+                long long counters[COUNTER_COUNT];
+            };
+
+            //the events of all threads, guarded by events_mutex_
+            std::mutex events_mutex_;
+            Vector< TraceEvent > events_;
+
+            //numbers the threads in the order of their first event, for the tid of the trace
+            std::atomic< int > thread_count_(0);
+            thread_local int thread_number_ = -1;
+
+            int current_thread_number() {
+                if (thread_number_ < 0)
+                    thread_number_ = ++thread_count_;
+                return thread_number_;
+            }
+
+            double now_us() {
+                timespec ts;
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+            }
+
+            //aggregated statistics of all events with the same name
+            struct ScopeSummary {
+                const char* name;
+                long long calls;
+                double total_us, max_us;
+                long long counters[COUNTER_COUNT];
+            };
+        }
+
+        void set_enabled(bool enabled) { enabled_ = enabled; }
+        bool is_enabled() { return enabled_; }
+
+        void reset() {
+            std::lock_guard< std::mutex > lock(events_mutex_);
+            events_.clear();
+            for (int i = 0; i < COUNTER_COUNT; ++i)
+                counters_[i] = 0;
+        }
+
+        long long get_counter(Counter counter) { return counters_[counter]; }
+
+        const char* counter_name(Counter counter) {
+            static const char* names[COUNTER_COUNT] = {
+                "nodes_visited", "edges_scanned", "container_reallocations"
+            };
+            return names[counter];
+        }
+
+        //implementation of ScopedTimer's methods
+        ScopedTimer::ScopedTimer(const char* name) : name_(name), active_(enabled_), start_us_(0) {
+            if (!active_)
+                return;
+            for (int i = 0; i < COUNTER_COUNT; ++i)
+                start_counters_[i] = counters_[i];
+            start_us_ = now_us();
+        }
+
+        ScopedTimer::~ScopedTimer() {
+            if (!active_)
+                return;
+            TraceEvent event;
+            event.name = name_;
+            event.thread = current_thread_number();
+            event.start_us = start_us_;
+            event.duration_us = now_us() - start_us_;
+            for (int i = 0; i < COUNTER_COUNT; ++i)
+                event.counters[i] = counters_[i] - start_counters_[i];
+            //the growth of the event buffer itself must not be counted
+            std::lock_guard< std::mutex > lock(events_mutex_);
+            recording_ = true;
+            try {
+                events_.push_back(event);
+            }
+            catch (...) {
+                //a destructor must not throw; the event is dropped
+            }
+            recording_ = false;
+        }
+
+        void write_chrome_trace(std::ostream& out) {
+            std::lock_guard< std::mutex > lock(events_mutex_);
+            double origin = (events_.empty() ? 0 : events_[0].start_us);
+            for (size_t i = 0; i < events_.size(); ++i)
+                origin = std::min(origin, events_[i].start_us);
+
+            out << "{\"traceEvents\":[";
+            for (size_t i = 0; i < events_.size(); ++i) {
+                const TraceEvent& event = events_[i];
+                out << (i == 0 ? "\n" : ",\n")
+                    << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                    << ",\"ts\":" << event.start_us - origin << ",\"dur\":" << event.duration_us
+                    << ",\"args\":{";
+                for (int c = 0; c < COUNTER_COUNT; ++c)
+                    out << (c == 0 ? "" : ",") << '"' << counter_name((Counter)c) << "\":" << event.counters[c];
+                out << "}}";
+            }
+            out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+
+        void write_summary(std::ostream& out) {
+            std::lock_guard< std::mutex > lock(events_mutex_);
+            Vector< ScopeSummary > summaries;
+            for (size_t i = 0; i < events_.size(); ++i) {
+                const TraceEvent& event = events_[i];
+                size_t k = 0;
+                while (k < summaries.size() && std::strcmp(summaries[k].name, event.name) != 0)
+                    k++;
+                if (k == summaries.size()) {
+                    ScopeSummary summary;
+                    summary.name = event.name;
+                    summary.calls = 0;
+                    summary.total_us = summary.max_us = 0;
+                    for (int c = 0; c < COUNTER_COUNT; ++c)
+                        summary.counters[c] = 0;
+                    summaries.push_back(summary);
+                }
+                ScopeSummary& summary = summaries[k];
+                summary.calls++;
+                summary.total_us += event.duration_us;
+                summary.max_us = std::max(summary.max_us, event.duration_us);
+                for (int c = 0; c < COUNTER_COUNT; ++c)
+                    summary.counters[c] += event.counters[c];
+            }
+
+            out << "scope\tcalls\ttotal_ms\tmean_ms\tmax_ms";
+            for (int c = 0; c < COUNTER_COUNT; ++c)
+                out << '\t' << counter_name((Counter)c);
+            out << '\n';
+            for (size_t k = 0; k < summaries.size(); ++k) {
+                const ScopeSummary& summary = summaries[k];
+                out << summary.name << '\t' << summary.calls << '\t' << summary.total_us / 1000 << '\t'
+                    << summary.total_us / 1000 / summary.calls << '\t' << summary.max_us / 1000;
+                for (int c = 0; c < COUNTER_COUNT; ++c)
+                    out << '\t' << summary.counters[c];
+                out << '\n';
+            }
+
+            out << "counters:";
+            for (int c = 0; c < COUNTER_COUNT; ++c)
+                out << ' ' << counter_name((Counter)c) << '=' << counters_[c];
+            out << '\n';
+        }
+    }
+}
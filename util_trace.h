@@ -0,0 +1,80 @@
+#ifndef DIRECTEDGRAPHHANDLER_UTIL_TRACE_H
+#define DIRECTEDGRAPHHANDLER_UTIL_TRACE_H
+
+#include <atomic>
+#include <iostream>
+
+//the instrumentation is compiled in only when DGRAPH_ENABLE_TRACING is defined
+//(cmake -DDGRAPH_ENABLE_TRACING=ON); otherwise the macros below expand to nothing.
+//when compiled in, it still records nothing until util::trace::set_enabled(true) is called
+#ifdef DGRAPH_ENABLE_TRACING
+#define DGRAPH_TRACE_CONCAT_IMPL(a, b) a##b
+#define DGRAPH_TRACE_CONCAT(a, b) DGRAPH_TRACE_CONCAT_IMPL(a, b)
+//times the enclosing scope; name must be a string literal
+#define DGRAPH_TRACE_SCOPE(name) \
+        util::trace::ScopedTimer DGRAPH_TRACE_CONCAT(dgraph_trace_scope_, __LINE__)(name)
+//adds amount to one of the util::trace::Counter values
+#define DGRAPH_TRACE_COUNT(counter, amount) \
+        util::trace::add_to_counter(util::trace::counter, (long long)(amount))
+#else
+#define DGRAPH_TRACE_SCOPE(name) ((void)0)
+#define DGRAPH_TRACE_COUNT(counter, amount) ((void)0)
+#endif
+
+namespace util {
+    namespace trace {
+
+        enum Counter {
+            NODES_VISITED,
+            EDGES_SCANNED,
+            CONTAINER_REALLOCATIONS,
+            COUNTER_COUNT
+        };
+
+        //atomic, since the tasks of the parallel algorithms count from several threads
+        extern std::atomic< bool > enabled_;
+        extern std::atomic< long long > counters_[COUNTER_COUNT];
+        //set while the calling thread records an event, so that the growth of the event buffer is
+        //not counted; per thread, so the counts of the other threads are kept meanwhile
+        extern thread_local bool recording_;
+
+        //turns the recording on or off at run time
+        void set_enabled(bool enabled);
+        bool is_enabled();
+
+        //drops all recorded scopes and sets every counter to 0
+        void reset();
+
+        inline void add_to_counter(Counter counter, long long amount) {
+            if (enabled_.load(std::memory_order_relaxed) && !recording_)
+                counters_[counter].fetch_add(amount, std::memory_order_relaxed);
+        }
+        long long get_counter(Counter counter);
+        const char* counter_name(Counter counter);
+
+        //records the duration of its lifetime, together with the counter increments
+        //that happened meanwhile (in any thread), as one complete event of the calling thread;
+        //timers may end on several threads at once
+        class ScopedTimer {
+          public:
+            explicit ScopedTimer(const char* name);
+            virtual ~ScopedTimer();
+          private:
+            ScopedTimer(const ScopedTimer& rhs);
+            ScopedTimer& operator = (const ScopedTimer& rhs);
+
+            const char* name_;
+            bool active_;
+            double start_us_;
+            long long start_counters_[COUNTER_COUNT];
+        };
+
+        //writes the recorded scopes in the Chrome trace event format
+        //(loadable in chrome://tracing or https://ui.perfetto.dev)
+        void write_chrome_trace(std::ostream& out);
+        //writes the number of calls and the time spent in every scope, followed by the counters
+        void write_summary(std::ostream& out);
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_UTIL_TRACE_H
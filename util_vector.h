@@ -7,28 +7,36 @@
 
 #include <cstdlib> //included for NULL macro
 #include <exception>
+#include <stdexcept>
 #include <algorithm>
+#include "util_trace.h"
+#include "util_memory.h"
 
 namespace util {
+    //sizes and indices of the containers, which thus hold at most 2^32 - 1 elements
     typedef unsigned int size_t;
 
     //implementation of STL-like vector
-    template<typename T>
+    //the memory is obtained from Alloc and only the first size() elements are constructed
+    template<typename T, typename Alloc = Allocator<T> >
     class Vector {
       public:
         typedef T* iterator;
         typedef const T* const_iterator;
+        typedef Alloc allocator_type;
 
         //constructors
         Vector();
-        explicit Vector(size_t size, T value = T());
+        explicit Vector(const Alloc& allocator);
+        explicit Vector(size_t size, T value = T(), const Alloc& allocator = Alloc());
         Vector(const Vector& rhs);
 
         //assignment operator
         Vector& operator = (const Vector& rhs);
 
-        //destructor
-        virtual ~Vector();
+        //destructor; not virtual, so that Vectors held by value (e.g. the adjacency
+        //lists of every node) do not each carry a vptr
+        ~Vector();
 
         //method that returns the number of elements in this vector
         size_t size() const;
@@ -39,6 +47,12 @@ namespace util {
         //method that returns true if there are no elements in this vector
         bool empty() const;
 
+        //method that makes room for at least capacity elements without changing the size
+        void reserve(size_t capacity);
+
+        //method that returns the allocator the elements are stored with
+        const Alloc& get_allocator() const;
+
         iterator begin();
         const_iterator begin() const;
         iterator end();
@@ -65,157 +79,203 @@ namespace util {
       protected:
         size_t size_, capacity_;
         T* data_;
+        Alloc allocator_;
 
         void expand_capacity();
+        void reallocate(size_t capacity);
+        void release();
     };
 
-    template<typename T>
-    Vector<T>::Vector() : size_(0), capacity_(0), data_(NULL) {}
+    template<typename T, typename Alloc>
+    Vector<T, Alloc>::Vector() : size_(0), capacity_(0), data_(NULL), allocator_() {}
+
+    template<typename T, typename Alloc>
+    Vector<T, Alloc>::Vector(const Alloc& allocator) :
+            size_(0), capacity_(0), data_(NULL), allocator_(allocator) {}
 
-    template<typename T>
-    Vector<T>::Vector(size_t size, T value) :
+    template<typename T, typename Alloc>
+    Vector<T, Alloc>::Vector(size_t size, T value, const Alloc& allocator) :
             size_(size),
-            capacity_(size) {
-        data_ = (size == 0 ? NULL : new T[size]);
+            capacity_(size),
+            allocator_(allocator) {
+        data_ = (size == 0 ? NULL : allocator_.allocate(size));
         for (size_t i = 0; i < size; ++i)
-            data_[i] = value;
+            allocator_.construct(data_ + i, value);
     }
 
-    template<typename T>
-    Vector<T>::Vector(const Vector &rhs) {
+    template<typename T, typename Alloc>
+    Vector<T, Alloc>::Vector(const Vector &rhs) : allocator_(rhs.allocator_) {
         size_ = rhs.size_;
         capacity_ = rhs.capacity_;
-        data_ = (capacity_ == 0 ? NULL : new T[capacity_]);
+        data_ = (capacity_ == 0 ? NULL : allocator_.allocate(capacity_));
         for (size_t i = 0; i < size_; ++i)
-            data_[i] = rhs.data_[i];
+            allocator_.construct(data_ + i, rhs.data_[i]);
     }
 
-    template <typename T>
-    Vector<T>& Vector<T>::operator = (const Vector &rhs) {
+    template<typename T, typename Alloc>
+    Vector<T, Alloc>& Vector<T, Alloc>::operator = (const Vector &rhs) {
+        if (this == &rhs)
+            return (*this);
+        //the elements are copied first, so an exception leaves this vector untouched
+        T* copied_data = (rhs.capacity_ == 0 ? NULL : allocator_.allocate(rhs.capacity_));
+        for (size_t i = 0; i < rhs.size_; ++i)
+            allocator_.construct(copied_data + i, rhs.data_[i]);
+        release();
         size_ = rhs.size_;
         capacity_ = rhs.capacity_;
-        T* copied_data = (capacity_ == 0 ? NULL : new T[capacity_]);
-        for (size_t i = 0; i < size_; ++i)
-            copied_data[i] = rhs.data_[i];
-        if (data_ != NULL)
-            delete[] data_;
         data_ = copied_data;
         return (*this);
     }
 
-    template<typename T>
-    Vector<T>::~Vector() {
-        clear();
+    template<typename T, typename Alloc>
+    Vector<T, Alloc>::~Vector() {
+        release();
     }
 
-    template<typename T>
-    size_t Vector<T>::size() const {
+    template<typename T, typename Alloc>
+    size_t Vector<T, Alloc>::size() const {
         return size_;
     }
 
-    template <typename T>
-    size_t Vector<T>::capacity() const {
+    template<typename T, typename Alloc>
+    size_t Vector<T, Alloc>::capacity() const {
         return capacity_;
     }
 
-    template<typename T>
-    bool Vector<T>::empty() const {
+    template<typename T, typename Alloc>
+    bool Vector<T, Alloc>::empty() const {
         return size_ == 0;
     }
 
-    template<typename T>
-    typename Vector<T>::iterator Vector<T>::begin() {
+    template<typename T, typename Alloc>
+    void Vector<T, Alloc>::reserve(size_t capacity) {
+        if (capacity > capacity_)
+            reallocate(capacity);
+    }
+
+    template<typename T, typename Alloc>
+    const Alloc& Vector<T, Alloc>::get_allocator() const {
+        return allocator_;
+    }
+
+    template<typename T, typename Alloc>
+    typename Vector<T, Alloc>::iterator Vector<T, Alloc>::begin() {
         return data_;
     }
 
-    template<typename T>
-    typename Vector<T>::const_iterator Vector<T>::begin() const {
+    template<typename T, typename Alloc>
+    typename Vector<T, Alloc>::const_iterator Vector<T, Alloc>::begin() const {
         return data_;
     }
 
-    template<typename T>
-    typename Vector<T>::iterator Vector<T>::end() {
+    template<typename T, typename Alloc>
+    typename Vector<T, Alloc>::iterator Vector<T, Alloc>::end() {
         return data_ + size_;
     }
 
-    template<typename T>
-    typename Vector<T>::const_iterator Vector<T>::end() const {
+    template<typename T, typename Alloc>
+    typename Vector<T, Alloc>::const_iterator Vector<T, Alloc>::end() const {
         return data_ + size_;
     }
 
-    template<typename T>
-    const T& Vector<T>::front() const {
+    template<typename T, typename Alloc>
+    const T& Vector<T, Alloc>::front() const {
         if (empty())
             throw std::out_of_range("Container is empty!");
         return data_[0];
     }
 
-    template<typename T>
-    T& Vector<T>::front() {
+    template<typename T, typename Alloc>
+    T& Vector<T, Alloc>::front() {
         return const_cast<T&>(
-                static_cast< const Vector<T>& >(*this).front()
+                static_cast< const Vector<T, Alloc>& >(*this).front()
         );
     }
 
-    template<typename T>
-    const T& Vector<T>::back() const {
+    template<typename T, typename Alloc>
+    const T& Vector<T, Alloc>::back() const {
         if (empty())
             throw std::out_of_range("Container is empty!");
         return data_[size_ - 1];
     }
 
-    template<typename T>
-    T& Vector<T>::back() {
+    template<typename T, typename Alloc>
+    T& Vector<T, Alloc>::back() {
         return const_cast<T&>(
-                static_cast< const Vector<T>& >(*this).back()
+                static_cast< const Vector<T, Alloc>& >(*this).back()
         );
     }
 
-    template<typename T>
-    const T& Vector<T>::operator[](size_t index) const {
+    template<typename T, typename Alloc>
+    const T& Vector<T, Alloc>::operator[](size_t index) const {
         if (index >= size_)
             throw std::out_of_range("Invalid index!");
         return data_[index];
     }
 
-    template<typename T>
-    T& Vector<T>::operator[](size_t index) {
+    template<typename T, typename Alloc>
+    T& Vector<T, Alloc>::operator[](size_t index) {
         return const_cast<T&>(
-                static_cast< const Vector<T>& >(*this)[index]
+                static_cast< const Vector<T, Alloc>& >(*this)[index]
         );
     }
 
-    template<typename T>
-    void Vector<T>::push_back(const T &value) {
-        if (size_ == capacity_)
+    template<typename T, typename Alloc>
+    void Vector<T, Alloc>::push_back(const T &value) {
+        if (size_ == capacity_) {
+            //value may live inside this vector, so it is copied before the old storage is freed
+            T copy(value);
             expand_capacity();
-        data_[size_++] = value;
+            allocator_.construct(data_ + size_, copy);
+        }
+        else
+            allocator_.construct(data_ + size_, value);
+        size_++;
     }
 
-    template <typename T>
-    void Vector<T>::pop_back() {
+    template<typename T, typename Alloc>
+    void Vector<T, Alloc>::pop_back() {
         if (empty())
             throw std::out_of_range("Container is empty!");
-        data_[--size_].~T();
+        allocator_.destroy(data_ + --size_);
     }
 
-    template <typename T>
-    void Vector<T>::clear() {
+    template<typename T, typename Alloc>
+    void Vector<T, Alloc>::clear() {
+        release();
+    }
+
+    template<typename T, typename Alloc>
+    void Vector<T, Alloc>::expand_capacity() {
+        //the doubling saturates at the largest size_t instead of wrapping around
+        const size_t max_capacity = (size_t)-1;
+        if (capacity_ == max_capacity)
+            throw std::length_error("Container is full!");
+        DGRAPH_TRACE_COUNT(CONTAINER_REALLOCATIONS, 1);
+        reallocate(capacity_ > max_capacity / 2 ? max_capacity : std::max((size_t)1, 2 * capacity_));
+    }
+
+    template<typename T, typename Alloc>
+    void Vector<T, Alloc>::reallocate(size_t capacity) {
+        T* new_data = allocator_.allocate(capacity);
+        for (size_t i = 0; i < size_; ++i) {
+            allocator_.construct(new_data + i, data_[i]);
+            allocator_.destroy(data_ + i);
+        }
         if (data_ != NULL)
-            delete[] data_;
-        size_ = capacity_ = 0;
-        data_ = NULL;
+            allocator_.deallocate(data_, capacity_);
+        data_ = new_data;
+        capacity_ = capacity;
     }
 
-    template<typename T>
-    void Vector<T>::expand_capacity() {
-        capacity_ = std::max((size_t)1, 2 * capacity_);
-        T* new_data = new T[capacity_];
+    template<typename T, typename Alloc>
+    void Vector<T, Alloc>::release() {
         for (size_t i = 0; i < size_; ++i)
-            new_data[i] = data_[i];
+            allocator_.destroy(data_ + i);
         if (data_ != NULL)
-            delete[] data_;
-        data_ = new_data;
+            allocator_.deallocate(data_, capacity_);
+        size_ = capacity_ = 0;
+        data_ = NULL;
     }
 }
 
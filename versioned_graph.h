@@ -0,0 +1,159 @@
+#ifndef DIRECTEDGRAPHHANDLER_VERSIONED_GRAPH_H
+#define DIRECTEDGRAPHHANDLER_VERSIONED_GRAPH_H
+
+#include <atomic>
+#include <cstddef>
+#include "util_epoch.h"
+#include "directed_graph.h"
+
+namespace dgraph {
+
+    //a graph shared by many reader threads and one writer thread
+    //the readers work on immutable published versions: a Snapshot pins the latest version
+    //without taking any lock, and stays valid and unchanged for its whole lifetime.
+    //the writer changes a private working copy and publishes it after each batch of changes;
+    //a replaced version is deleted once the last snapshot of it is gone (epoch-based reclamation).
+    //publishing copies the working graph, i.e. costs O(N + M), so changes should be batched
+    template<typename Graph = DirectedGraph>
+    class VersionedGraph {
+        struct Version;
+      public:
+        //read access to one published version
+        class Snapshot {
+          public:
+            Snapshot(Snapshot&& rhs);
+            ~Snapshot();
+
+            const Graph& graph() const;
+            const Graph& operator * () const;
+            const Graph* operator -> () const;
+
+            //number of the version, starting from 0 for the initial graph
+            unsigned long long version() const;
+          private:
+            friend class VersionedGraph;
+            Snapshot(util::EpochDomain& domain, const std::atomic< const Version* >& current);
+            Snapshot(const Snapshot& rhs);
+            Snapshot& operator = (const Snapshot& rhs);
+
+            util::EpochDomain* domain_;
+            util::size_t slot_;
+            const Version* version_;
+        };
+
+        //at most max_readers snapshots can be taken at once without waiting for each other
+        explicit VersionedGraph(const Graph& initial = Graph(), std::size_t max_readers = 128);
+        //no snapshot may outlive the graph
+        virtual ~VersionedGraph();
+
+        //method that pins the latest published version; may be called from any thread
+        Snapshot snapshot() const;
+
+        //method that returns the working copy, which only the writer thread may access
+        Graph& writer();
+        //method that makes the working copy visible to new snapshots and returns its version number
+        unsigned long long publish();
+
+        //method that returns the number of the latest published version; may be called from any thread
+        unsigned long long version() const;
+        //method that returns the number of replaced versions still held by snapshots (writer thread only)
+        std::size_t pending_versions() const;
+      private:
+        VersionedGraph(const VersionedGraph& rhs);
+        VersionedGraph& operator = (const VersionedGraph& rhs);
+
+        struct Version {
+            Version(const Graph& graph, unsigned long long number) : graph(graph), number(number) {}
+            const Graph graph;
+            const unsigned long long number;
+        };
+
+        mutable util::EpochDomain domain_;
+        std::atomic< const Version* > current_;
+        Graph working_;
+    };
+
+    //implementation of Snapshot's methods
+    template<typename Graph>
+    VersionedGraph<Graph>::Snapshot::Snapshot(util::EpochDomain &domain,
+                                              const std::atomic<const Version *> &current) :
+            domain_(&domain), slot_(domain.enter()), version_(current.load()) {}
+
+    template<typename Graph>
+    VersionedGraph<Graph>::Snapshot::Snapshot(Snapshot &&rhs) :
+            domain_(rhs.domain_), slot_(rhs.slot_), version_(rhs.version_) {
+        rhs.domain_ = NULL;
+    }
+
+    template<typename Graph>
+    VersionedGraph<Graph>::Snapshot::~Snapshot() {
+        if (domain_ != NULL)
+            domain_->exit(slot_);
+    }
+
+    template<typename Graph>
+    const Graph& VersionedGraph<Graph>::Snapshot::graph() const {
+        return version_->graph;
+    }
+
+    template<typename Graph>
+    const Graph& VersionedGraph<Graph>::Snapshot::operator * () const {
+        return version_->graph;
+    }
+
+    template<typename Graph>
+    const Graph* VersionedGraph<Graph>::Snapshot::operator -> () const {
+        return &version_->graph;
+    }
+
+    template<typename Graph>
+    unsigned long long VersionedGraph<Graph>::Snapshot::version() const {
+        return version_->number;
+    }
+
+    //implementation of VersionedGraph's methods
+    template<typename Graph>
+    VersionedGraph<Graph>::VersionedGraph(const Graph &initial, std::size_t max_readers) :
+            domain_(max_readers), current_(new Version(initial, 0)), working_(initial) {}
+
+    template<typename Graph>
+    VersionedGraph<Graph>::~VersionedGraph() {
+        delete current_.load();
+    }
+
+    template<typename Graph>
+    typename VersionedGraph<Graph>::Snapshot VersionedGraph<Graph>::snapshot() const {
+        return Snapshot(domain_, current_);
+    }
+
+    template<typename Graph>
+    Graph& VersionedGraph<Graph>::writer() {
+        return working_;
+    }
+
+    template<typename Graph>
+    unsigned long long VersionedGraph<Graph>::publish() {
+        DGRAPH_TRACE_SCOPE("publish");
+        const Version* previous = current_.load();
+        unsigned long long number = previous->number + 1;
+        current_.store(new Version(working_, number));
+        //snapshots taken from now on cannot reach the previous version anymore
+        domain_.retire(previous);
+        domain_.reclaim();
+        return number;
+    }
+
+    template<typename Graph>
+    unsigned long long VersionedGraph<Graph>::version() const {
+        //the version is pinned while its number is read, since the writer may replace it meanwhile
+        util::EpochGuard guard(domain_);
+        return current_.load()->number;
+    }
+
+    template<typename Graph>
+    std::size_t VersionedGraph<Graph>::pending_versions() const {
+        return domain_.pending_count();
+    }
+}
+
+#endif //DIRECTEDGRAPHHANDLER_VERSIONED_GRAPH_H